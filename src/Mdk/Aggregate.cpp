@@ -18,8 +18,6 @@
 
 #include "Mdk/Aggregate.h"
 
-#include <cstring>
-
 using namespace ::Smp::Mdk;
 
 Aggregate::Aggregate(void)
@@ -40,26 +38,19 @@ const ::Smp::ReferenceCollection* Aggregate::GetReferences(void) const
 ::Smp::IReference* Aggregate::GetReference(
         ::Smp::String8 name) const
 {
-    if (name == NULL) {
-        return NULL;
-    }
-
-    ReferenceCollection::const_iterator it(this->m_references.begin());
-    ReferenceCollection::const_iterator endIt(this->m_references.end());
-
-    ::Smp::IReference* ref = NULL;
-
-    // We only allow non-NULL references.  Thus, we do not need
-    // to check references in the container.
+    return this->m_referencesIndex.Find(name);
+}
 
-    while ((ref == NULL) && (it != endIt)) {
-        if (::strcmp(name, (*it)->GetName()) == 0) {
-            ref = *it;
-        }
-        ++it;
-    }
+const ::Smp::Mdk::NameIndex< ::Smp::IReference>& Aggregate::GetIndex(void) const
+{
+    return this->m_referencesIndex;
+}
 
-    return ref;
+bool Aggregate::Rekey(
+        ::Smp::IReference* reference,
+        ::Smp::String8 oldName)
+{
+    return this->m_referencesIndex.Rekey(reference, oldName);
 }
 
 void Aggregate::AddReference(
@@ -69,8 +60,7 @@ void Aggregate::AddReference(
         return;
     }
 
-    ::Smp::IReference* dup = GetReference(ref->GetName());
-    if (dup != NULL) {
+    if (!this->m_referencesIndex.Insert(ref)) {
         return;
     }
 
@@ -80,5 +70,6 @@ void Aggregate::AddReference(
 void Aggregate::Clear(void)
 {
     this->m_references.clear();
+    this->m_referencesIndex.Clear();
 }
 
@@ -21,13 +21,15 @@
 
 #include "Smp/IAggregate.h"
 #include "Smp/IReference.h"
+#include "Mdk/NameIndex.h"
 
 namespace Smp
 {
     namespace Mdk
     {
         class Aggregate :
-            public virtual ::Smp::IAggregate
+            public virtual ::Smp::IAggregate,
+            public ::Smp::Mdk::Indexed< ::Smp::IReference>
         {
             public:
                 Aggregate(void);
@@ -38,6 +40,12 @@ namespace Smp
                 ::Smp::IReference* GetReference(
                         ::Smp::String8 name) const;
 
+                virtual const ::Smp::Mdk::NameIndex< ::Smp::IReference>& GetIndex(void) const;
+
+                virtual bool Rekey(
+                        ::Smp::IReference* reference,
+                        ::Smp::String8 oldName);
+
             protected:
                 void AddReference(
                         ::Smp::IReference* ref);
@@ -46,6 +54,7 @@ namespace Smp
 
             private:
                 ::Smp::ReferenceCollection m_references;
+                ::Smp::Mdk::NameIndex< ::Smp::IReference> m_referencesIndex;
         };
     }
 }
@@ -0,0 +1,111 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Arena.h"
+
+#include <stdlib.h>
+#include <new>
+
+using namespace ::Smp::Mdk;
+
+// Alignment suitable for any fundamental type.
+const size_t ARENA_ALIGNMENT = 16;
+
+Arena::Arena(
+        size_t blockSize) :
+    m_blockSize(blockSize),
+    m_current(0),
+    m_offset(0),
+    m_used(0)
+{
+}
+
+Arena::~Arena(void)
+{
+    Release();
+}
+
+void* Arena::Allocate(
+        size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    // Move on to the next block that fits the request, allocating a new
+    // one if there is none.
+    while ((this->m_current < this->m_blocks.size()) &&
+            ((this->m_offset + size) > this->m_blocks[this->m_current].size)) {
+        ++this->m_current;
+        this->m_offset = 0;
+    }
+
+    if (this->m_current == this->m_blocks.size()) {
+        Block block;
+        block.size = (size > this->m_blockSize) ? size : this->m_blockSize;
+        block.data = static_cast< char*>(::malloc(block.size));
+
+        if (block.data == NULL) {
+            throw ::std::bad_alloc();
+        }
+
+        this->m_blocks.push_back(block);
+        this->m_offset = 0;
+    }
+
+    void* ptr = this->m_blocks[this->m_current].data + this->m_offset;
+    this->m_offset += size;
+    this->m_used += size;
+
+    return ptr;
+}
+
+void Arena::Reset(void)
+{
+    this->m_current = 0;
+    this->m_offset = 0;
+    this->m_used = 0;
+}
+
+void Arena::Release(void)
+{
+    for (BlockCollection::iterator it(this->m_blocks.begin());
+            it != this->m_blocks.end();
+            ++it) {
+        ::free(it->data);
+    }
+
+    this->m_blocks.clear();
+    Reset();
+}
+
+size_t Arena::GetUsedSize(void) const
+{
+    return this->m_used;
+}
+
+size_t Arena::GetReservedSize(void) const
+{
+    size_t reserved = 0;
+
+    for (BlockCollection::const_iterator it(this->m_blocks.begin());
+            it != this->m_blocks.end();
+            ++it) {
+        reserved += it->size;
+    }
+
+    return reserved;
+}
@@ -0,0 +1,99 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_ARENA_H_
+#define MDK_ARENA_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// Region allocator for objects that are destroyed together.
+        /// Memory is handed out from large blocks by bumping an offset, and
+        /// is only given back as a whole by Reset() or Release().  The
+        /// arena never runs destructors: objects created in it with
+        /// placement new must be destroyed explicitly, as done by a
+        /// Container that owns arena allocated children.
+        class Arena
+        {
+            public:
+                static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+                explicit Arena(
+                        size_t blockSize = DEFAULT_BLOCK_SIZE);
+                ~Arena(void);
+
+                /// Allocate size bytes, aligned for any fundamental type.
+                void* Allocate(
+                        size_t size);
+
+                /// Make all the memory available again, keeping the blocks
+                /// for reuse.
+                void Reset(void);
+
+                /// Give all the blocks back to the system.
+                void Release(void);
+
+                /// Bytes handed out since the last Reset() or Release().
+                size_t GetUsedSize(void) const;
+
+                /// Bytes held in blocks.
+                size_t GetReservedSize(void) const;
+
+            private:
+                Arena(
+                        const Arena&);
+                Arena& operator= (
+                        const Arena&);
+
+                struct Block
+                {
+                    char* data;
+                    size_t size;
+                };
+
+                typedef ::std::vector< Block> BlockCollection;
+
+                BlockCollection m_blocks;
+                size_t m_blockSize;
+                size_t m_current;
+                size_t m_offset;
+                size_t m_used;
+        };
+    }
+}
+
+inline void* operator new(
+        size_t size,
+        ::Smp::Mdk::Arena& arena)
+{
+    return arena.Allocate(size);
+}
+
+inline void operator delete(
+        void*,
+        ::Smp::Mdk::Arena&)
+{
+    // Only called if a constructor throws; the memory stays in the arena
+    // until it is reset.
+}
+
+#endif  // MDK_ARENA_H_
@@ -0,0 +1,201 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_BATCHCONTAINER_H_
+#define MDK_BATCHCONTAINER_H_
+
+#include "Mdk/Container.h"
+#include "Mdk/StateTable.h"
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// Base class for models whose state lives in the StateTable of
+        /// the BatchContainer holding them, rather than in data members.
+        class BatchMember
+        {
+            public:
+                BatchMember(void) :
+                    m_stateTable(NULL),
+                    m_row(0)
+                {
+                }
+
+                virtual ~BatchMember(void)
+                {
+                }
+
+                void Bind(
+                        ::Smp::Mdk::StateTable* stateTable,
+                        ::Smp::UInt32 row)
+                {
+                    this->m_stateTable = stateTable;
+                    this->m_row = row;
+                }
+
+                ::Smp::UInt32 GetRow(void) const
+                {
+                    return this->m_row;
+                }
+
+            protected:
+                ::Smp::Float64& State(
+                        ::Smp::UInt32 column)
+                {
+                    return this->m_stateTable->At(column, this->m_row);
+                }
+
+                ::Smp::Float64 State(
+                        ::Smp::UInt32 column) const
+                {
+                    return this->m_stateTable->At(column, this->m_row);
+                }
+
+            private:
+                ::Smp::Mdk::StateTable* m_stateTable;
+                ::Smp::UInt32 m_row;
+        };
+
+        /// Container of identical models stepped all at once.
+        /// Every child, a BatchMember, is given a row of the container's
+        /// StateTable.  Step() then runs a single kernel over the whole
+        /// table, instead of one entry point per child, so that the loop
+        /// over the population can be vectorised.
+        template < typename T> class BatchContainer :
+            public ::Smp::Mdk::Container< T>
+        {
+            public:
+                typedef void (*Kernel)(::Smp::Mdk::StateTable& state);
+
+                BatchContainer(
+                        ::Smp::String8 name,
+                        ::Smp::String8 description,
+                        ::Smp::IComposite* parent,
+                        ::Smp::UInt32 columnCount)
+                    throw (::Smp::InvalidObjectName) :
+                        Container< T>(name, description, parent),
+                        m_state(columnCount)
+                {
+                }
+
+                virtual ~BatchContainer(void)
+                {
+                }
+
+                void AddChild(
+                        T* child)
+                    throw (::Smp::DuplicateName)
+                {
+                    Add(child);
+                }
+
+                /// The inherited ways of adding children are overridden so
+                /// that every child is given its row.
+                void Add(
+                        ::Smp::IComponent* comp)
+                    throw (::Smp::DuplicateName, ::Smp::InvalidObjectType)
+                {
+                    const size_t oldCount = this->GetChildren()->size();
+                    Container< T>::Add(comp);
+                    BindFrom(oldCount);
+                }
+
+                template < typename U> void Add(
+                        U* comp)
+                    throw (::Smp::DuplicateName)
+                {
+                    const size_t oldCount = this->GetChildren()->size();
+                    Container< T>::Add(comp);
+                    BindFrom(oldCount);
+                }
+
+                template < typename ForwardIterator> void AddRange(
+                        ForwardIterator first,
+                        ForwardIterator last)
+                    throw (::Smp::DuplicateName, ::Smp::InvalidObjectType)
+                {
+                    const size_t oldCount = this->GetChildren()->size();
+                    Container< T>::AddRange(first, last);
+                    BindFrom(oldCount);
+                }
+
+                void Reserve(
+                        ::Smp::Int64 count)
+                {
+                    Container< T>::Reserve(count);
+
+                    if (count > 0)
+                    {
+                        this->m_state.Reserve(static_cast< ::Smp::UInt32>(count));
+                    }
+                }
+
+                void Clear(void)
+                {
+                    Container< T>::Clear();
+                    this->m_state.Clear();
+                }
+
+                ::Smp::Mdk::StateTable& GetState(void)
+                {
+                    return this->m_state;
+                }
+
+                const ::Smp::Mdk::StateTable& GetState(void) const
+                {
+                    return this->m_state;
+                }
+
+                /// Step the whole population with T::StepBatch, a static
+                /// member function of the child type taking the table.
+                void Step(void)
+                {
+                    T::StepBatch(this->m_state);
+                }
+
+                void Step(
+                        Kernel kernel)
+                {
+                    if (kernel != NULL)
+                    {
+                        kernel(this->m_state);
+                    }
+                }
+
+            private:
+                /// Give a row to every child from index first onwards.
+                void BindFrom(
+                        size_t first)
+                {
+                    const typename Container< T>::ChildCollection& children =
+                        *this->GetChildren();
+
+                    for (size_t i = first; i < children.size(); ++i)
+                    {
+                        ::Smp::Mdk::BatchMember* member = children[i];
+                        member->Bind(&this->m_state, this->m_state.AddRow());
+                    }
+                }
+
+                ::Smp::Mdk::StateTable m_state;
+        };
+    }
+}
+
+#endif  // MDK_BATCHCONTAINER_H_
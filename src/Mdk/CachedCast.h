@@ -0,0 +1,97 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_CACHEDCAST_H_
+#define MDK_CACHEDCAST_H_
+
+#include <cstddef>
+#include <typeinfo>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// dynamic_cast from From* to To* that remembers its last result.
+        /// Within objects of a given most derived type, the offset between
+        /// a given From subobject and the To subobject it converts to is
+        /// fixed.  The cast keeps the type of the last object it converted,
+        /// the position of its From subobject within it, and that offset,
+        /// so that converting further objects of the same type only costs
+        /// a typeid comparison, instead of a walk of the virtual
+        /// inheritance graph.  The position of the From subobject tells
+        /// apart the several From subobjects of classes with more than one
+        /// non-virtual From base.  Failed casts, including ambiguous ones,
+        /// are not remembered and always go through dynamic_cast.
+        ///
+        /// The cast updates its cache without synchronisation: each
+        /// CachedCast must only be used by one thread at a time.
+        template < typename From, typename To> class CachedCast
+        {
+            public:
+                CachedCast(void) :
+                    m_type(NULL),
+                    m_position(0),
+                    m_offset(0)
+                {
+                }
+
+                To* operator()(
+                        From* object)
+                {
+                    if (object == NULL)
+                    {
+                        return NULL;
+                    }
+
+                    const ::std::type_info& type = typeid(*object);
+                    const ::std::ptrdiff_t position =
+                        reinterpret_cast< char*>(object) -
+                        static_cast< char*>(dynamic_cast< void*>(object));
+
+                    if ((this->m_type != NULL) && (*this->m_type == type) &&
+                            (this->m_position == position))
+                    {
+                        return reinterpret_cast< To*>(
+                                reinterpret_cast< char*>(object) + this->m_offset);
+                    }
+
+                    To* result = dynamic_cast< To*>(object);
+
+                    if (result != NULL)
+                    {
+                        this->m_type = &type;
+                        this->m_position = position;
+                        this->m_offset =
+                            reinterpret_cast< char*>(result) -
+                            reinterpret_cast< char*>(object);
+                    }
+
+                    return result;
+                }
+
+            private:
+                const ::std::type_info* m_type;
+                /// Offset of the From subobject in the most derived object.
+                ::std::ptrdiff_t m_position;
+                /// Offset of the To subobject from the From subobject.
+                ::std::ptrdiff_t m_offset;
+        };
+    }
+}
+
+#endif  // MDK_CACHEDCAST_H_
@@ -0,0 +1,252 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_CHUNKEDLIST_H_
+#define MDK_CHUNKEDLIST_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// Append-only list of values, kept in chunks of fixed size that
+        /// never move once allocated.  GetView() returns an immutable view
+        /// of the values appended so far, in constant time, which shares
+        /// the chunks with the list: appending further values writes past
+        /// the end of every view, so views can be read by other threads
+        /// while the list grows, provided they are handed over with
+        /// release/acquire ordering (e.g. through a SnapshotCell).  The
+        /// table of chunks is copied only when it is full, doubling its
+        /// size, so appending n values costs O(n) overall.
+        ///
+        /// Appending and clearing must be done by a single thread at a
+        /// time.  Chunks are freed when the list has been cleared or
+        /// destroyed and the last view of them goes away.
+        template < typename T> class ChunkedList
+        {
+            private:
+                struct Storage;
+
+            public:
+                static const size_t CHUNK_SHIFT = 6;
+                static const size_t CHUNK_SIZE = static_cast< size_t>(1) << CHUNK_SHIFT;
+
+                /// Values of a list at one point in time.
+                class View
+                {
+                    public:
+                        View(void) :
+                            m_storage(NULL),
+                            m_chunks(NULL),
+                            m_count(0)
+                        {
+                        }
+
+                        View(
+                                const View& other) :
+                            m_storage(other.m_storage),
+                            m_chunks(other.m_chunks),
+                            m_count(other.m_count)
+                        {
+                            Acquire(this->m_storage);
+                        }
+
+                        ~View(void)
+                        {
+                            Release(this->m_storage);
+                        }
+
+                        View& operator= (
+                                const View& other)
+                        {
+                            Acquire(other.m_storage);
+                            Release(this->m_storage);
+                            this->m_storage = other.m_storage;
+                            this->m_chunks = other.m_chunks;
+                            this->m_count = other.m_count;
+
+                            return *this;
+                        }
+
+                        size_t size(void) const
+                        {
+                            return this->m_count;
+                        }
+
+                        bool empty(void) const
+                        {
+                            return this->m_count == 0;
+                        }
+
+                        const T& operator[] (
+                                size_t i) const
+                        {
+                            return this->m_chunks[i >> CHUNK_SHIFT][i & (CHUNK_SIZE - 1)];
+                        }
+
+                    private:
+                        friend class ChunkedList;
+
+                        Storage* m_storage;
+                        T* const* m_chunks;
+                        size_t m_count;
+                };
+
+                ChunkedList(void) :
+                    m_storage(NULL),
+                    m_count(0)
+                {
+                }
+
+                ~ChunkedList(void)
+                {
+                    Release(this->m_storage);
+                }
+
+                void PushBack(
+                        const T& value)
+                {
+                    if (this->m_storage == NULL)
+                    {
+                        this->m_storage = new Storage();
+                    }
+
+                    Storage* storage = this->m_storage;
+                    const size_t chunk = this->m_count >> CHUNK_SHIFT;
+
+                    if (chunk == storage->chunks.size())
+                    {
+                        if (chunk == storage->capacity)
+                        {
+                            // Views keep reading the old table, which is
+                            // freed with the storage.
+                            const size_t capacity = (chunk > 0) ? (chunk * 2) : 4;
+                            T** table = new T*[capacity];
+
+                            for (size_t i = 0; i < chunk; ++i)
+                            {
+                                table[i] = storage->chunks[i];
+                            }
+
+                            storage->tables.push_back(table);
+                            storage->capacity = capacity;
+                        }
+
+                        T* added = new T[CHUNK_SIZE];
+                        storage->chunks.push_back(added);
+                        storage->tables.back()[chunk] = added;
+                    }
+
+                    storage->chunks[chunk][this->m_count & (CHUNK_SIZE - 1)] = value;
+                    ++this->m_count;
+                }
+
+                /// Drop all the values.  Views taken before keep them.
+                void Clear(void)
+                {
+                    Release(this->m_storage);
+                    this->m_storage = NULL;
+                    this->m_count = 0;
+                }
+
+                size_t size(void) const
+                {
+                    return this->m_count;
+                }
+
+                View GetView(void) const
+                {
+                    View view;
+
+                    if (this->m_storage != NULL)
+                    {
+                        Acquire(this->m_storage);
+                        view.m_storage = this->m_storage;
+                        view.m_chunks = this->m_storage->tables.back();
+                        view.m_count = this->m_count;
+                    }
+
+                    return view;
+                }
+
+            private:
+                ChunkedList(
+                        const ChunkedList&);
+                ChunkedList& operator= (
+                        const ChunkedList&);
+
+                /// Chunks, and every table of chunks ever handed to views.
+                struct Storage
+                {
+                    Storage(void) :
+                        refs(1),
+                        capacity(0)
+                    {
+                    }
+
+                    ~Storage(void)
+                    {
+                        for (size_t i = 0; i < this->chunks.size(); ++i)
+                        {
+                            delete[] this->chunks[i];
+                        }
+
+                        for (size_t i = 0; i < this->tables.size(); ++i)
+                        {
+                            delete[] this->tables[i];
+                        }
+                    }
+
+                    long refs;
+                    ::std::vector< T*> chunks;
+                    ::std::vector< T**> tables;
+                    /// Number of chunks the last table can hold.
+                    size_t capacity;
+                };
+
+                static void Acquire(
+                        Storage* storage)
+                {
+                    if (storage != NULL)
+                    {
+                        __atomic_add_fetch(&storage->refs, 1, __ATOMIC_RELAXED);
+                    }
+                }
+
+                static void Release(
+                        Storage* storage)
+                {
+                    if ((storage != NULL) &&
+                            (__atomic_sub_fetch(&storage->refs, 1, __ATOMIC_ACQ_REL) == 0))
+                    {
+                        delete storage;
+                    }
+                }
+
+                Storage* m_storage;
+                size_t m_count;
+        };
+
+        template < typename T> const size_t ChunkedList< T>::CHUNK_SHIFT;
+        template < typename T> const size_t ChunkedList< T>::CHUNK_SIZE;
+    }
+}
+
+#endif  // MDK_CHUNKEDLIST_H_
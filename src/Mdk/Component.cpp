@@ -18,10 +18,43 @@
 
 #include "Mdk/Component.h"
 
+#include "Smp/IComposite.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
 using namespace ::Smp::Mdk;
 
+const ::Smp::Char8 COMPONENT_PATH_SEPARATOR = '/';
+
+namespace
+{
+    typedef ::std::vector< ::Smp::Mdk::HierarchyObserver*> HierarchyObservers;
+
+    // Constructed on first use, so that observers may register during
+    // static initialisation.
+    HierarchyObservers& GetHierarchyObservers(void)
+    {
+        static HierarchyObservers observers;
+
+        return observers;
+    }
+}
+
+::Smp::UInt32 Component::s_pathEpoch = 0;
+::Smp::UInt32 Component::s_pathGeneration = 0;
+
 Component::Component(void) :
-        m_parent(NULL)
+        m_parent(NULL),
+        m_path(NULL),
+        m_pathValid(false),
+        m_pathEpoch(0),
+        m_pathGeneration(0),
+        m_pathVersion(0),
+        m_parentPathVersion(0)
 {
 }
 
@@ -31,13 +64,24 @@ Component::Component(
         ::Smp::IComposite* parent)
     throw (::Smp::InvalidObjectName) :
         Object(name, description),
-        m_parent(parent)
+        m_parent(parent),
+        m_path(NULL),
+        m_pathValid(false),
+        m_pathEpoch(0),
+        m_pathGeneration(0),
+        m_pathVersion(0),
+        m_parentPathVersion(0)
 {
 }
 
 Component::~Component(void)
 {
     this->m_parent = NULL;
+
+    if (this->m_path != NULL) {
+        free(this->m_path);
+        this->m_path = NULL;
+    }
 }
 
 ::Smp::IComposite* Component::GetParent(void) const
@@ -45,3 +89,168 @@ Component::~Component(void)
     return this->m_parent;
 }
 
+::Smp::String8 Component::GetPath(void) const
+{
+    // No path at all was invalidated since this one was last checked.
+    const ::Smp::UInt32 generation = __atomic_load_n(&Component::s_pathGeneration, __ATOMIC_RELAXED);
+
+    if ((this->m_path != NULL) && this->m_pathValid && (this->m_pathGeneration == generation)) {
+        return this->m_path;
+    }
+
+    // Bring the path of the parent up to date first, so that its version
+    // tells whether it changed since this path was built.
+    const Component* parent = dynamic_cast< const Component*>(GetParent());
+    ::Smp::UInt32 parentVersion = 0;
+
+    if (parent != NULL) {
+        parent->GetPath();
+        parentVersion = parent->m_pathVersion;
+    }
+
+    const ::Smp::UInt32 epoch = __atomic_load_n(&Component::s_pathEpoch, __ATOMIC_RELAXED);
+
+    if ((this->m_path == NULL) || !this->m_pathValid || (this->m_pathEpoch != epoch) ||
+            (this->m_parentPathVersion != parentVersion)) {
+        ::std::string path;
+        Component::BuildPath(this, path);
+
+        // Keep the string when the path did not change, so that callers
+        // holding it are not left with a dangling pointer.
+        if ((this->m_path == NULL) || (path != this->m_path)) {
+            if (this->m_path != NULL) {
+                free(this->m_path);
+            }
+            this->m_path = strdup(path.c_str());
+            ++this->m_pathVersion;
+        }
+
+        this->m_pathValid = true;
+        this->m_pathEpoch = epoch;
+        this->m_parentPathVersion = parentVersion;
+    }
+
+    this->m_pathGeneration = generation;
+
+    return this->m_path;
+}
+
+void Component::InvalidatePaths(void)
+{
+    Component::InvalidatePaths(NULL);
+}
+
+void Component::InvalidatePaths(
+        const ::Smp::IComponent* component)
+{
+    __atomic_add_fetch(&Component::s_pathGeneration, 1, __ATOMIC_RELAXED);
+
+    const Component* mdkComponent = dynamic_cast< const Component*>(component);
+
+    if (mdkComponent != NULL) {
+        // Children notice through the path version of their parent.
+        mdkComponent->m_pathValid = false;
+    } else {
+        __atomic_add_fetch(&Component::s_pathEpoch, 1, __ATOMIC_RELAXED);
+    }
+
+    Component::NotifyHierarchyChanged(component);
+}
+
+void Component::InvalidatePaths(
+        const ::Smp::IComposite* composite,
+        ::Smp::ComponentCollection::const_iterator first,
+        ::Smp::ComponentCollection::const_iterator last)
+{
+    __atomic_add_fetch(&Component::s_pathGeneration, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&Component::s_pathEpoch, 1, __ATOMIC_RELAXED);
+
+    HierarchyObservers& observers = GetHierarchyObservers();
+
+    for (HierarchyObservers::const_iterator it(observers.begin());
+            it != observers.end();
+            ++it) {
+        (*it)->OnComponentsChanged(composite, first, last);
+    }
+}
+
+void Component::NotifyHierarchyChanged(
+        const ::Smp::IComponent* component)
+{
+    HierarchyObservers& observers = GetHierarchyObservers();
+
+    for (HierarchyObservers::const_iterator it(observers.begin());
+            it != observers.end();
+            ++it) {
+        (*it)->OnHierarchyChanged(component);
+    }
+}
+
+void Component::AddHierarchyObserver(
+        ::Smp::Mdk::HierarchyObserver* observer)
+{
+    if (observer == NULL) {
+        return;
+    }
+
+    HierarchyObservers& observers = GetHierarchyObservers();
+
+    if (::std::find(observers.begin(), observers.end(), observer) == observers.end()) {
+        observers.push_back(observer);
+    }
+}
+
+void Component::RemoveHierarchyObserver(
+        ::Smp::Mdk::HierarchyObserver* observer)
+{
+    HierarchyObservers& observers = GetHierarchyObservers();
+
+    observers.erase(::std::remove(observers.begin(), observers.end(), observer),
+            observers.end());
+}
+
+::Smp::UInt32 Component::GetPathGeneration(void)
+{
+    return __atomic_load_n(&Component::s_pathGeneration, __ATOMIC_RELAXED);
+}
+
+void Component::BuildPath(
+        const ::Smp::IComponent* component,
+        ::std::string& path)
+{
+    ::Smp::IComposite* parent = component->GetParent();
+
+    if (parent != NULL) {
+        const Component* mdkParent = dynamic_cast< const Component*>(parent);
+
+        if (mdkParent != NULL) {
+            path.append(mdkParent->GetPath());
+        } else {
+            Component::BuildPath(parent, path);
+        }
+        path.push_back(COMPONENT_PATH_SEPARATOR);
+
+        const ::Smp::ContainerCollection* containers = parent->GetContainers();
+
+        if (containers != NULL) {
+            ::Smp::ContainerCollection::const_iterator it(containers->begin());
+            ::Smp::ContainerCollection::const_iterator endIt(containers->end());
+            ::Smp::Bool found = false;
+
+            while (!found && (it != endIt)) {
+                found = ((*it)->GetComponent(component->GetName()) == component);
+
+                if (found) {
+                    path.append((*it)->GetName());
+                    path.push_back(COMPONENT_PATH_SEPARATOR);
+                }
+
+                ++it;
+            }
+        }
+    }
+
+    if (component->GetName() != NULL) {
+        path.append(component->GetName());
+    }
+}
@@ -21,6 +21,9 @@
 
 #include "Smp/IComponent.h"
 #include "Mdk/Object.h"
+#include "Mdk/HierarchyObserver.h"
+
+#include <string>
 
 namespace Smp
 {
@@ -41,8 +44,84 @@ namespace Smp
 
                 virtual ::Smp::IComposite* GetParent(void) const;
 
+                /// Full path of the component: the path of its parent
+                /// composite, the name of the container holding it, and
+                /// its own name, separated by '/'.  The path is computed
+                /// once and cached until the component or one of its
+                /// ancestors is invalidated; until any path is, it is
+                /// returned without walking up the ancestors.  The string
+                /// returned stays valid until the path actually changes or
+                /// the component is destroyed; rebuilding an unchanged
+                /// path keeps it.
+                ::Smp::String8 GetPath(void) const;
+
+                /// Invalidate the cached paths of all components.
+                static void InvalidatePaths(void);
+
+                /// Invalidate the cached paths of the subtree of the given
+                /// component, and tell hierarchy observers that paths going
+                /// through it may have changed.  Called whenever the name
+                /// or the parent of the component changes.  Paths of other
+                /// components are not affected, unless component is NULL
+                /// or not a Component, in which case all paths are
+                /// invalidated.
+                static void InvalidatePaths(
+                        const ::Smp::IComponent* component);
+
+                /// Invalidate the cached paths of all components at once,
+                /// and tell hierarchy observers, once, that the components
+                /// in [first, last) were added to or are about to be
+                /// removed from a container of composite.  Used instead of
+                /// InvalidatePaths() on each child, which would notify
+                /// observers for every one of them.
+                static void InvalidatePaths(
+                        const ::Smp::IComposite* composite,
+                        ::Smp::ComponentCollection::const_iterator first,
+                        ::Smp::ComponentCollection::const_iterator last);
+
+                /// Tell hierarchy observers that paths going through the
+                /// given component may lead elsewhere, without changing
+                /// the paths of components.  Used when references change.
+                static void NotifyHierarchyChanged(
+                        const ::Smp::IComponent* component);
+
+                static void AddHierarchyObserver(
+                        ::Smp::Mdk::HierarchyObserver* observer);
+
+                static void RemoveHierarchyObserver(
+                        ::Smp::Mdk::HierarchyObserver* observer);
+
+                /// Current generation of paths.  It changes every time
+                /// paths are invalidated, so that caches built on top of
+                /// paths can tell whether they are still valid.
+                static ::Smp::UInt32 GetPathGeneration(void);
+
             protected:
                 ::Smp::IComposite* m_parent;
+
+            private:
+                static void BuildPath(
+                        const ::Smp::IComponent* component,
+                        ::std::string& path);
+
+                mutable ::Smp::Char8* m_path;
+                /// Whether m_path was not invalidated since it was built.
+                mutable ::Smp::Bool m_pathValid;
+                /// Value of s_pathEpoch when m_path was built.
+                mutable ::Smp::UInt32 m_pathEpoch;
+                /// Value of s_pathGeneration when m_path was last checked:
+                /// while it is current, the ancestors need not be walked.
+                mutable ::Smp::UInt32 m_pathGeneration;
+                /// Changes every time m_path changes, so that children can
+                /// tell whether their own paths are still valid.
+                mutable ::Smp::UInt32 m_pathVersion;
+                /// Path version of the parent when m_path was built.
+                mutable ::Smp::UInt32 m_parentPathVersion;
+
+                /// Changes when all paths are invalidated at once.
+                static ::Smp::UInt32 s_pathEpoch;
+                /// Changes every time any path is invalidated.
+                static ::Smp::UInt32 s_pathGeneration;
         };
     }
 }
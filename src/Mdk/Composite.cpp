@@ -18,7 +18,6 @@
 
 #include "Mdk/Composite.h"
 
-#include <string.h>
 #include <algorithm>
 
 using namespace ::Smp::Mdk;
@@ -42,26 +41,19 @@ const ::Smp::ContainerCollection* Composite::GetContainers(void) const
 ::Smp::IContainer* Composite::GetContainer(
         ::Smp::String8 name) const
 {
-    if (name == NULL) {
-        return NULL;
-    }
-
-    ::Smp::ContainerCollection::const_iterator it(
-            this->m_containers.begin());
-    ::Smp::ContainerCollection::const_iterator endIt(
-            this->m_containers.end());
-    ::Smp::IContainer* container = NULL;
-
-    // We do not allow NULL containers.
+    return this->m_containersIndex.Find(name);
+}
 
-    while ((container == NULL) && (it != endIt)) {
-        if (strcmp(name, (*it)->GetName()) == 0) {
-            container = *it;
-        }
-        ++it;
-    }
+const ::Smp::Mdk::NameIndex< ::Smp::IContainer>& Composite::GetIndex(void) const
+{
+    return this->m_containersIndex;
+}
 
-    return container;
+bool Composite::Rekey(
+        ::Smp::IContainer* container,
+        ::Smp::String8 oldName)
+{
+    return this->m_containersIndex.Rekey(container, oldName);
 }
 
 void Composite::AddContainer(
@@ -71,8 +63,7 @@ void Composite::AddContainer(
         return;
     }
 
-    ::Smp::IContainer* dup = GetContainer(container->GetName());
-    if (dup != NULL) {
+    if (!this->m_containersIndex.Insert(container)) {
         return;
     }
 
@@ -82,5 +73,6 @@ void Composite::AddContainer(
 void Composite::Clear(void)
 {
     this->m_containers.clear();
+    this->m_containersIndex.Clear();
 }
 
@@ -20,13 +20,15 @@
 #define MDK_COMPOSITE_H_
 
 #include "Smp/IComposite.h"
+#include "Mdk/NameIndex.h"
 
 namespace Smp
 {
     namespace Mdk
     {
         class Composite :
-            public virtual ::Smp::IComposite
+            public virtual ::Smp::IComposite,
+            public ::Smp::Mdk::Indexed< ::Smp::IContainer>
         {
             public:
                 Composite(void);
@@ -37,6 +39,12 @@ namespace Smp
                 virtual ::Smp::IContainer* GetContainer(
                         ::Smp::String8 name) const;
 
+                virtual const ::Smp::Mdk::NameIndex< ::Smp::IContainer>& GetIndex(void) const;
+
+                virtual bool Rekey(
+                        ::Smp::IContainer* container,
+                        ::Smp::String8 oldName);
+
             protected:
                 void AddContainer(
                         ::Smp::IContainer* container);
@@ -44,6 +52,7 @@ namespace Smp
 
             private:
                 ::Smp::ContainerCollection m_containers;
+                ::Smp::Mdk::NameIndex< ::Smp::IContainer> m_containersIndex;
         };
     }
 }
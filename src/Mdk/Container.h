@@ -21,8 +21,12 @@
 
 #include "Smp/IContainer.h"
 #include "Mdk/Object.h"
+#include "Mdk/Component.h"
+#include "Mdk/NameIndex.h"
+#include "Mdk/CachedCast.h"
+#include "Mdk/Arena.h"
 
-#include <map>
+#include <iterator>
 
 namespace Smp
 {
@@ -30,15 +34,13 @@ namespace Smp
     {
         template < typename T> class Container :
             public ::Smp::Mdk::Object,
-            public virtual ::Smp::IContainer
+            public virtual ::Smp::IContainer,
+            public ::Smp::Mdk::Indexed< ::Smp::IComponent>
         {
             public:
                 typedef typename ::std::vector< T*> ChildCollection;
                 typedef typename ChildCollection::const_iterator ChildIterator;
-                typedef ::std::map< ::std::string, ::Smp::IComponent*> Map;
-                typedef typename Map::value_type ValueType;
-                typedef typename Map::iterator Iterator;
-                typedef typename Map::const_iterator ConstIterator;
+                typedef ::Smp::Mdk::NameIndex< ::Smp::IComponent> Index;
 
 
                 Container(
@@ -47,7 +49,8 @@ namespace Smp
                         ::Smp::IComposite* parent)
                     throw (::Smp::InvalidObjectName) :
                         Object(name, description),
-                        m_parent(parent)
+                        m_parent(parent),
+                        m_arena(NULL)
                 {
                 }
 
@@ -64,14 +67,7 @@ namespace Smp
                 ::Smp::IComponent* GetComponent(
                         ::Smp::String8 name) const
                 {
-                    ::Smp::IComponent* comp = NULL;
-
-                    ConstIterator it = this->m_componentsMap.find(name);
-                    if (it != this->m_componentsMap.end()) {
-                        comp = it->second;
-                    }
-
-                    return comp;
+                    return this->m_componentsIndex.Find(name);
                 }
 
                 virtual ::Smp::Int64 Count(void) const
@@ -110,23 +106,80 @@ namespace Smp
                     return dynamic_cast< T*>(GetComponent(name));
                 }
 
-                const Map &GetMap(void) const
+                virtual const Index& GetIndex(void) const
                 {
-                    return this->m_componentsMap;
+                    return this->m_componentsIndex;
+                }
+
+                virtual bool Rekey(
+                        ::Smp::IComponent* component,
+                        ::Smp::String8 oldName)
+                {
+                    return this->m_componentsIndex.Rekey(component, oldName);
+                }
+
+                /// Have the container treat its children as allocated in
+                /// the given arena (with placement new), or on the heap if
+                /// arena is NULL.  Children of an arena are only destroyed
+                /// by Clear(), their memory is released with the arena.
+                /// The ownership mode can only be changed while the
+                /// container is empty.
+                void SetArena(
+                        ::Smp::Mdk::Arena* arena)
+                {
+                    if (this->m_children.empty())
+                    {
+                        this->m_arena = arena;
+                    }
+                }
+
+                ::Smp::Mdk::Arena* GetArena(void) const
+                {
+                    return this->m_arena;
                 }
 
                 void Clear(void)
                 {
+                    // Observers are told while the children are still
+                    // alive, once for all of them.
+                    if (!this->m_components.empty())
+                    {
+                        ::Smp::Mdk::Component::InvalidatePaths(this->m_parent,
+                                this->m_components.begin(), this->m_components.end());
+                    }
+
                     for (typename ChildCollection::iterator it(this->m_children.begin());
                             it != this->m_children.end();
                             ++it)
                     {
-                        delete *it;
+                        if (this->m_arena != NULL)
+                        {
+                            (*it)->~T();
+                        }
+                        else
+                        {
+                            delete *it;
+                        }
                     }
 
                     this->m_children.clear();
                     this->m_components.clear();
-                    this->m_componentsMap.clear();
+                    this->m_componentsIndex.Clear();
+                }
+
+                /// Make room for count children, so that adding them does
+                /// not grow the collections or rehash the index.
+                void Reserve(
+                        ::Smp::Int64 count)
+                {
+                    if (count <= 0)
+                    {
+                        return;
+                    }
+
+                    this->m_children.reserve(count);
+                    this->m_components.reserve(count);
+                    this->m_componentsIndex.Reserve(count);
                 }
 
                 T *At(::Smp::UInt32 index) const
@@ -156,30 +209,127 @@ namespace Smp
                         return;
                     }
 
-                    ::Smp::IComponent* dup = GetComponent(comp->GetName());
-                    if (dup != NULL)
+                    T* child = this->m_childCast(comp);
+                    if (child == NULL)
                     {
-                        throw ::Smp::DuplicateName(comp->GetName());
+                        throw ::Smp::InvalidObjectType(comp);
                     }
 
-                    T* child = dynamic_cast< T*>(comp);
+                    Insert(comp, child);
+                }
+
+                /// Add a child whose type is known at compile time, so
+                /// that no run-time cast is needed.
+                template < typename U> void Add(
+                        U* comp)
+                    throw (::Smp::DuplicateName)
+                {
+                    T* child = comp;
+
                     if (child == NULL)
                     {
-                        throw ::Smp::InvalidObjectType(comp);
+                        return;
                     }
 
-                    this->m_children.push_back(child);
-                    this->m_components.push_back(comp);
+                    Insert(child, child);
+                }
 
-                    this->m_componentsMap.insert(ValueType(comp->GetName(), comp));
+                /// Add all the components in [first, last).
+                /// Components may be given as IComponent* or as pointers to
+                /// a type convertible to T*.  Either all of them are added
+                /// or, if one has a duplicate name or an invalid type, none.
+                template < typename ForwardIterator> void AddRange(
+                        ForwardIterator first,
+                        ForwardIterator last)
+                    throw (::Smp::DuplicateName, ::Smp::InvalidObjectType)
+                {
+                    const size_t oldCount = this->m_components.size();
+                    Reserve(oldCount + ::std::distance(first, last));
+
+                    try
+                    {
+                        for (ForwardIterator it(first); it != last; ++it)
+                        {
+                            if (*it == NULL)
+                            {
+                                continue;
+                            }
+
+                            T* child = ToChild(*it);
+                            if (child == NULL)
+                            {
+                                throw ::Smp::InvalidObjectType(*it);
+                            }
+
+                            ::Smp::IComponent* comp = child;
+                            if (!this->m_componentsIndex.Insert(comp))
+                            {
+                                throw ::Smp::DuplicateName(comp->GetName());
+                            }
+
+                            this->m_children.push_back(child);
+                            this->m_components.push_back(comp);
+                        }
+                    }
+                    catch (...)
+                    {
+                        for (size_t i = oldCount; i < this->m_components.size(); ++i)
+                        {
+                            this->m_componentsIndex.Remove(this->m_components[i]);
+                        }
+
+                        this->m_children.resize(oldCount);
+                        this->m_components.resize(oldCount);
+
+                        throw;
+                    }
+
+                    if (this->m_components.size() > oldCount)
+                    {
+                        ::Smp::Mdk::Component::InvalidatePaths(this->m_parent,
+                                this->m_components.begin() + oldCount,
+                                this->m_components.end());
+                    }
                 }
 
                 ::Smp::IComposite* m_parent;
 
             private:
+                T* ToChild(
+                        ::Smp::IComponent* comp)
+                {
+                    return this->m_childCast(comp);
+                }
+
+                template < typename U> T* ToChild(
+                        U* comp)
+                {
+                    return comp;
+                }
+
+                void Insert(
+                        ::Smp::IComponent* comp,
+                        T* child)
+                    throw (::Smp::DuplicateName)
+                {
+                    // The index rejects duplicates itself, so that the name
+                    // is hashed and probed only once.
+                    if (!this->m_componentsIndex.Insert(comp))
+                    {
+                        throw ::Smp::DuplicateName(comp->GetName());
+                    }
+
+                    this->m_children.push_back(child);
+                    this->m_components.push_back(comp);
+
+                    ::Smp::Mdk::Component::InvalidatePaths(comp);
+                }
+
                 ::Smp::ComponentCollection m_components;
                 ChildCollection m_children;
-                Map m_componentsMap;
+                Index m_componentsIndex;
+                ::Smp::Mdk::Arena* m_arena;
+                ::Smp::Mdk::CachedCast< ::Smp::IComponent, T> m_childCast;
         };
     }
 }
@@ -0,0 +1,73 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_HIERARCHYOBSERVER_H_
+#define MDK_HIERARCHYOBSERVER_H_
+
+#include "Smp/IComponent.h"
+#include "Smp/IComposite.h"
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// Receiver of notifications about changes in the component
+        /// hierarchy, such as caches of paths.  Observers are registered
+        /// with Component::AddHierarchyObserver().
+        class HierarchyObserver
+        {
+            public:
+                virtual ~HierarchyObserver(void)
+                {
+                }
+
+                /// Called when the component has been renamed, moved, or
+                /// has had its containers or references changed, so that
+                /// any path going through it may now lead elsewhere.  A
+                /// NULL component means that any path may have changed.
+                /// The component must only be compared, not used, as it
+                /// may be in the middle of its destruction.
+                virtual void OnHierarchyChanged(
+                        const ::Smp::IComponent* component) = 0;
+
+                /// Called once when the components in [first, last) have
+                /// been added to or are about to be removed from a
+                /// container of composite, which may be NULL.  The same
+                /// rules apply as for OnHierarchyChanged(), which is
+                /// called for composite and each of the components by
+                /// default.
+                virtual void OnComponentsChanged(
+                        const ::Smp::IComposite* composite,
+                        ::Smp::ComponentCollection::const_iterator first,
+                        ::Smp::ComponentCollection::const_iterator last)
+                {
+                    if (composite != NULL)
+                    {
+                        OnHierarchyChanged(composite);
+                    }
+
+                    for (; first != last; ++first)
+                    {
+                        OnHierarchyChanged(*first);
+                    }
+                }
+        };
+    }
+}
+
+#endif  // MDK_HIERARCHYOBSERVER_H_
@@ -18,8 +18,6 @@
 
 #include "Mdk/Management/EntryPointPublisher.h"
 
-#include <cstring>
-
 using namespace ::Smp::Mdk::Management;
 
 EntryPointPublisher::EntryPointPublisher(void)
@@ -39,24 +37,7 @@ const ::Smp::EntryPointCollection* EntryPointPublisher::GetEntryPoints(void) con
 const ::Smp::IEntryPoint* EntryPointPublisher::GetEntryPoint(
         ::Smp::String8 name) const
 {
-    if (name == NULL) {
-        return NULL;
-    }
-
-    ::Smp::EntryPointCollection::const_iterator it(this->m_entryPoints.begin());
-    ::Smp::EntryPointCollection::const_iterator endIt(this->m_entryPoints.end());
-
-    const ::Smp::IEntryPoint* ei = NULL;
-
-    while ((ei == NULL) && (it != endIt)) {
-        if (::strcmp(name, (*it)->GetName()) == 0) {
-            ei = *it;
-        }
-
-        ++it;
-    }
-
-    return ei;
+    return this->m_entryPointsIndex.Find(name);
 }
 
 void EntryPointPublisher::AddEntryPoint(
@@ -66,9 +47,7 @@ void EntryPointPublisher::AddEntryPoint(
         return;
     }
 
-    const ::Smp::IEntryPoint* dup = GetEntryPoint(entryPoint->GetName());
-
-    if (dup != NULL) {
+    if (!this->m_entryPointsIndex.Insert(entryPoint)) {
         return;
     }
 
@@ -78,4 +57,5 @@ void EntryPointPublisher::AddEntryPoint(
 void EntryPointPublisher::Clear(void)
 {
     this->m_entryPoints.clear();
+    this->m_entryPointsIndex.Clear();
 }
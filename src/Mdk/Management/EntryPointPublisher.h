@@ -20,6 +20,7 @@
 #define MDK_MANAGEMENT_ENTRYPOINTPUBLISHER_H_
 
 #include "Smp/Management/IEntryPointPublisher.h"
+#include "Mdk/NameIndex.h"
 
 namespace Smp
 {
@@ -47,6 +48,7 @@ namespace Smp
                     void Clear(void);
                 private:
                     ::Smp::EntryPointCollection m_entryPoints;
+                    ::Smp::Mdk::NameIndex< const ::Smp::IEntryPoint> m_entryPointsIndex;
             };
         }
     }
@@ -18,8 +18,6 @@
 
 #include "Mdk/Management/EventConsumer.h"
 
-#include <cstring>
-
 using namespace ::Smp::Mdk::Management;
 
 EventConsumer::EventConsumer(void)
@@ -39,24 +37,7 @@ const ::Smp::EventSinkCollection* EventConsumer::GetEventSinks(void) const
 ::Smp::IEventSink* EventConsumer::GetEventSink(
         ::Smp::String8 name) const
 {
-    if (name == NULL) {
-        return NULL;
-    }
-
-    ::Smp::EventSinkCollection::const_iterator it(this->mm_eventSinks.begin());
-    ::Smp::EventSinkCollection::const_iterator endIt(this->mm_eventSinks.end());
-
-    ::Smp::IEventSink* es = NULL;
-
-    while ((es == NULL) && (it != endIt)) {
-        if (::strcmp(name, (*it)->GetName()) == 0) {
-            es = *it;
-        }
-
-        ++it;
-    }
-
-    return es;
+    return this->m_eventSinksIndex.Find(name);
 }
 
 void EventConsumer::AddEventSink(
@@ -66,9 +47,7 @@ void EventConsumer::AddEventSink(
         return;
     }
 
-    ::Smp::IEventSink* dup = GetEventSink(eventSink->GetName());
-
-    if (dup != NULL) {
+    if (!this->m_eventSinksIndex.Insert(eventSink)) {
         return;
     }
 
@@ -78,4 +57,5 @@ void EventConsumer::AddEventSink(
 void EventConsumer::Clear(void)
 {
     this->mm_eventSinks.clear();
+    this->m_eventSinksIndex.Clear();
 }
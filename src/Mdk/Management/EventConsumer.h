@@ -20,6 +20,7 @@
 #define MDK_MANAGEMENT_EVENTCONSUMER_H_
 
 #include "Smp/Management/IEventConsumer.h"
+#include "Mdk/NameIndex.h"
 
 namespace Smp
 {
@@ -48,6 +49,7 @@ namespace Smp
 
                 private:
                     ::Smp::EventSinkCollection mm_eventSinks;
+                    ::Smp::Mdk::NameIndex< ::Smp::IEventSink> m_eventSinksIndex;
             };
         }
     }
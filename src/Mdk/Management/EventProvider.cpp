@@ -18,8 +18,6 @@
 
 #include "Mdk/Management/EventProvider.h"
 
-#include <cstring>
-
 using namespace ::Smp::Mdk::Management;
 
 EventProvider::EventProvider(void)
@@ -39,24 +37,7 @@ const ::Smp::EventSourceCollection* EventProvider::GetEventSources(void) const
 ::Smp::IEventSource* EventProvider::GetEventSource(
         ::Smp::String8 name) const
 {
-    if (name == NULL) {
-        return NULL;
-    }
-
-    ::Smp::EventSourceCollection::const_iterator it(this->m_eventSources.begin());
-    ::Smp::EventSourceCollection::const_iterator endIt(this->m_eventSources.end());
-
-    ::Smp::IEventSource* es = NULL;
-
-    while ((es == NULL) && (it != endIt)) {
-        if (::strcmp(name, (*it)->GetName()) == 0) {
-            es = *it;
-        }
-
-        ++it;
-    }
-
-    return es;
+    return this->m_eventSourcesIndex.Find(name);
 }
 
 void EventProvider::AddEventSource(
@@ -66,9 +47,7 @@ void EventProvider::AddEventSource(
         return;
     }
 
-    ::Smp::IEventSource* dup = GetEventSource(eventSource->GetName());
-
-    if (dup != NULL) {
+    if (!this->m_eventSourcesIndex.Insert(eventSource)) {
         return;
     }
 
@@ -78,4 +57,5 @@ void EventProvider::AddEventSource(
 void EventProvider::Clear(void)
 {
     this->m_eventSources.clear();
+    this->m_eventSourcesIndex.Clear();
 }
@@ -20,6 +20,7 @@
 #define MDK_MANAGEMENT_EVENTPROVIDER_H_
 
 #include "Smp/Management/IEventProvider.h"
+#include "Mdk/NameIndex.h"
 
 namespace Smp 
 {
@@ -48,6 +49,7 @@ namespace Smp
 
                 private:
                     ::Smp::EventSourceCollection m_eventSources;
+                    ::Smp::Mdk::NameIndex< ::Smp::IEventSource> m_eventSourcesIndex;
             };
         }
     }
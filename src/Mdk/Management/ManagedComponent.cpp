@@ -17,6 +17,8 @@
  */
 
 #include "Mdk/Management/ManagedComponent.h"
+#include "Mdk/NameIndex.h"
+#include "Smp/IComposite.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -44,14 +46,46 @@ void ManagedComponent::SetName(
         ::Smp::String8 name)
 throw (::Smp::InvalidObjectName)
 {
-    if (Object::ValidateName(name)) {
-        if (this->m_name != NULL) {
-            free(this->m_name);
+    if (!Object::ValidateName(name)) {
+        throw ::Smp::InvalidObjectName(name);
+    }
+
+    // The container holding the component indexes it by name, so the
+    // new name must be free there, and the component re-keyed.
+    ::Smp::Mdk::Indexed< ::Smp::IComponent>* holder = NULL;
+    ::Smp::IComposite* parent = GetParent();
+    const ::Smp::ContainerCollection* containers =
+        ((parent != NULL) && (this->m_name != NULL)) ? parent->GetContainers() : NULL;
+
+    if (containers != NULL) {
+        for (::Smp::ContainerCollection::const_iterator it(containers->begin());
+                it != containers->end();
+                ++it) {
+            if ((*it)->GetComponent(this->m_name) == this) {
+                ::Smp::IComponent* other = (*it)->GetComponent(name);
+
+                if ((other != NULL) && (other != this)) {
+                    throw ::Smp::InvalidObjectName(name);
+                }
+
+                holder = dynamic_cast< ::Smp::Mdk::Indexed< ::Smp::IComponent>*>(*it);
+                break;
+            }
         }
-        this->m_name = strdup(name);
-    } else {
-        throw new ::Smp::InvalidObjectName(name);
     }
+
+    ::Smp::Char8* oldName = this->m_name;
+    this->m_name = strdup(name);
+
+    if (holder != NULL) {
+        holder->Rekey(this, oldName);
+    }
+
+    if (oldName != NULL) {
+        free(oldName);
+    }
+
+    Component::InvalidatePaths(this);
 }
 
 void ManagedComponent::SetDescription(
@@ -68,5 +102,9 @@ void ManagedComponent::SetDescription(
 void ManagedComponent::SetParent(
         ::Smp::IComposite* parent)
 {
-    this->m_parent = parent;
+    if (this->m_parent != parent) {
+        this->m_parent = parent;
+
+        Component::InvalidatePaths(this);
+    }
 }
@@ -20,6 +20,9 @@
 #define MDK_MANAGEMENT_MANAGEDCONTAINER_H_
 
 #include "Mdk/Container.h"
+#include "Mdk/CachedCast.h"
+#include "Mdk/ChunkedList.h"
+#include "Mdk/Snapshot.h"
 #include "Smp/Management/IManagedContainer.h"
 #include "Smp/Management/IManagedComponent.h"
 
@@ -29,11 +32,27 @@ namespace Smp
     {
         namespace Management
         {
+            /// Container that other threads can read while components are
+            /// being added, through GetSnapshot().  The inherited accessors
+            /// (begin(), GetChildren(), GetComponents(), At(), ...) read the
+            /// live collections and are only safe on the thread that adds
+            /// and clears components.
             template < typename T> class ManagedContainer :
                 public ::Smp::Mdk::Container< T>,
                 public virtual ::Smp::Management::IManagedContainer
             {
                 public:
+                    /// Children of the container at one point in time.
+                    /// Versions share the chunks of children they have in
+                    /// common, so publishing one does not copy the others.
+                    struct Children
+                    {
+                        typename ::Smp::Mdk::ChunkedList< T*>::View children;
+                        ::Smp::Mdk::ChunkedList< ::Smp::IComponent*>::View components;
+                    };
+
+                    typedef typename ::Smp::Mdk::SnapshotCell< Children>::Snapshot Snapshot;
+
                     ManagedContainer(
                             ::Smp::String8 name, 
                             ::Smp::String8 description, 
@@ -61,11 +80,66 @@ namespace Smp
                         Container< T>::Add(component);
 
                         ::Smp::Management::IManagedComponent* mcomp =
-                            dynamic_cast< ::Smp::Management::IManagedComponent*>(component);
+                            this->m_managedCast(component);
 
                         if (mcomp != NULL) {
                             mcomp->SetParent(this->m_parent);
                         }
+
+                        PublishSnapshot();
+                    }
+
+                    /// Add all the components in [first, last) at once.
+                    /// Either all of them are added or, if the container
+                    /// would overflow or a component is rejected, none.
+                    template < typename ForwardIterator> void AddComponents(
+                            ForwardIterator first,
+                            ForwardIterator last)
+                        throw (::Smp::Management::IManagedContainer::ContainerFull, ::Smp::DuplicateName, ::Smp::InvalidObjectType)
+                    {
+                        // NULL entries are skipped, so they do not count.
+                        ::Smp::Int64 count = 0;
+
+                        for (ForwardIterator it(first); it != last; ++it) {
+                            if (*it != NULL) {
+                                ++count;
+                            }
+                        }
+
+                        if ((this->m_upper >= 0) && ((Count() + count) > this->m_upper)) {
+                            throw ::Smp::Management::IManagedContainer::ContainerFull(GetName(), Count());
+                        }
+
+                        Container< T>::AddRange(first, last);
+
+                        for (ForwardIterator it(first); it != last; ++it) {
+                            ::Smp::Management::IManagedComponent* mcomp =
+                                this->m_managedCast(*it);
+
+                            if (mcomp != NULL) {
+                                mcomp->SetParent(this->m_parent);
+                            }
+                        }
+
+                        PublishSnapshot();
+                    }
+
+                    void Clear(void)
+                    {
+                        Container< T>::Clear();
+                        this->m_sharedChildren.Clear();
+                        this->m_sharedComponents.Clear();
+
+                        PublishSnapshot();
+                    }
+
+                    /// Consistent view of the children, that other threads
+                    /// can iterate while components are being added.  It
+                    /// does not keep the children themselves alive, so it
+                    /// must not outlive a Clear().
+                    Snapshot GetSnapshot(void) const
+                    {
+                        return this->m_snapshot.Acquire();
                     }
 
                     virtual ::Smp::Int64 Count(void) const 
@@ -84,8 +158,38 @@ namespace Smp
                     }
 
                 private:
+                    /// Publish the current children as a new version.
+                    /// Only the children added since the last version are
+                    /// appended to the shared lists.
+                    void PublishSnapshot(void)
+                    {
+                        const typename ::Smp::Mdk::Container< T>::ChildCollection* children =
+                            Container< T>::GetChildren();
+                        const ::Smp::ComponentCollection* components =
+                            Container< T>::GetComponents();
+
+                        for (size_t i = this->m_sharedChildren.size(); i < children->size(); ++i) {
+                            this->m_sharedChildren.PushBack((*children)[i]);
+                        }
+
+                        for (size_t i = this->m_sharedComponents.size(); i < components->size(); ++i) {
+                            this->m_sharedComponents.PushBack((*components)[i]);
+                        }
+
+                        Children current;
+                        current.children = this->m_sharedChildren.GetView();
+                        current.components = this->m_sharedComponents.GetView();
+
+                        this->m_snapshot.Publish(current);
+                    }
+
                     ::Smp::Int64 m_lower;
                     ::Smp::Int64 m_upper;
+                    ::Smp::Mdk::CachedCast< ::Smp::IComponent,
+                        ::Smp::Management::IManagedComponent> m_managedCast;
+                    ::Smp::Mdk::ChunkedList< T*> m_sharedChildren;
+                    ::Smp::Mdk::ChunkedList< ::Smp::IComponent*> m_sharedComponents;
+                    ::Smp::Mdk::SnapshotCell< Children> m_snapshot;
             };
         }
     }
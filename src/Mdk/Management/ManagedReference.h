@@ -20,6 +20,7 @@
 #define MDK_MANAGEMENT_MANAGEDREFERENCE_H_
 
 #include "Mdk/Reference.h"
+#include "Mdk/Component.h"
 #include "Smp/Management/IManagedReference.h"
 
 namespace Smp
@@ -38,8 +39,9 @@ namespace Smp
                             ::Smp::String8 description,
                             ::Smp::IComponent* parent,
                             ::Smp::Int64 lower = 0,
-                            ::Smp::Int64 upper = -1) :
-                        ::Smp::Mdk::Reference< T>(name, description, parent),
+                            ::Smp::Int64 upper = -1,
+                            ::Smp::Bool preserveOrder = false) :
+                        ::Smp::Mdk::Reference< T>(name, description, parent, preserveOrder),
                         m_lower(lower),
                         m_upper(upper)
                     {
@@ -58,6 +60,8 @@ namespace Smp
                         }
 
                         Reference< T>::Add(component);
+
+                        ::Smp::Mdk::Component::NotifyHierarchyChanged(component);
                     }
 
                     virtual void RemoveComponent(
@@ -68,15 +72,13 @@ namespace Smp
                             return;
                         }
 
-                        T* provider = dynamic_cast< T*>(component);
-
-                        if (provider == NULL) {
-                            return;
-                        }
-
+                        // Components of a type other than T are never
+                        // referenced, so they need no separate check.
                         if (!Reference< T>::Remove(component)) {
                             throw ::Smp::Management::IManagedReference::NotReferenced(GetName(), component);
                         }
+
+                        ::Smp::Mdk::Component::NotifyHierarchyChanged(component);
                     }
 
                     virtual ::Smp::Int64 Count(void) const 
@@ -0,0 +1,472 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_NAMEINDEX_H_
+#define MDK_NAMEINDEX_H_
+
+#include "Smp/SimpleTypes.h"
+
+#include <cstring>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// Index of named items, looked up by their name.
+        /// Up to SMALL_LIMIT items are kept in a plain array that is
+        /// scanned linearly.  Beyond that, items are kept in an open
+        /// addressing hash table with linear probing.  The index does not
+        /// copy names: every slot keeps the hash of the name and the item,
+        /// and names are compared by calling GetName() on the item only
+        /// when hashes match.  Lookups therefore take a plain C string and
+        /// never allocate.
+        template < typename T> class NameIndex
+        {
+            public:
+                /// Number of items kept in a linearly scanned array before
+                /// switching to a hash table.
+                static const size_t SMALL_LIMIT = 8;
+
+                NameIndex(void) :
+                    m_count(0),
+                    m_hashed(false)
+                {
+                }
+
+                ~NameIndex(void)
+                {
+                }
+
+                static ::Smp::UInt32 Hash(
+                        ::Smp::String8 name)
+                {
+                    // 32-bit FNV-1a.
+                    ::Smp::UInt32 hash = 2166136261U;
+
+                    while (*name != '\0')
+                    {
+                        hash ^= static_cast< unsigned char>(*name);
+                        hash *= 16777619U;
+                        ++name;
+                    }
+
+                    return hash;
+                }
+
+                /// Hash of the first length characters of name.
+                static ::Smp::UInt32 Hash(
+                        const ::Smp::Char8* name,
+                        size_t length)
+                {
+                    ::Smp::UInt32 hash = 2166136261U;
+
+                    for (size_t i = 0; i < length; ++i)
+                    {
+                        hash ^= static_cast< unsigned char>(name[i]);
+                        hash *= 16777619U;
+                    }
+
+                    return hash;
+                }
+
+                T* Find(
+                        ::Smp::String8 name) const
+                {
+                    if ((name == NULL) || (this->m_count == 0))
+                    {
+                        return NULL;
+                    }
+
+                    return Find(name, ::strlen(name));
+                }
+
+                /// Find the item named by the first length characters of
+                /// name, which need not be null terminated.  This allows
+                /// looking up a segment of a path in place.
+                T* Find(
+                        const ::Smp::Char8* name,
+                        size_t length) const
+                {
+                    if ((name == NULL) || (this->m_count == 0))
+                    {
+                        return NULL;
+                    }
+
+                    const ::Smp::UInt32 hash = Hash(name, length);
+                    const size_t i = FindSlot(name, length, hash);
+
+                    return (i < this->m_slots.size()) ? this->m_slots[i].item : NULL;
+                }
+
+                /// Add an item to the index.
+                /// @return false if an item with the same name is already
+                ///         indexed, in which case the index is not modified.
+                bool Insert(
+                        T* item)
+                {
+                    if ((item == NULL) || (item->GetName() == NULL))
+                    {
+                        return false;
+                    }
+
+                    const ::Smp::String8 name = item->GetName();
+                    const size_t length = ::strlen(name);
+                    const ::Smp::UInt32 hash = Hash(name, length);
+
+                    if (FindSlot(name, length, hash) < this->m_slots.size())
+                    {
+                        return false;
+                    }
+
+                    Reserve(this->m_count + 1);
+
+                    Slot slot;
+                    slot.hash = hash;
+                    slot.item = item;
+
+                    if (this->m_hashed)
+                    {
+                        const size_t mask = this->m_slots.size() - 1;
+                        size_t i = hash & mask;
+
+                        while (this->m_slots[i].item != NULL)
+                        {
+                            i = (i + 1) & mask;
+                        }
+
+                        this->m_slots[i] = slot;
+                    }
+                    else
+                    {
+                        this->m_slots.push_back(slot);
+                    }
+
+                    ++this->m_count;
+
+                    return true;
+                }
+
+                /// Remove an item from the index.
+                bool Remove(
+                        T* item)
+                {
+                    if ((item == NULL) || (this->m_count == 0))
+                    {
+                        return false;
+                    }
+
+                    const size_t i = FindSlot(item, item->GetName());
+
+                    if (i == this->m_slots.size())
+                    {
+                        return false;
+                    }
+
+                    RemoveSlot(i);
+
+                    return true;
+                }
+
+                /// Index an item under its current name after it was
+                /// renamed from oldName, or from a name not known if
+                /// oldName is NULL, at the cost of a scan of the table.
+                /// Slots keep the hash of the name the item was inserted
+                /// with, so renamed items must be re-keyed to be found
+                /// again.
+                /// @return false if the item is not indexed, or if another
+                ///         item is indexed under its new name, in which
+                ///         case the index is not modified.
+                bool Rekey(
+                        T* item,
+                        ::Smp::String8 oldName)
+                {
+                    if ((item == NULL) || (item->GetName() == NULL) || (this->m_count == 0))
+                    {
+                        return false;
+                    }
+
+                    const ::Smp::String8 name = item->GetName();
+                    const size_t length = ::strlen(name);
+                    const size_t found = FindSlot(name, length, Hash(name, length));
+
+                    if (found < this->m_slots.size())
+                    {
+                        return this->m_slots[found].item == item;
+                    }
+
+                    const size_t i = FindSlot(item, oldName);
+
+                    if (i == this->m_slots.size())
+                    {
+                        return false;
+                    }
+
+                    RemoveSlot(i);
+
+                    return Insert(item);
+                }
+
+                /// Make room for count items without further rehashing.
+                void Reserve(
+                        size_t count)
+                {
+                    if (!this->m_hashed)
+                    {
+                        if (count <= SMALL_LIMIT)
+                        {
+                            this->m_slots.reserve(count);
+                            return;
+                        }
+                    }
+                    else if ((count * 2) <= this->m_slots.size())
+                    {
+                        return;
+                    }
+
+                    // Keep the load factor at or below 1/2.
+                    size_t capacity = MIN_CAPACITY;
+
+                    while (capacity < (count * 2))
+                    {
+                        capacity *= 2;
+                    }
+
+                    if (capacity > this->m_slots.size())
+                    {
+                        Rehash(capacity);
+                    }
+                }
+
+                void Clear(void)
+                {
+                    this->m_slots.clear();
+                    this->m_count = 0;
+                    this->m_hashed = false;
+                }
+
+                size_t Count(void) const
+                {
+                    return this->m_count;
+                }
+
+            private:
+                static const size_t MIN_CAPACITY = 16;
+
+                struct Slot
+                {
+                    ::Smp::UInt32 hash;
+                    T* item;
+                };
+
+                typedef ::std::vector< Slot> SlotCollection;
+
+                /// Slot holding an item with the given name, or the table
+                /// size if there is none.
+                size_t FindSlot(
+                        const ::Smp::Char8* name,
+                        size_t length,
+                        ::Smp::UInt32 hash) const
+                {
+                    if (this->m_hashed)
+                    {
+                        const size_t mask = this->m_slots.size() - 1;
+                        size_t i = hash & mask;
+
+                        while (this->m_slots[i].item != NULL)
+                        {
+                            if (Matches(this->m_slots[i], name, length, hash))
+                            {
+                                return i;
+                            }
+
+                            i = (i + 1) & mask;
+                        }
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < this->m_slots.size(); ++i)
+                        {
+                            if (Matches(this->m_slots[i], name, length, hash))
+                            {
+                                return i;
+                            }
+                        }
+                    }
+
+                    return this->m_slots.size();
+                }
+
+                static bool Matches(
+                        const Slot& slot,
+                        const ::Smp::Char8* name,
+                        size_t length,
+                        ::Smp::UInt32 hash)
+                {
+                    if (slot.hash != hash)
+                    {
+                        return false;
+                    }
+
+                    const ::Smp::String8 itemName = slot.item->GetName();
+
+                    return (::strncmp(name, itemName, length) == 0) &&
+                        (itemName[length] == '\0');
+                }
+
+                /// Slot holding the given item, or the table size if it is
+                /// not indexed.  The item is looked up from the hash of
+                /// name, the name it was indexed with, first; if it was
+                /// renamed since, the whole table is scanned.
+                size_t FindSlot(
+                        T* item,
+                        ::Smp::String8 name) const
+                {
+                    if (this->m_hashed && (name != NULL))
+                    {
+                        const size_t mask = this->m_slots.size() - 1;
+                        size_t i = Hash(name) & mask;
+
+                        while (this->m_slots[i].item != NULL)
+                        {
+                            if (this->m_slots[i].item == item)
+                            {
+                                return i;
+                            }
+
+                            i = (i + 1) & mask;
+                        }
+                    }
+
+                    for (size_t i = 0; i < this->m_slots.size(); ++i)
+                    {
+                        if (this->m_slots[i].item == item)
+                        {
+                            return i;
+                        }
+                    }
+
+                    return this->m_slots.size();
+                }
+
+                /// Empty slot i.  Slots following it are shifted back, so
+                /// that no tombstones are left in the table.
+                void RemoveSlot(
+                        size_t i)
+                {
+                    if (!this->m_hashed)
+                    {
+                        this->m_slots.erase(this->m_slots.begin() + i);
+                        --this->m_count;
+
+                        return;
+                    }
+
+                    const size_t mask = this->m_slots.size() - 1;
+                    size_t j = i;
+
+                    for (;;)
+                    {
+                        j = (j + 1) & mask;
+
+                        if (this->m_slots[j].item == NULL)
+                        {
+                            break;
+                        }
+
+                        // Move the slot back only if its home position is
+                        // not cyclically within (i, j].
+                        const size_t home = this->m_slots[j].hash & mask;
+                        const bool inRange = (i <= j) ?
+                            ((i < home) && (home <= j)) :
+                            ((i < home) || (home <= j));
+
+                        if (!inRange)
+                        {
+                            this->m_slots[i] = this->m_slots[j];
+                            i = j;
+                        }
+                    }
+
+                    this->m_slots[i].hash = 0;
+                    this->m_slots[i].item = NULL;
+                    --this->m_count;
+                }
+
+                void Rehash(
+                        size_t capacity)
+                {
+                    Slot empty;
+                    empty.hash = 0;
+                    empty.item = NULL;
+
+                    SlotCollection slots(capacity, empty);
+                    const size_t mask = capacity - 1;
+
+                    this->m_hashed = true;
+
+                    for (typename SlotCollection::const_iterator it(this->m_slots.begin());
+                            it != this->m_slots.end();
+                            ++it)
+                    {
+                        if (it->item != NULL)
+                        {
+                            size_t i = it->hash & mask;
+
+                            while (slots[i].item != NULL)
+                            {
+                                i = (i + 1) & mask;
+                            }
+
+                            slots[i] = *it;
+                        }
+                    }
+
+                    this->m_slots.swap(slots);
+                }
+
+                SlotCollection m_slots;
+                size_t m_count;
+                bool m_hashed;
+        };
+
+        template < typename T> const size_t NameIndex< T>::SMALL_LIMIT;
+        template < typename T> const size_t NameIndex< T>::MIN_CAPACITY;
+
+        /// Collection whose items can be looked up through its NameIndex,
+        /// whatever the actual type of the collection.
+        template < typename T> class Indexed
+        {
+            public:
+                virtual ~Indexed(void)
+                {
+                }
+
+                virtual const NameIndex< T>& GetIndex(void) const = 0;
+
+                /// Re-key an item of the collection renamed from oldName.
+                /// @return false if the item is not in the collection, or
+                ///         another item already has its new name.
+                virtual bool Rekey(
+                        T* item,
+                        ::Smp::String8 oldName) = 0;
+        };
+    }
+}
+
+#endif  // MDK_NAMEINDEX_H_
@@ -21,9 +21,77 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 const size_t NAME_MIN_LEN = 0;
 const size_t NAME_MAX_LEN = 32;
 
+// Names are checked in blocks of NAME_BLOCK_LEN characters.  The name is
+// copied into a buffer padded with a valid character, so that the last
+// block never reads past the end of the string.
+const size_t NAME_BLOCK_LEN = 16;
+const size_t NAME_BUFFER_LEN =
+    ((NAME_MAX_LEN + NAME_BLOCK_LEN - 1) / NAME_BLOCK_LEN) * NAME_BLOCK_LEN;
+const ::Smp::Char8 NAME_PADDING_CHAR = '_';
+
+namespace
+{
+    // Character classes are checked against ASCII ranges, instead of
+    // isalpha()/isalnum(), so that results do not depend on the locale.
+    inline ::Smp::Bool IsNameLetter(::Smp::Char8 c)
+    {
+        const unsigned char lower = static_cast< unsigned char>(c) | 0x20;
+        return (lower >= 'a') && (lower <= 'z');
+    }
+
+    inline ::Smp::Bool IsNameChar(::Smp::Char8 c)
+    {
+        return IsNameLetter(c) ||
+               ((c >= '0') && (c <= '9')) ||
+               (c == '_') || (c == '[') || (c == ']');
+    }
+
+#if defined(__SSE2__)
+    inline __m128i InRange(__m128i v, ::Smp::Char8 lo, ::Smp::Char8 hi)
+    {
+        return _mm_and_si128(
+                _mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+    }
+
+    // Bytes above 0x7F compare as negative, so they never fall in any of
+    // the accepted ranges.
+    inline ::Smp::Bool IsNameBlock(const ::Smp::Char8* block)
+    {
+        const __m128i v = _mm_loadu_si128(
+                reinterpret_cast< const __m128i*>(block));
+        const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+
+        __m128i valid = InRange(lower, 'a', 'z');
+        valid = _mm_or_si128(valid, InRange(v, '0', '9'));
+        valid = _mm_or_si128(valid, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        valid = _mm_or_si128(valid, _mm_cmpeq_epi8(v, _mm_set1_epi8('[')));
+        valid = _mm_or_si128(valid, _mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+
+        return _mm_movemask_epi8(valid) == 0xFFFF;
+    }
+#else
+    inline ::Smp::Bool IsNameBlock(const ::Smp::Char8* block)
+    {
+        ::Smp::Bool remainsValid = true;
+
+        for (size_t i = 0; remainsValid && (i < NAME_BLOCK_LEN); ++i)
+        {
+            remainsValid = IsNameChar(block[i]);
+        }
+
+        return remainsValid;
+    }
+#endif
+}
+
 using namespace Smp::Mdk;
 
 Object::Object(void)
@@ -94,6 +162,31 @@ Smp::String8 Object::GetDescription(void) const
     return isValid;
 }
 
+::Smp::Bool Object::ValidateNames(
+    const ::Smp::String8* names,
+    ::Smp::UInt32 count,
+    ::Smp::UInt32* firstInvalid)
+{
+    if ((names == NULL) && (count > 0))
+    {
+        return false;
+    }
+
+    ::Smp::UInt32 i = 0;
+
+    while ((i < count) && Object::ValidateName(names[i]))
+    {
+        ++i;
+    }
+
+    if (firstInvalid != NULL)
+    {
+        *firstInvalid = i;
+    }
+
+    return (i == count);
+}
+
 inline ::Smp::Bool Object::ValidateNameLength(size_t nameLen)
 {
     return (nameLen > NAME_MIN_LEN) && (nameLen <= NAME_MAX_LEN);
@@ -102,17 +195,22 @@ inline ::Smp::Bool Object::ValidateNameLength(size_t nameLen)
 inline ::Smp::Bool Object::ValidateNameChars(::Smp::String8 name,
                                              size_t nameLen)
 {
-    ::Smp::Bool remainsValid = (::isalpha(name[0]) != 0) ? true : false;
-    ::Smp::UInt32 i = 1;
+    if (!IsNameLetter(name[0]))
+    {
+        return false;
+    }
+
+    ::Smp::Char8 buffer[NAME_BUFFER_LEN];
+    ::memcpy(buffer, name, nameLen);
+    ::memset(buffer + nameLen, NAME_PADDING_CHAR, NAME_BUFFER_LEN - nameLen);
+
+    ::Smp::Bool remainsValid = true;
+    size_t i = 0;
 
     while (remainsValid && (i < nameLen))
     {
-        const ::Smp::Bool isLetterOrDigit = (::isalnum(name[i]) != 0) ? true : false;
-        const ::Smp::Bool isUnderscore = (name[i] == '_');
-        const ::Smp::Bool isBracket = (name[i] == '[') || (name[i] == ']');
-
-        remainsValid = isLetterOrDigit || isUnderscore || isBracket;
-        ++i;
+        remainsValid = IsNameBlock(buffer + i);
+        i += NAME_BLOCK_LEN;
     }
 
     return remainsValid;
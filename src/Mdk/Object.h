@@ -40,6 +40,13 @@ public:
 
     static ::Smp::Bool ValidateName(
         ::Smp::String8 name);
+    /// Validate a batch of names, stopping at the first invalid one.
+    /// @param firstInvalid If not NULL, receives the index of the first
+    ///        invalid name, or count if all of them are valid.
+    static ::Smp::Bool ValidateNames(
+        const ::Smp::String8* names,
+        ::Smp::UInt32 count,
+        ::Smp::UInt32* firstInvalid = NULL);
 
 protected:
     ::Smp::Char8 *m_name;
@@ -0,0 +1,235 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_POINTERINDEX_H_
+#define MDK_POINTERINDEX_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// Map from item addresses to positions in a collection.
+        /// Entries are kept in an open addressing hash table with linear
+        /// probing, and removed by shifting back the following entries.
+        template < typename T> class PointerIndex
+        {
+            public:
+                static const size_t NPOS = static_cast< size_t>(-1);
+
+                PointerIndex(void) :
+                    m_count(0)
+                {
+                }
+
+                ~PointerIndex(void)
+                {
+                }
+
+                /// Position of the item, or NPOS if it is not indexed.
+                size_t Find(
+                        const T* item) const
+                {
+                    if ((item == NULL) || (this->m_count == 0))
+                    {
+                        return NPOS;
+                    }
+
+                    const size_t i = FindSlot(item);
+
+                    return (this->m_slots[i].item != NULL) ?
+                        this->m_slots[i].position : NPOS;
+                }
+
+                /// Add an item, or update its position if already indexed.
+                /// @return false if the item was already indexed.
+                bool Insert(
+                        const T* item,
+                        size_t position)
+                {
+                    if (item == NULL)
+                    {
+                        return false;
+                    }
+
+                    Reserve(this->m_count + 1);
+
+                    const size_t i = FindSlot(item);
+                    const bool isNew = (this->m_slots[i].item == NULL);
+
+                    this->m_slots[i].item = item;
+                    this->m_slots[i].position = position;
+
+                    if (isNew)
+                    {
+                        ++this->m_count;
+                    }
+
+                    return isNew;
+                }
+
+                bool Remove(
+                        const T* item)
+                {
+                    if ((item == NULL) || (this->m_count == 0))
+                    {
+                        return false;
+                    }
+
+                    size_t i = FindSlot(item);
+
+                    if (this->m_slots[i].item == NULL)
+                    {
+                        return false;
+                    }
+
+                    const size_t mask = this->m_slots.size() - 1;
+                    size_t j = i;
+
+                    for (;;)
+                    {
+                        j = (j + 1) & mask;
+
+                        if (this->m_slots[j].item == NULL)
+                        {
+                            break;
+                        }
+
+                        // Move the slot back only if its home position is
+                        // not cyclically within (i, j].
+                        const size_t home = Hash(this->m_slots[j].item) & mask;
+                        const bool inRange = (i <= j) ?
+                            ((i < home) && (home <= j)) :
+                            ((i < home) || (home <= j));
+
+                        if (!inRange)
+                        {
+                            this->m_slots[i] = this->m_slots[j];
+                            i = j;
+                        }
+                    }
+
+                    this->m_slots[i].item = NULL;
+                    this->m_slots[i].position = 0;
+                    --this->m_count;
+
+                    return true;
+                }
+
+                /// Make room for count items without further rehashing.
+                void Reserve(
+                        size_t count)
+                {
+                    if ((count * 2) <= this->m_slots.size())
+                    {
+                        return;
+                    }
+
+                    // Keep the load factor at or below 1/2.
+                    size_t capacity = MIN_CAPACITY;
+
+                    while (capacity < (count * 2))
+                    {
+                        capacity *= 2;
+                    }
+
+                    Rehash(capacity);
+                }
+
+                void Clear(void)
+                {
+                    this->m_slots.clear();
+                    this->m_count = 0;
+                }
+
+                size_t Count(void) const
+                {
+                    return this->m_count;
+                }
+
+            private:
+                static const size_t MIN_CAPACITY = 16;
+
+                struct Slot
+                {
+                    const T* item;
+                    size_t position;
+                };
+
+                typedef ::std::vector< Slot> SlotCollection;
+
+                static size_t Hash(
+                        const T* item)
+                {
+                    // Fibonacci hashing; the low bits of addresses are
+                    // mostly zero because of alignment.
+                    const size_t address = reinterpret_cast< size_t>(item);
+
+                    return (address >> 4) * static_cast< size_t>(2654435761U);
+                }
+
+                /// Slot holding the item, or the empty slot where it would
+                /// be inserted.
+                size_t FindSlot(
+                        const T* item) const
+                {
+                    const size_t mask = this->m_slots.size() - 1;
+                    size_t i = Hash(item) & mask;
+
+                    while ((this->m_slots[i].item != NULL) &&
+                            (this->m_slots[i].item != item))
+                    {
+                        i = (i + 1) & mask;
+                    }
+
+                    return i;
+                }
+
+                void Rehash(
+                        size_t capacity)
+                {
+                    Slot empty;
+                    empty.item = NULL;
+                    empty.position = 0;
+
+                    SlotCollection slots(capacity, empty);
+                    slots.swap(this->m_slots);
+
+                    for (typename SlotCollection::const_iterator it(slots.begin());
+                            it != slots.end();
+                            ++it)
+                    {
+                        if (it->item != NULL)
+                        {
+                            this->m_slots[FindSlot(it->item)] = *it;
+                        }
+                    }
+                }
+
+                SlotCollection m_slots;
+                size_t m_count;
+        };
+
+        template < typename T> const size_t PointerIndex< T>::NPOS;
+        template < typename T> const size_t PointerIndex< T>::MIN_CAPACITY;
+    }
+}
+
+#endif  // MDK_POINTERINDEX_H_
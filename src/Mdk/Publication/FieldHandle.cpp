@@ -0,0 +1,48 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Publication/FieldHandle.h"
+#include "Mdk/Publication/Publication.h"
+
+#include <string.h>
+
+using namespace ::Smp::Mdk::Publication;
+
+::Smp::AnySimple FieldHandle::GetValue(void) const
+{
+    ::Smp::AnySimple value;
+
+    if (this->m_address != NULL) {
+        value.type = this->m_type;
+        memcpy(&value.value, this->m_address, Publication::GetTypeSize(this->m_type));
+    }
+
+    return value;
+}
+
+::Smp::Bool FieldHandle::SetValue(
+        const ::Smp::AnySimple& value) const
+{
+    if ((this->m_address == NULL) || (value.type != this->m_type)) {
+        return false;
+    }
+
+    memcpy(this->m_address, &value.value, Publication::GetTypeSize(this->m_type));
+
+    return true;
+}
@@ -0,0 +1,199 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_PUBLICATION_FIELDHANDLE_H_
+#define MDK_PUBLICATION_FIELDHANDLE_H_
+
+#include "Smp/SimpleTypes.h"
+
+#include <cstddef>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Publication
+        {
+            /// Field of simple type, or item of an array of simple type,
+            /// resolved once from its full name by Publication::Resolve().
+            /// The handle keeps the address and type of the field, so that
+            /// reading or writing the field is a plain load or store.
+            /// Handles stay valid as long as the field they refer to.
+            class FieldHandle
+            {
+                public:
+                    /// Handle to no field.
+                    FieldHandle(void) :
+                        m_address(NULL),
+                        m_type(::Smp::ST_None)
+                    {
+                    }
+
+                    ::Smp::Bool IsValid(void) const
+                    {
+                        return this->m_address != NULL;
+                    }
+
+                    ::Smp::SimpleTypeKind GetType(void) const
+                    {
+                        return this->m_type;
+                    }
+
+                    void* GetAddress(void) const
+                    {
+                        return this->m_address;
+                    }
+
+                    /// Typed address of the field, or NULL if T does not
+                    /// match the type of the field.  Check once, then read
+                    /// and write through the pointer.
+                    template < typename T> T* GetAddress(void) const
+                    {
+                        return Matches(this->m_type, static_cast< T*>(NULL)) ?
+                            static_cast< T*>(this->m_address) : NULL;
+                    }
+
+                    /// Read the field, which must be valid and of type T.
+                    template < typename T> T Get(void) const
+                    {
+                        return *static_cast< const T*>(this->m_address);
+                    }
+
+                    /// Write the field, which must be valid and of type T.
+                    template < typename T> void Set(
+                            T value) const
+                    {
+                        *static_cast< T*>(this->m_address) = value;
+                    }
+
+                    /// Value of the field, of type ST_None if the handle is
+                    /// not valid.
+                    ::Smp::AnySimple GetValue(void) const;
+
+                    /// Write value to the field.
+                    /// @return false if the handle is not valid, or the
+                    ///         value is not of the type of the field.
+                    ::Smp::Bool SetValue(
+                            const ::Smp::AnySimple& value) const;
+
+                private:
+                    friend class Publication;
+
+                    FieldHandle(
+                            void* address,
+                            ::Smp::SimpleTypeKind type) :
+                        m_address(address),
+                        m_type((address != NULL) ? type : ::Smp::ST_None)
+                    {
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Char8*)
+                    {
+                        return type == ::Smp::ST_Char8;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Bool*)
+                    {
+                        return type == ::Smp::ST_Bool;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Int8*)
+                    {
+                        return type == ::Smp::ST_Int8;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::UInt8*)
+                    {
+                        return type == ::Smp::ST_UInt8;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Int16*)
+                    {
+                        return type == ::Smp::ST_Int16;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::UInt16*)
+                    {
+                        return type == ::Smp::ST_UInt16;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Int32*)
+                    {
+                        return type == ::Smp::ST_Int32;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::UInt32*)
+                    {
+                        return type == ::Smp::ST_UInt32;
+                    }
+
+                    /// Durations and date times are Int64 too.
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Int64*)
+                    {
+                        return (type == ::Smp::ST_Int64) ||
+                            (type == ::Smp::ST_Duration) ||
+                            (type == ::Smp::ST_DateTime);
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::UInt64*)
+                    {
+                        return type == ::Smp::ST_UInt64;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Float32*)
+                    {
+                        return type == ::Smp::ST_Float32;
+                    }
+
+                    static ::Smp::Bool Matches(
+                            ::Smp::SimpleTypeKind type,
+                            const ::Smp::Float64*)
+                    {
+                        return type == ::Smp::ST_Float64;
+                    }
+
+                    void* m_address;
+                    ::Smp::SimpleTypeKind m_type;
+            };
+        }
+    }
+}
+
+#endif  // MDK_PUBLICATION_FIELDHANDLE_H_
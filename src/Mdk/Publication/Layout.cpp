@@ -0,0 +1,184 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Mdk/Publication/Layout.h"
+#include "Mdk/Publication/Publication.h"
+#include "Mdk/Storage/ChunkedStorage.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace ::Smp::Mdk::Publication;
+
+const ::Smp::UInt8 Layout::ENTRY_VIEW;
+const ::Smp::UInt8 Layout::ENTRY_STATE;
+const ::Smp::UInt8 Layout::ENTRY_INPUT;
+const ::Smp::UInt8 Layout::ENTRY_OUTPUT;
+const ::Smp::UInt8 Layout::ENTRY_ARRAY;
+const size_t Layout::NPOS;
+
+Layout::Layout(void) :
+    m_stateSize(0)
+{
+}
+
+Layout::~Layout(void)
+{
+}
+
+void Layout::Add(
+        const ::std::string& name,
+        ::Smp::Int64 offset,
+        ::Smp::SimpleTypeKind type,
+        ::Smp::Int64 count,
+        ::Smp::UInt8 flags)
+{
+    Entry entry;
+    entry.offset = offset;
+    entry.type = type;
+    entry.count = (count > 0) ? count : 0;
+    entry.size = Publication::GetTypeSize(type) * static_cast< size_t>(entry.count);
+    entry.flags = flags;
+    entry.name = this->m_names.size();
+
+    this->m_names.insert(this->m_names.end(), name.begin(), name.end());
+    this->m_names.push_back('\0');
+    this->m_entries.push_back(entry);
+}
+
+void Layout::Compile(void)
+{
+    this->m_runs.clear();
+    this->m_stateSize = 0;
+
+    for (EntryCollection::const_iterator it(this->m_entries.begin());
+            it != this->m_entries.end();
+            ++it) {
+        if (((it->flags & ENTRY_STATE) != 0) && (it->size != 0)) {
+            Run run;
+            run.offset = it->offset;
+            run.size = it->size;
+
+            this->m_runs.push_back(run);
+        }
+    }
+
+    if (this->m_runs.empty()) {
+        return;
+    }
+
+    ::std::sort(this->m_runs.begin(), this->m_runs.end());
+
+    RunCollection::iterator last(this->m_runs.begin());
+
+    for (RunCollection::const_iterator it(this->m_runs.begin() + 1);
+            it != this->m_runs.end();
+            ++it) {
+        const ::Smp::Int64 lastEnd = last->offset + static_cast< ::Smp::Int64>(last->size);
+
+        if (it->offset <= lastEnd) {
+            const ::Smp::Int64 end = it->offset + static_cast< ::Smp::Int64>(it->size);
+
+            if (end > lastEnd) {
+                last->size = static_cast< size_t>(end - last->offset);
+            }
+        } else {
+            this->m_stateSize += last->size;
+            *(++last) = *it;
+        }
+    }
+
+    this->m_stateSize += last->size;
+    this->m_runs.erase(last + 1, this->m_runs.end());
+}
+
+const Layout::EntryCollection& Layout::GetEntries(void) const
+{
+    return this->m_entries;
+}
+
+::Smp::String8 Layout::GetEntryName(
+        size_t entry) const
+{
+    return &this->m_names[this->m_entries[entry].name];
+}
+
+const Layout::RunCollection& Layout::GetStateRuns(void) const
+{
+    return this->m_runs;
+}
+
+size_t Layout::GetStateSize(void) const
+{
+    return this->m_stateSize;
+}
+
+void Layout::Store(
+        ::Smp::IStorageWriter* writer,
+        const void* address) const
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (writer == NULL) {
+        throw ::Smp::IPersist::CannotStore("no storage writer");
+    }
+
+    char* base = static_cast< char*>(const_cast< void*>(address));
+
+    for (RunCollection::const_iterator it(this->m_runs.begin());
+            it != this->m_runs.end();
+            ++it) {
+        ::Smp::Mdk::Storage::ChunkedStorage::Store(writer, base + it->offset, it->size);
+    }
+}
+
+void Layout::Restore(
+        ::Smp::IStorageReader* reader,
+        void* address) const
+    throw (::Smp::IPersist::CannotRestore)
+{
+    if (reader == NULL) {
+        throw ::Smp::IPersist::CannotRestore("no storage reader");
+    }
+
+    char* base = static_cast< char*>(address);
+
+    for (RunCollection::const_iterator it(this->m_runs.begin());
+            it != this->m_runs.end();
+            ++it) {
+        ::Smp::Mdk::Storage::ChunkedStorage::Restore(reader, base + it->offset, it->size);
+    }
+}
+
+size_t Layout::Compare(
+        const void* first,
+        const void* second) const
+{
+    const char* firstBase = static_cast< const char*>(first);
+    const char* secondBase = static_cast< const char*>(second);
+
+    for (size_t i = 0; i < this->m_entries.size(); ++i) {
+        const Entry& entry = this->m_entries[i];
+
+        if (memcmp(firstBase + entry.offset, secondBase + entry.offset, entry.size) != 0) {
+            return i;
+        }
+    }
+
+    return NPOS;
+}
@@ -0,0 +1,145 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MDK_PUBLICATION_LAYOUT_H_
+#define MDK_PUBLICATION_LAYOUT_H_
+
+#include "Smp/IPersist.h"
+#include "Smp/SimpleTypes.h"
+
+#include <string>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Publication
+        {
+            /// Flattened layout of a type.  Nested structures and arrays
+            /// are flattened into a single table of fields of simple type,
+            /// with their offsets from the start of the type and their
+            /// names relative to the name of the instance, such as
+            /// ".position.x" or "[1].y".  The state fields are also
+            /// gathered into (offset, size) runs, sorted and coalesced.
+            /// A layout is built once per type and shared by all the
+            /// instances of the type, so that publishing, storing,
+            /// restoring or comparing an instance iterates a dense table
+            /// instead of walking the nested types.
+            class Layout
+            {
+                public:
+                    /// Entry flags, with the same values as the field
+                    /// flags of Publication.
+                    static const ::Smp::UInt8 ENTRY_VIEW = 0x01;
+                    static const ::Smp::UInt8 ENTRY_STATE = 0x02;
+                    static const ::Smp::UInt8 ENTRY_INPUT = 0x04;
+                    static const ::Smp::UInt8 ENTRY_OUTPUT = 0x08;
+                    static const ::Smp::UInt8 ENTRY_ARRAY = 0x10;
+
+                    static const size_t NPOS = static_cast< size_t>(-1);
+
+                    /// Field of simple type, or array of count items of
+                    /// simple type.
+                    struct Entry
+                    {
+                        ::Smp::Int64 offset;
+                        ::Smp::SimpleTypeKind type;
+                        ::Smp::Int64 count;
+                        /// Size in bytes of all the items.
+                        size_t size;
+                        ::Smp::UInt8 flags;
+                        /// Offset of the relative name in the name table.
+                        size_t name;
+                    };
+
+                    /// Run of state bytes.
+                    struct Run
+                    {
+                        ::Smp::Int64 offset;
+                        size_t size;
+
+                        bool operator< (
+                                const Run& other) const
+                        {
+                            return this->offset < other.offset;
+                        }
+                    };
+
+                    typedef ::std::vector< Entry> EntryCollection;
+                    typedef ::std::vector< Run> RunCollection;
+
+                    Layout(void);
+                    ~Layout(void);
+
+                    /// Add an entry.  Entries must be added before
+                    /// Compile().
+                    void Add(
+                            const ::std::string& name,
+                            ::Smp::Int64 offset,
+                            ::Smp::SimpleTypeKind type,
+                            ::Smp::Int64 count,
+                            ::Smp::UInt8 flags);
+
+                    /// Gather the state entries into sorted and coalesced
+                    /// runs.
+                    void Compile(void);
+
+                    const EntryCollection& GetEntries(void) const;
+
+                    /// Name of the entry at the given position, relative
+                    /// to the name of the instance.
+                    ::Smp::String8 GetEntryName(
+                            size_t entry) const;
+
+                    const RunCollection& GetStateRuns(void) const;
+
+                    /// Number of state bytes of an instance.
+                    size_t GetStateSize(void) const;
+
+                    /// Store the state of the instance at address.
+                    void Store(
+                            ::Smp::IStorageWriter* writer,
+                            const void* address) const
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Restore the state of the instance at address.
+                    void Restore(
+                            ::Smp::IStorageReader* reader,
+                            void* address) const
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    /// Compare two instances entry by entry, bitwise.
+                    /// @return Position of the first entry that differs,
+                    ///         or NPOS if none does.
+                    size_t Compare(
+                            const void* first,
+                            const void* second) const;
+
+                private:
+                    EntryCollection m_entries;
+                    ::std::vector< ::Smp::Char8> m_names;
+                    RunCollection m_runs;
+                    size_t m_stateSize;
+            };
+        }
+    }
+}
+
+#endif  // MDK_PUBLICATION_LAYOUT_H_
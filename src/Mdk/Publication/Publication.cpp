@@ -0,0 +1,770 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Publication/Publication.h"
+#include "Mdk/Publication/Type.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace ::Smp::Mdk::Publication;
+
+const ::Smp::UInt8 Publication::FIELD_VIEW;
+const ::Smp::UInt8 Publication::FIELD_STATE;
+const ::Smp::UInt8 Publication::FIELD_INPUT;
+const ::Smp::UInt8 Publication::FIELD_OUTPUT;
+const ::Smp::UInt8 Publication::FIELD_ARRAY;
+const size_t Publication::NPOS;
+
+// Smallest size of the index of field names.
+const size_t PUBLICATION_MIN_INDEX = 16;
+
+/// Operation whose parameters are not published.
+class Publication::Operation :
+    public virtual ::Smp::Publication::IPublishOperation
+{
+    public:
+        virtual void PublishParameter(
+                ::Smp::String8 name,
+                ::Smp::String8 description,
+                const ::Smp::Uuid typeUuid)
+            throw (::Smp::Publication::NotRegistered)
+        {
+        }
+};
+
+Publication::Publication(
+        ::Smp::Publication::ITypeRegistry* typeRegistry) :
+    m_root(this),
+    m_typeRegistry(typeRegistry)
+{
+}
+
+Publication::Publication(
+        Publication* root,
+        const ::std::string& prefix,
+        const ::std::string& suffix) :
+    m_root(root),
+    m_prefix(prefix),
+    m_suffix(suffix),
+    m_typeRegistry(root->m_typeRegistry)
+{
+}
+
+Publication::~Publication(void)
+{
+    for (size_t i = 0; i < this->m_children.size(); ++i) {
+        delete this->m_children[i];
+    }
+
+    for (size_t i = 0; i < this->m_operations.size(); ++i) {
+        delete this->m_operations[i];
+    }
+}
+
+::Smp::Publication::ITypeRegistry* Publication::GetTypeRegistry(void) const
+{
+    return this->m_typeRegistry;
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Char8* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Char8, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Bool* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Bool, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Int8* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Int8, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Int16* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Int16, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Int32* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Int32, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Int64* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Int64, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::UInt8* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_UInt8, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::UInt16* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_UInt16, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::UInt32* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_UInt32, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::UInt64* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_UInt64, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Float32* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Float32, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::Float64* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    AddField(name, address, ::Smp::ST_Float64, 1, view, state, input, output);
+}
+
+void Publication::PublishField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        void* address,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+    throw (::Smp::Publication::NotRegistered,
+            ::Smp::Publication::InvalidFieldType)
+{
+    ::Smp::Publication::IType* type = (this->m_typeRegistry != NULL) ?
+        this->m_typeRegistry->GetType(typeUuid) : NULL;
+
+    if (type == NULL) {
+        throw ::Smp::Publication::NotRegistered(typeUuid);
+    }
+
+    const Type* registered = dynamic_cast< const Type*>(type);
+
+    if (registered != NULL) {
+        AddLayout(name, static_cast< char*>(address), registered->GetLayout(),
+                view, state, input, output);
+        return;
+    }
+
+    type->Publish(this, name, description, address, view, state, input, output);
+}
+
+void Publication::PublishArray(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Int64 count,
+        void* address,
+        const ::Smp::SimpleTypeKind type,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+    throw (::Smp::Publication::InvalidFieldType)
+{
+    if (GetTypeSize(type) == 0) {
+        throw ::Smp::Publication::InvalidFieldType(type);
+    }
+
+    AddField(name, address, type, count, view, state, input, output);
+    this->m_root->m_fields.back().flags |= FIELD_ARRAY;
+}
+
+::Smp::IPublication* Publication::PublishArray(
+        ::Smp::String8 name,
+        ::Smp::String8 description)
+{
+    Publication* array = new Publication(this->m_root,
+            this->m_prefix + ((name != NULL) ? name : "") + this->m_suffix + "[", "]");
+
+    this->m_root->m_children.push_back(array);
+
+    return array;
+}
+
+::Smp::IPublication* Publication::PublishStructure(
+        ::Smp::String8 name,
+        ::Smp::String8 description)
+{
+    Publication* structure = new Publication(this->m_root,
+            this->m_prefix + ((name != NULL) ? name : "") + this->m_suffix + ".", "");
+
+    this->m_root->m_children.push_back(structure);
+
+    return structure;
+}
+
+::Smp::Publication::IPublishOperation* Publication::PublishOperation(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid returnTypeUuid)
+    throw (::Smp::Publication::NotRegistered)
+{
+    Operation* operation = new Operation();
+
+    this->m_root->m_operations.push_back(operation);
+
+    return operation;
+}
+
+void Publication::PublishProperty(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::AccessKind accessKind)
+    throw (::Smp::Publication::NotRegistered)
+{
+}
+
+::Smp::AnySimple Publication::GetFieldValue(
+        ::Smp::String8 fullName)
+{
+    ::Smp::Int64 item = 0;
+    const Field& field = GetValueField(fullName, item);
+    const size_t size = GetTypeSize(field.type);
+
+    ::Smp::AnySimple value;
+    value.type = field.type;
+    memcpy(&value.value, static_cast< char*>(field.address) + (item * size), size);
+
+    return value;
+}
+
+void Publication::SetFieldValue(
+        ::Smp::String8 fullName,
+        ::Smp::AnySimple value)
+{
+    ::Smp::Int64 item = 0;
+    const Field& field = GetValueField(fullName, item);
+    const size_t size = GetTypeSize(field.type);
+
+    if (value.type != field.type) {
+        throw ::Smp::Management::IManagedModel::InvalidFieldValue(fullName, value);
+    }
+
+    memcpy(static_cast< char*>(field.address) + (item * size), &value.value, size);
+}
+
+void Publication::GetArrayValue(
+        ::Smp::String8 fullName,
+        const ::Smp::AnySimpleArray values,
+        const ::Smp::Int32 length)
+    throw (::Smp::Management::IManagedModel::InvalidFieldName,
+            ::Smp::Management::IManagedModel::InvalidArraySize)
+{
+    const Field& field = GetArrayField(fullName, length);
+    const size_t size = GetTypeSize(field.type);
+    const char* address = static_cast< const char*>(field.address);
+
+    ::Smp::AnySimple value;
+    value.type = field.type;
+
+    for (::Smp::Int32 i = 0; i < length; ++i) {
+        memcpy(&value.value, address + (i * size), size);
+        values[i] = value;
+    }
+}
+
+void Publication::SetArrayValue(
+        ::Smp::String8 fullName,
+        const ::Smp::AnySimpleArray values,
+        const ::Smp::Int32 length)
+    throw (::Smp::Management::IManagedModel::InvalidFieldName,
+            ::Smp::Management::IManagedModel::InvalidArraySize,
+            ::Smp::Management::IManagedModel::InvalidArrayValue)
+{
+    const Field& field = GetArrayField(fullName, length);
+    const size_t size = GetTypeSize(field.type);
+    char* address = static_cast< char*>(field.address);
+
+    // Check all the values first, so that the array is left untouched if
+    // any of them is invalid.
+    for (::Smp::Int32 i = 0; i < length; ++i) {
+        if (values[i].type != field.type) {
+            throw ::Smp::Management::IManagedModel::InvalidArrayValue(fullName, values);
+        }
+    }
+
+    for (::Smp::Int32 i = 0; i < length; ++i) {
+        memcpy(address + (i * size), &values[i].value, size);
+    }
+}
+
+::Smp::IRequest* Publication::CreateRequest(
+        ::Smp::String8 operationName)
+{
+    return NULL;
+}
+
+void Publication::DeleteRequest(
+        ::Smp::IRequest* request)
+{
+}
+
+const Publication::FieldCollection& Publication::GetFields(void) const
+{
+    return this->m_root->m_fields;
+}
+
+size_t Publication::FindField(
+        ::Smp::String8 fullName) const
+{
+    if (fullName == NULL) {
+        return NPOS;
+    }
+
+    const size_t length = strlen(fullName);
+
+    return this->m_root->FindField(fullName, length,
+            ::Smp::Mdk::NameIndex< Field>::Hash(fullName, length));
+}
+
+FieldHandle Publication::Resolve(
+        ::Smp::String8 fullName) const
+{
+    ::Smp::Int64 item = 0;
+    const Field* field = FindValueField(fullName, item);
+
+    if (field == NULL) {
+        return FieldHandle();
+    }
+
+    return FieldHandle(static_cast< char*>(field->address) +
+            (item * GetTypeSize(field->type)), field->type);
+}
+
+::Smp::String8 Publication::GetFieldName(
+        size_t field) const
+{
+    return &this->m_root->m_names[this->m_root->m_fields[field].name];
+}
+
+StatePlan& Publication::GetStatePlan(void)
+{
+    return this->m_root->m_plan;
+}
+
+void Publication::StoreState(
+        ::Smp::IStorageWriter* writer)
+    throw (::Smp::IPersist::CannotStore)
+{
+    this->m_root->m_plan.Store(writer);
+}
+
+void Publication::RestoreState(
+        ::Smp::IStorageReader* reader)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    this->m_root->m_plan.Restore(reader);
+}
+
+size_t Publication::GetTypeSize(
+        ::Smp::SimpleTypeKind type)
+{
+    switch (type) {
+        case ::Smp::ST_Char8:
+            return sizeof(::Smp::Char8);
+        case ::Smp::ST_Bool:
+            return sizeof(::Smp::Bool);
+        case ::Smp::ST_Int8:
+            return sizeof(::Smp::Int8);
+        case ::Smp::ST_UInt8:
+            return sizeof(::Smp::UInt8);
+        case ::Smp::ST_Int16:
+            return sizeof(::Smp::Int16);
+        case ::Smp::ST_UInt16:
+            return sizeof(::Smp::UInt16);
+        case ::Smp::ST_Int32:
+            return sizeof(::Smp::Int32);
+        case ::Smp::ST_UInt32:
+            return sizeof(::Smp::UInt32);
+        case ::Smp::ST_Int64:
+            return sizeof(::Smp::Int64);
+        case ::Smp::ST_UInt64:
+            return sizeof(::Smp::UInt64);
+        case ::Smp::ST_Float32:
+            return sizeof(::Smp::Float32);
+        case ::Smp::ST_Float64:
+            return sizeof(::Smp::Float64);
+        case ::Smp::ST_Duration:
+            return sizeof(::Smp::Duration);
+        case ::Smp::ST_DateTime:
+            return sizeof(::Smp::DateTime);
+        default:
+            return 0;
+    }
+}
+
+size_t Publication::FindField(
+        const ::Smp::Char8* name,
+        size_t length,
+        ::Smp::UInt32 hash) const
+{
+    if (this->m_index.empty()) {
+        return NPOS;
+    }
+
+    const size_t mask = this->m_index.size() - 1;
+
+    for (size_t i = hash & mask; this->m_index[i] != 0; i = (i + 1) & mask) {
+        const size_t position = this->m_index[i] - 1;
+        const Field& field = this->m_fields[position];
+
+        if ((field.hash == hash) &&
+                (strncmp(&this->m_names[field.name], name, length) == 0) &&
+                (this->m_names[field.name + length] == '\0')) {
+            return position;
+        }
+    }
+
+    return NPOS;
+}
+
+const Publication::Field* Publication::FindValueField(
+        ::Smp::String8 fullName,
+        ::Smp::Int64& item) const
+{
+    item = 0;
+
+    if (fullName == NULL) {
+        return NULL;
+    }
+
+    const Publication* root = this->m_root;
+    const size_t length = strlen(fullName);
+    const size_t position = root->FindField(fullName, length,
+            ::Smp::Mdk::NameIndex< Field>::Hash(fullName, length));
+
+    if (position != NPOS) {
+        const Field& field = root->m_fields[position];
+
+        return ((field.flags & FIELD_ARRAY) == 0) ? &field : NULL;
+    }
+
+    // An item of an array of simple type, named "array[item]".
+    const char* open = strrchr(fullName, '[');
+
+    if ((open == NULL) || (fullName[length - 1] != ']')) {
+        return NULL;
+    }
+
+    char* end = NULL;
+    item = strtol(open + 1, &end, 10);
+
+    if ((end != (fullName + length - 1)) || (end == (open + 1))) {
+        return NULL;
+    }
+
+    const size_t base = open - fullName;
+    const size_t array = root->FindField(fullName, base,
+            ::Smp::Mdk::NameIndex< Field>::Hash(fullName, base));
+
+    if ((array == NPOS) ||
+            ((root->m_fields[array].flags & FIELD_ARRAY) == 0) ||
+            (item < 0) || (item >= root->m_fields[array].count)) {
+        return NULL;
+    }
+
+    return &root->m_fields[array];
+}
+
+const Publication::Field& Publication::GetValueField(
+        ::Smp::String8 fullName,
+        ::Smp::Int64& item) const
+{
+    const Field* field = FindValueField(fullName, item);
+
+    if (field == NULL) {
+        throw ::Smp::Management::IManagedModel::InvalidFieldName(
+                (fullName != NULL) ? fullName : "");
+    }
+
+    return *field;
+}
+
+const Publication::Field& Publication::GetArrayField(
+        ::Smp::String8 fullName,
+        ::Smp::Int32 length) const
+{
+    const size_t position = FindField(fullName);
+
+    if ((position == NPOS) ||
+            ((this->m_root->m_fields[position].flags & FIELD_ARRAY) == 0)) {
+        throw ::Smp::Management::IManagedModel::InvalidFieldName(
+                (fullName != NULL) ? fullName : "");
+    }
+
+    const Field& field = this->m_root->m_fields[position];
+
+    if (length != field.count) {
+        throw ::Smp::Management::IManagedModel::InvalidArraySize(fullName, length, field.count);
+    }
+
+    return field;
+}
+
+void Publication::Index(
+        size_t field)
+{
+    // Keep the load factor at or below 1/2.
+    if ((this->m_fields.size() * 2) > this->m_index.size()) {
+        size_t capacity = PUBLICATION_MIN_INDEX;
+
+        while (capacity < (this->m_fields.size() * 2)) {
+            capacity *= 2;
+        }
+
+        Rehash(capacity);
+    }
+
+    const Field& added = this->m_fields[field];
+    const size_t length = strlen(&this->m_names[added.name]);
+
+    // Only the first of several fields with the same name is indexed.
+    if (FindField(&this->m_names[added.name], length, added.hash) != NPOS) {
+        return;
+    }
+
+    const size_t mask = this->m_index.size() - 1;
+    size_t i = added.hash & mask;
+
+    while (this->m_index[i] != 0) {
+        i = (i + 1) & mask;
+    }
+
+    this->m_index[i] = static_cast< ::Smp::UInt32>(field + 1);
+}
+
+void Publication::Rehash(
+        size_t capacity)
+{
+    ::std::vector< ::Smp::UInt32> index(capacity, 0);
+    const size_t mask = capacity - 1;
+
+    for (size_t slot = 0; slot < this->m_index.size(); ++slot) {
+        if (this->m_index[slot] != 0) {
+            size_t i = this->m_fields[this->m_index[slot] - 1].hash & mask;
+
+            while (index[i] != 0) {
+                i = (i + 1) & mask;
+            }
+
+            index[i] = this->m_index[slot];
+        }
+    }
+
+    this->m_index.swap(index);
+}
+
+void Publication::AddField(
+        ::Smp::String8 name,
+        void* address,
+        ::Smp::SimpleTypeKind type,
+        ::Smp::Int64 count,
+        ::Smp::Bool view,
+        ::Smp::Bool state,
+        ::Smp::Bool input,
+        ::Smp::Bool output)
+{
+    Publication* root = this->m_root;
+    ::std::vector< ::Smp::Char8>& names = root->m_names;
+
+    Field field;
+    field.address = address;
+    field.type = type;
+    field.count = (count > 0) ? count : 0;
+    field.flags = (view ? FIELD_VIEW : 0) | (state ? FIELD_STATE : 0) |
+        (input ? FIELD_INPUT : 0) | (output ? FIELD_OUTPUT : 0);
+    field.name = names.size();
+
+    names.insert(names.end(), this->m_prefix.begin(), this->m_prefix.end());
+    if (name != NULL) {
+        names.insert(names.end(), name, name + strlen(name));
+    }
+    names.insert(names.end(), this->m_suffix.begin(), this->m_suffix.end());
+
+    names.push_back('\0');
+    field.hash = ::Smp::Mdk::NameIndex< Field>::Hash(&names[field.name],
+            names.size() - field.name - 1);
+
+    root->m_fields.push_back(field);
+    root->Index(root->m_fields.size() - 1);
+
+    if (state) {
+        root->m_plan.Add(address, GetTypeSize(type) * static_cast< size_t>(field.count));
+    }
+}
+
+void Publication::AddLayout(
+        ::Smp::String8 name,
+        char* address,
+        const Layout& layout,
+        ::Smp::Bool view,
+        ::Smp::Bool state,
+        ::Smp::Bool input,
+        ::Smp::Bool output)
+{
+    Publication* root = this->m_root;
+    ::std::vector< ::Smp::Char8>& names = root->m_names;
+    const Layout::EntryCollection& entries = layout.GetEntries();
+
+    ::std::string base(this->m_prefix);
+    if (name != NULL) {
+        base += name;
+    }
+    base += this->m_suffix;
+
+    root->m_fields.reserve(root->m_fields.size() + entries.size());
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Layout::Entry& entry = entries[i];
+        const ::Smp::String8 entryName = layout.GetEntryName(i);
+
+        Field field;
+        field.address = address + entry.offset;
+        field.type = entry.type;
+        field.count = entry.count;
+        field.flags = entry.flags;
+        field.name = names.size();
+
+        if (!view) {
+            field.flags &= ~FIELD_VIEW;
+        }
+        if (!state) {
+            field.flags &= ~FIELD_STATE;
+        }
+        if (input) {
+            field.flags |= FIELD_INPUT;
+        }
+        if (output) {
+            field.flags |= FIELD_OUTPUT;
+        }
+
+        names.insert(names.end(), base.begin(), base.end());
+        names.insert(names.end(), entryName, entryName + strlen(entryName));
+        names.push_back('\0');
+        field.hash = ::Smp::Mdk::NameIndex< Field>::Hash(&names[field.name],
+                names.size() - field.name - 1);
+
+        root->m_fields.push_back(field);
+        root->Index(root->m_fields.size() - 1);
+    }
+
+    // The state runs of the layout are already coalesced, and sorted by
+    // offset in the type, which does not depend on address.
+    if (state) {
+        const Layout::RunCollection& runs = layout.GetStateRuns();
+
+        for (Layout::RunCollection::const_iterator it(runs.begin());
+                it != runs.end();
+                ++it) {
+            root->m_plan.Add(address + it->offset, it->size);
+        }
+    }
+}
@@ -0,0 +1,414 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_PUBLICATION_PUBLICATION_H_
+#define MDK_PUBLICATION_PUBLICATION_H_
+
+#include "Smp/IPublication.h"
+#include "Mdk/NameIndex.h"
+#include "Mdk/Publication/FieldHandle.h"
+#include "Mdk/Publication/Layout.h"
+#include "Mdk/Publication/StatePlan.h"
+
+#include <string>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Publication
+        {
+            /// Publication receiver of a model.  Published fields are kept
+            /// in a flat table of (address, type, flags), with the full
+            /// names of all the fields in a single character table: nested
+            /// structures and arrays published through PublishStructure()
+            /// and PublishArray() add their fields to the table of the
+            /// publication they come from, named "structure.field" and
+            /// "array[item]".  A hash index on full names makes getting or
+            /// setting a field by name a single lookup, whatever the number
+            /// of fields, with no splitting of the name.  Fields of types
+            /// registered in a TypeRegistry are added from the flattened
+            /// Layout of their type, without going through nested
+            /// publications.  Fields published
+            /// with state = true are gathered into a StatePlan, so that the
+            /// state of the model can be stored and restored without
+            /// hand-written code.
+            class Publication :
+                public virtual ::Smp::IPublication
+            {
+                public:
+                    /// Field flags.
+                    static const ::Smp::UInt8 FIELD_VIEW = Layout::ENTRY_VIEW;
+                    static const ::Smp::UInt8 FIELD_STATE = Layout::ENTRY_STATE;
+                    static const ::Smp::UInt8 FIELD_INPUT = Layout::ENTRY_INPUT;
+                    static const ::Smp::UInt8 FIELD_OUTPUT = Layout::ENTRY_OUTPUT;
+                    /// Array of simple type published with PublishArray().
+                    static const ::Smp::UInt8 FIELD_ARRAY = Layout::ENTRY_ARRAY;
+
+                    static const size_t NPOS = static_cast< size_t>(-1);
+
+                    /// Published field.  Arrays of simple type published
+                    /// with PublishArray() are a single field of count
+                    /// items.
+                    struct Field
+                    {
+                        void* address;
+                        ::Smp::SimpleTypeKind type;
+                        ::Smp::Int64 count;
+                        ::Smp::UInt8 flags;
+                        ::Smp::UInt32 hash;
+                        /// Offset of the full name in the name table.
+                        size_t name;
+                    };
+
+                    typedef ::std::vector< Field> FieldCollection;
+
+                    explicit Publication(
+                            ::Smp::Publication::ITypeRegistry* typeRegistry = NULL);
+                    virtual ~Publication(void);
+
+                    virtual ::Smp::Publication::ITypeRegistry* GetTypeRegistry(void) const;
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Char8* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Bool* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Int8* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Int16* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Int32* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Int64* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::UInt8* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::UInt16* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::UInt32* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::UInt64* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Float32* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::Float64* address,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    /// Publish a field of a registered type.  Types of a
+                    /// TypeRegistry add the entries of their layout; other
+                    /// types publish themselves through this publication.
+                    virtual void PublishField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            void* address,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false)
+                        throw (::Smp::Publication::NotRegistered,
+                                ::Smp::Publication::InvalidFieldType);
+
+                    virtual void PublishArray(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Int64 count,
+                            void* address,
+                            const ::Smp::SimpleTypeKind type,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false)
+                        throw (::Smp::Publication::InvalidFieldType);
+
+                    virtual ::Smp::IPublication* PublishArray(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description);
+
+                    virtual ::Smp::IPublication* PublishStructure(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description);
+
+                    /// Operations are not published; the operation returned
+                    /// ignores its parameters.
+                    virtual ::Smp::Publication::IPublishOperation* PublishOperation(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid returnTypeUuid)
+                        throw (::Smp::Publication::NotRegistered);
+
+                    /// Properties are not published.
+                    virtual void PublishProperty(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::AccessKind accessKind)
+                        throw (::Smp::Publication::NotRegistered);
+
+                    /// Value of a field of simple type, or of an item of an
+                    /// array of simple type, such as "array[3]".
+                    /// @throw ::Smp::Management::IManagedModel::InvalidFieldName
+                    ///        if there is no such field.
+                    virtual ::Smp::AnySimple GetFieldValue(
+                            ::Smp::String8 fullName);
+
+                    /// @throw ::Smp::Management::IManagedModel::InvalidFieldName
+                    ///        if there is no such field.
+                    /// @throw ::Smp::Management::IManagedModel::InvalidFieldValue
+                    ///        if the value is not of the type of the field.
+                    virtual void SetFieldValue(
+                            ::Smp::String8 fullName,
+                            ::Smp::AnySimple value);
+
+                    virtual void GetArrayValue(
+                            ::Smp::String8 fullName,
+                            const ::Smp::AnySimpleArray values,
+                            const ::Smp::Int32 length)
+                        throw (::Smp::Management::IManagedModel::InvalidFieldName,
+                                ::Smp::Management::IManagedModel::InvalidArraySize);
+
+                    virtual void SetArrayValue(
+                            ::Smp::String8 fullName,
+                            const ::Smp::AnySimpleArray values,
+                            const ::Smp::Int32 length)
+                        throw (::Smp::Management::IManagedModel::InvalidFieldName,
+                                ::Smp::Management::IManagedModel::InvalidArraySize,
+                                ::Smp::Management::IManagedModel::InvalidArrayValue);
+
+                    /// Dynamic invocation is not supported.
+                    /// @return NULL.
+                    virtual ::Smp::IRequest* CreateRequest(
+                            ::Smp::String8 operationName);
+
+                    virtual void DeleteRequest(
+                            ::Smp::IRequest* request);
+
+                    /// Fields published so far, in publication order.
+                    const FieldCollection& GetFields(void) const;
+
+                    /// Position of the field with the given full name in
+                    /// GetFields(), or NPOS.  When several fields were
+                    /// published with the same name, the first one is found.
+                    size_t FindField(
+                            ::Smp::String8 fullName) const;
+
+                    /// Resolve the full name of a field of simple type, or of
+                    /// an item of an array of simple type, once, for fast
+                    /// access through the handle afterwards.
+                    /// @return Handle to the field, not valid if there is
+                    ///         no such field.
+                    FieldHandle Resolve(
+                            ::Smp::String8 fullName) const;
+
+                    /// Full name of the field at the given position.  The
+                    /// name is valid until further fields are published.
+                    ::Smp::String8 GetFieldName(
+                            size_t field) const;
+
+                    /// Plan of the fields published with state = true.
+                    StatePlan& GetStatePlan(void);
+
+                    /// Store the state fields.
+                    void StoreState(
+                            ::Smp::IStorageWriter* writer)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Restore the state fields.
+                    void RestoreState(
+                            ::Smp::IStorageReader* reader)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    /// Size in bytes of a simple type, 0 for types that
+                    /// cannot be published as fields.
+                    static size_t GetTypeSize(
+                            ::Smp::SimpleTypeKind type);
+
+                private:
+                    Publication(
+                            const Publication&);
+                    Publication& operator= (
+                            const Publication&);
+
+                    class Operation;
+
+                    /// Nested publication adding to the fields of root,
+                    /// with names between prefix and suffix.
+                    Publication(
+                            Publication* root,
+                            const ::std::string& prefix,
+                            const ::std::string& suffix);
+
+                    size_t FindField(
+                            const ::Smp::Char8* name,
+                            size_t length,
+                            ::Smp::UInt32 hash) const;
+
+                    /// Field of simple type named fullName, or array of
+                    /// simple type fullName is an item of, in which case
+                    /// item is set to the position of the item.
+                    /// @return NULL if there is no such field.
+                    const Field* FindValueField(
+                            ::Smp::String8 fullName,
+                            ::Smp::Int64& item) const;
+
+                    /// @throw ::Smp::Management::IManagedModel::InvalidFieldName
+                    ///        if there is no such field.
+                    const Field& GetValueField(
+                            ::Smp::String8 fullName,
+                            ::Smp::Int64& item) const;
+
+                    /// Array of simple type named fullName.
+                    /// @throw ::Smp::Management::IManagedModel::InvalidFieldName
+                    ///        if there is no such array.
+                    /// @throw ::Smp::Management::IManagedModel::InvalidArraySize
+                    ///        if it does not have length items.
+                    const Field& GetArrayField(
+                            ::Smp::String8 fullName,
+                            ::Smp::Int32 length) const;
+
+                    void Index(
+                            size_t field);
+
+                    void Rehash(
+                            size_t capacity);
+
+                    void AddField(
+                            ::Smp::String8 name,
+                            void* address,
+                            ::Smp::SimpleTypeKind type,
+                            ::Smp::Int64 count,
+                            ::Smp::Bool view,
+                            ::Smp::Bool state,
+                            ::Smp::Bool input,
+                            ::Smp::Bool output);
+
+                    /// Add the entries of layout, for an instance at
+                    /// address named name.
+                    void AddLayout(
+                            ::Smp::String8 name,
+                            char* address,
+                            const Layout& layout,
+                            ::Smp::Bool view,
+                            ::Smp::Bool state,
+                            ::Smp::Bool input,
+                            ::Smp::Bool output);
+
+                    Publication* m_root;
+                    ::std::string m_prefix;
+                    ::std::string m_suffix;
+                    ::Smp::Publication::ITypeRegistry* m_typeRegistry;
+
+                    // Owned by the root publication only.
+                    FieldCollection m_fields;
+                    ::std::vector< ::Smp::Char8> m_names;
+                    /// Open addressing table of field positions plus one,
+                    /// zero marking empty slots.
+                    ::std::vector< ::Smp::UInt32> m_index;
+                    StatePlan m_plan;
+                    ::std::vector< Publication*> m_children;
+                    ::std::vector< Operation*> m_operations;
+            };
+        }
+    }
+}
+
+#endif  // MDK_PUBLICATION_PUBLICATION_H_
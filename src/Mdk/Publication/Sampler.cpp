@@ -0,0 +1,237 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Mdk/Publication/Sampler.h"
+#include "Mdk/Publication/Publication.h"
+
+using namespace ::Smp::Mdk::Publication;
+
+const size_t Sampler::NPOS;
+
+Sampler::Consumer::Consumer(
+        const Sampler& sampler) :
+    m_sampler(&sampler),
+    m_next(sampler.GetFirst()),
+    m_lost(0)
+{
+}
+
+::Smp::Bool Sampler::Consumer::Next(
+        Block& block)
+{
+    const ::Smp::UInt64 end = this->m_sampler->GetEnd();
+    const ::Smp::UInt64 first = this->m_sampler->GetFirst();
+
+    if (this->m_next < first) {
+        this->m_lost += first - this->m_next;
+        this->m_next = first;
+    }
+
+    if (this->m_next >= end) {
+        return false;
+    }
+
+    const size_t capacity = this->m_sampler->GetCapacity();
+    const size_t slot = static_cast< size_t>(this->m_next % capacity);
+    const ::Smp::UInt64 count = end - this->m_next;
+
+    block.first = this->m_next;
+    block.slot = slot;
+    block.count = (count < (capacity - slot)) ? static_cast< size_t>(count) : (capacity - slot);
+
+    this->m_next += block.count;
+
+    return true;
+}
+
+::Smp::Bool Sampler::Consumer::IsValid(
+        const Block& block) const
+{
+    // Rows are overwritten in order, so the block is intact as long as
+    // its first row is.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return this->m_sampler->GetFirst() <= block.first;
+}
+
+::Smp::UInt64 Sampler::Consumer::GetLost(void) const
+{
+    return this->m_lost;
+}
+
+Sampler::Sampler(
+        ::Smp::String8 name,
+        size_t capacity,
+        ::Smp::Duration period)
+    throw (::Smp::InvalidObjectName) :
+        Component(name, "Sampler of published fields", NULL),
+        m_times((capacity > 0) ? capacity : 1, 0),
+        m_first(0),
+        m_end(0),
+        m_period(period),
+        m_timeKeeper(NULL),
+        m_sample("Sample", "Sample the fields", this, &Sampler::SampleNow)
+{
+}
+
+Sampler::~Sampler(void)
+{
+}
+
+size_t Sampler::Add(
+        const FieldHandle& field)
+{
+    if (!field.IsValid()) {
+        return NPOS;
+    }
+
+    Column column;
+    column.field = field;
+    column.size = Publication::GetTypeSize(field.GetType());
+    column.offset = this->m_data.size() * sizeof(::Smp::UInt64);
+
+    const size_t bytes = column.size * this->m_times.size();
+    this->m_data.resize(this->m_data.size() +
+            ((bytes + sizeof(::Smp::UInt64) - 1) / sizeof(::Smp::UInt64)), 0);
+    this->m_columns.push_back(column);
+
+    Clear();
+
+    return this->m_columns.size() - 1;
+}
+
+size_t Sampler::Add(
+        const Publication& publication,
+        ::Smp::String8 fullName)
+{
+    return Add(publication.Resolve(fullName));
+}
+
+void Sampler::Sample(
+        ::Smp::Duration time)
+{
+    const size_t capacity = this->m_times.size();
+    const ::Smp::UInt64 end = this->m_end;
+
+    if ((end - this->m_first) >= capacity) {
+        // Mark the oldest row as overwritten before overwriting it.
+        __atomic_store_n(&this->m_first, end - capacity + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    const size_t slot = static_cast< size_t>(end % capacity);
+    char* data = reinterpret_cast< char*>(this->m_data.empty() ? NULL : &this->m_data[0]);
+
+    this->m_times[slot] = time;
+
+    for (ColumnCollection::const_iterator it(this->m_columns.begin());
+            it != this->m_columns.end();
+            ++it) {
+        const void* source = it->field.GetAddress();
+        void* target = data + it->offset + (slot * it->size);
+
+        switch (it->size) {
+            case 1:
+                *static_cast< ::Smp::UInt8*>(target) = *static_cast< const ::Smp::UInt8*>(source);
+                break;
+            case 2:
+                *static_cast< ::Smp::UInt16*>(target) = *static_cast< const ::Smp::UInt16*>(source);
+                break;
+            case 4:
+                *static_cast< ::Smp::UInt32*>(target) = *static_cast< const ::Smp::UInt32*>(source);
+                break;
+            default:
+                *static_cast< ::Smp::UInt64*>(target) = *static_cast< const ::Smp::UInt64*>(source);
+                break;
+        }
+    }
+
+    __atomic_store_n(&this->m_end, end + 1, __ATOMIC_RELEASE);
+}
+
+::Smp::Services::EventId Sampler::Schedule(
+        ::Smp::Services::IScheduler* scheduler,
+        ::Smp::Services::ITimeKeeper* timeKeeper,
+        ::Smp::Duration start)
+{
+    this->m_timeKeeper = timeKeeper;
+
+    return scheduler->AddSimulationTimeEvent(&this->m_sample, start, this->m_period, -1);
+}
+
+void Sampler::Clear(void)
+{
+    // Row numbers are never reused, so that blocks read before the clear
+    // are no longer valid and consumers skip the discarded rows.
+    __atomic_store_n(&this->m_first, this->m_end, __ATOMIC_RELEASE);
+}
+
+const ::Smp::IEntryPoint* Sampler::GetSampleEntryPoint(void) const
+{
+    return &this->m_sample;
+}
+
+size_t Sampler::GetCapacity(void) const
+{
+    return this->m_times.size();
+}
+
+size_t Sampler::GetColumnCount(void) const
+{
+    return this->m_columns.size();
+}
+
+::Smp::SimpleTypeKind Sampler::GetColumnType(
+        size_t column) const
+{
+    return this->m_columns[column].field.GetType();
+}
+
+::Smp::UInt64 Sampler::GetFirst(void) const
+{
+    return __atomic_load_n(&this->m_first, __ATOMIC_ACQUIRE);
+}
+
+::Smp::UInt64 Sampler::GetEnd(void) const
+{
+    return __atomic_load_n(&this->m_end, __ATOMIC_ACQUIRE);
+}
+
+const ::Smp::Duration* Sampler::GetTimes(
+        const Block& block) const
+{
+    return &this->m_times[block.slot];
+}
+
+const void* Sampler::GetColumn(
+        size_t column,
+        const Block& block) const
+{
+    const Column& sampled = this->m_columns[column];
+
+    return reinterpret_cast< const char*>(&this->m_data[0]) + sampled.offset +
+        (block.slot * sampled.size);
+}
+
+void Sampler::SampleNow(void)
+{
+    if (this->m_timeKeeper != NULL) {
+        Sample(this->m_timeKeeper->GetSimulationTime());
+    }
+}
@@ -0,0 +1,210 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MDK_PUBLICATION_SAMPLER_H_
+#define MDK_PUBLICATION_SAMPLER_H_
+
+#include "Smp/Services/IScheduler.h"
+#include "Smp/Services/ITimeKeeper.h"
+#include "Mdk/Component.h"
+#include "Mdk/EntryPoint.h"
+#include "Mdk/Publication/FieldHandle.h"
+
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Publication
+        {
+            class Publication;
+
+            /// Sampler of published fields into columnar ring buffers.
+            /// Fields are resolved once into FieldHandles, and every
+            /// sample appends a row: the simulation time to the time
+            /// column, and the value of every field, read through its
+            /// address, to the column of the field.  Columns hold raw
+            /// values of the type of their field, so that sampling does
+            /// no lookup and no conversion to AnySimple.  Once the ring is
+            /// full, the oldest row is overwritten.
+            ///
+            /// Rows are numbered in sampling order.  Any number of
+            /// Consumers read the rows in place, through pointers into the
+            /// columns, each at its own pace.  Sampling is meant to run in
+            /// a single thread, usually from the Sample entry point
+            /// scheduled every period; consumers may run in other threads,
+            /// in which case they check that a block was not overwritten
+            /// while they read it.
+            class Sampler :
+                public ::Smp::Mdk::Component
+            {
+                public:
+                    static const size_t NPOS = static_cast< size_t>(-1);
+
+                    /// Rows [first, first + count), contiguous in every
+                    /// column from position slot.
+                    struct Block
+                    {
+                        ::Smp::UInt64 first;
+                        size_t count;
+                        size_t slot;
+                    };
+
+                    /// Reader of the rows of a sampler, from the oldest
+                    /// row held when the consumer is created.
+                    class Consumer
+                    {
+                        public:
+                            explicit Consumer(
+                                    const Sampler& sampler);
+
+                            /// Next block of unread rows.  Rows
+                            /// overwritten or cleared before being read
+                            /// are skipped and counted as lost.
+                            /// @return false if there are no unread rows.
+                            ::Smp::Bool Next(
+                                    Block& block);
+
+                            /// Whether the rows of block are still held,
+                            /// that is, were not overwritten while they
+                            /// were being read.
+                            ::Smp::Bool IsValid(
+                                    const Block& block) const;
+
+                            /// Number of rows overwritten or cleared
+                            /// before being read.
+                            ::Smp::UInt64 GetLost(void) const;
+
+                        private:
+                            const Sampler* m_sampler;
+                            ::Smp::UInt64 m_next;
+                            ::Smp::UInt64 m_lost;
+                    };
+
+                    Sampler(
+                            ::Smp::String8 name,
+                            size_t capacity,
+                            ::Smp::Duration period)
+                        throw (::Smp::InvalidObjectName);
+                    virtual ~Sampler(void);
+
+                    /// Add a column sampling field.  Rows sampled so far
+                    /// are discarded.
+                    /// @return Position of the column, or NPOS if the
+                    ///         handle is not valid.
+                    size_t Add(
+                            const FieldHandle& field);
+
+                    /// Add a column sampling the field of publication
+                    /// with the given full name.
+                    /// @return Position of the column, or NPOS if there
+                    ///         is no such field.
+                    size_t Add(
+                            const Publication& publication,
+                            ::Smp::String8 fullName);
+
+                    /// Append a row sampled at the given simulation time.
+                    void Sample(
+                            ::Smp::Duration time);
+
+                    /// Schedule the Sample entry point every period of
+                    /// simulation time from start, with the simulation
+                    /// time read from timeKeeper.
+                    /// @return Identifier of the scheduler event.
+                    ::Smp::Services::EventId Schedule(
+                            ::Smp::Services::IScheduler* scheduler,
+                            ::Smp::Services::ITimeKeeper* timeKeeper,
+                            ::Smp::Duration start = 0);
+
+                    /// Discard all the rows.  Rows sampled afterwards are
+                    /// numbered on from the discarded ones.
+                    void Clear(void);
+
+                    /// Entry point sampling at the current simulation
+                    /// time, once scheduled.
+                    const ::Smp::IEntryPoint* GetSampleEntryPoint(void) const;
+
+                    /// Number of rows held once the ring is full.
+                    size_t GetCapacity(void) const;
+
+                    size_t GetColumnCount(void) const;
+
+                    ::Smp::SimpleTypeKind GetColumnType(
+                            size_t column) const;
+
+                    /// Number of the oldest row held.
+                    ::Smp::UInt64 GetFirst(void) const;
+
+                    /// Number of the next row to be sampled.
+                    ::Smp::UInt64 GetEnd(void) const;
+
+                    /// Times of the rows of block.
+                    const ::Smp::Duration* GetTimes(
+                            const Block& block) const;
+
+                    /// Values of the rows of block in a column.
+                    const void* GetColumn(
+                            size_t column,
+                            const Block& block) const;
+
+                    /// Typed values of the rows of block in a column, or
+                    /// NULL if T does not match the type of the column.
+                    template < typename T> const T* GetColumn(
+                            size_t column,
+                            const Block& block) const
+                    {
+                        return (this->m_columns[column].field.template GetAddress< T>() != NULL) ?
+                            static_cast< const T*>(GetColumn(column, block)) : NULL;
+                    }
+
+                private:
+                    Sampler(
+                            const Sampler&);
+                    Sampler& operator= (
+                            const Sampler&);
+
+                    struct Column
+                    {
+                        FieldHandle field;
+                        size_t size;
+                        /// Offset of the column in the data, in bytes.
+                        size_t offset;
+                    };
+
+                    typedef ::std::vector< Column> ColumnCollection;
+
+                    void SampleNow(void);
+
+                    ColumnCollection m_columns;
+                    ::std::vector< ::Smp::Duration> m_times;
+                    /// All the columns, one after the other, each
+                    /// aligned to 8 bytes.
+                    ::std::vector< ::Smp::UInt64> m_data;
+                    ::Smp::UInt64 m_first;
+                    ::Smp::UInt64 m_end;
+                    ::Smp::Duration m_period;
+                    ::Smp::Services::ITimeKeeper* m_timeKeeper;
+                    ::Smp::Mdk::EntryPoint m_sample;
+            };
+        }
+    }
+}
+
+#endif  // MDK_PUBLICATION_SAMPLER_H_
@@ -0,0 +1,141 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Publication/StatePlan.h"
+#include "Mdk/Storage/ChunkedStorage.h"
+
+using namespace ::Smp::Mdk::Publication;
+
+StatePlan::StatePlan(void) :
+    m_size(0),
+    m_compiled(true)
+{
+}
+
+StatePlan::~StatePlan(void)
+{
+}
+
+void StatePlan::Add(
+        void* address,
+        size_t size)
+{
+    if ((address == NULL) || (size == 0)) {
+        return;
+    }
+
+    Run run;
+    run.address = static_cast< char*>(address);
+    run.size = size;
+
+    this->m_runs.push_back(run);
+    this->m_compiled = false;
+}
+
+void StatePlan::Compile(void)
+{
+    if (this->m_compiled) {
+        return;
+    }
+
+    // Only runs following each other are merged, so that the stored bytes
+    // keep the order of the runs.  Whether a run continues or overlaps the
+    // previous one is a property of the published fields, such as a
+    // structure and its fields, not of where they were allocated.
+    RunCollection::iterator last(this->m_runs.begin());
+    this->m_size = 0;
+
+    for (RunCollection::const_iterator it(this->m_runs.begin());
+            it != this->m_runs.end();
+            ++it) {
+        if (it == last) {
+            continue;
+        }
+
+        if ((it->address >= last->address) &&
+                (it->address <= (last->address + last->size))) {
+            // Continuing or overlapping, e.g. a structure and its fields.
+            const char* end = it->address + it->size;
+
+            if (end > (last->address + last->size)) {
+                last->size = end - last->address;
+            }
+        } else {
+            this->m_size += last->size;
+            *(++last) = *it;
+        }
+    }
+
+    if (!this->m_runs.empty()) {
+        this->m_size += last->size;
+        this->m_runs.erase(last + 1, this->m_runs.end());
+    }
+
+    this->m_compiled = true;
+}
+
+void StatePlan::Clear(void)
+{
+    this->m_runs.clear();
+    this->m_size = 0;
+    this->m_compiled = true;
+}
+
+void StatePlan::Store(
+        ::Smp::IStorageWriter* writer)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (writer == NULL) {
+        throw ::Smp::IPersist::CannotStore("no storage writer");
+    }
+
+    Compile();
+
+    for (RunCollection::const_iterator it(this->m_runs.begin());
+            it != this->m_runs.end();
+            ++it) {
+        ::Smp::Mdk::Storage::ChunkedStorage::Store(writer, it->address, it->size);
+    }
+}
+
+void StatePlan::Restore(
+        ::Smp::IStorageReader* reader)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    if (reader == NULL) {
+        throw ::Smp::IPersist::CannotRestore("no storage reader");
+    }
+
+    Compile();
+
+    for (RunCollection::const_iterator it(this->m_runs.begin());
+            it != this->m_runs.end();
+            ++it) {
+        ::Smp::Mdk::Storage::ChunkedStorage::Restore(reader, it->address, it->size);
+    }
+}
+
+size_t StatePlan::GetRunCount(void) const
+{
+    return this->m_runs.size();
+}
+
+size_t StatePlan::GetSize(void) const
+{
+    return this->m_size;
+}
@@ -0,0 +1,95 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_PUBLICATION_STATEPLAN_H_
+#define MDK_PUBLICATION_STATEPLAN_H_
+
+#include "Smp/IPersist.h"
+
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Publication
+        {
+            /// Gather/scatter plan of the state of a model.  The plan is a
+            /// list of (address, size) runs of memory, one per state field
+            /// to begin with.  Compiling the plan coalesces each run with
+            /// the one added before it when it continues or overlaps it, so
+            /// that storing or restoring state published in address order
+            /// is a handful of block copies to or from the storage.  Gaps
+            /// between runs, such as padding or fields that are not state,
+            /// are never copied.
+            ///
+            /// Runs are stored in the order they were added, never sorted
+            /// by address: a plan built in the same order in another
+            /// process, where the fields may be allocated in a different
+            /// order, restores every field from its own bytes.
+            class StatePlan
+            {
+                public:
+                    StatePlan(void);
+                    ~StatePlan(void);
+
+                    /// Add a run of size bytes at address to the plan.
+                    void Add(
+                            void* address,
+                            size_t size);
+
+                    /// Coalesce the runs.  Called by Store() and Restore()
+                    /// when runs were added since the last time.
+                    void Compile(void);
+
+                    void Clear(void);
+
+                    /// Store the runs, in the order they were added.
+                    void Store(
+                            ::Smp::IStorageWriter* writer)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Restore the runs, in the order they were added.
+                    void Restore(
+                            ::Smp::IStorageReader* reader)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    /// Number of runs, after compilation.
+                    size_t GetRunCount(void) const;
+
+                    /// Number of bytes stored, after compilation.
+                    size_t GetSize(void) const;
+
+                private:
+                    struct Run
+                    {
+                        char* address;
+                        size_t size;
+                    };
+
+                    typedef ::std::vector< Run> RunCollection;
+
+                    RunCollection m_runs;
+                    size_t m_size;
+                    bool m_compiled;
+            };
+        }
+    }
+}
+
+#endif  // MDK_PUBLICATION_STATEPLAN_H_
@@ -0,0 +1,549 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Publication/Type.h"
+#include "Mdk/Publication/Publication.h"
+#include "Mdk/Uuid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace ::Smp::Mdk::Publication;
+
+::Smp::UInt64 Type::s_layoutVersion = 0;
+
+namespace
+{
+    ::Smp::SimpleTypeKind GetEnumerationKind(
+            ::Smp::Int16 memorySize)
+    {
+        switch (memorySize) {
+            case 1:
+                return ::Smp::ST_Int8;
+            case 2:
+                return ::Smp::ST_Int16;
+            case 8:
+                return ::Smp::ST_Int64;
+            default:
+                return ::Smp::ST_Int32;
+        }
+    }
+
+    /// Flags of a field of a structure with the given flags.
+    ::Smp::UInt8 GetFieldFlags(
+            ::Smp::UInt8 flags,
+            const StructureType::Field& field)
+    {
+        if (!field.view) {
+            flags &= ~Layout::ENTRY_VIEW;
+        }
+        if (!field.state) {
+            flags &= ~Layout::ENTRY_STATE;
+        }
+        if (field.input) {
+            flags |= Layout::ENTRY_INPUT;
+        }
+        if (field.output) {
+            flags |= Layout::ENTRY_OUTPUT;
+        }
+
+        return flags;
+    }
+
+    const Type& GetRegisteredType(
+            const ::Smp::Publication::ITypeRegistry* registry,
+            const ::Smp::Uuid& uuid)
+    {
+        const Type* type = dynamic_cast< const Type*>(registry->GetType(uuid));
+
+        if (type == NULL) {
+            throw ::Smp::Publication::NotRegistered(uuid);
+        }
+
+        return *type;
+    }
+}
+
+Type::Type(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid& uuid,
+        ::Smp::SimpleTypeKind simpleType) :
+    m_uuid(uuid),
+    m_simpleType(simpleType),
+    m_layout(NULL),
+    m_layoutVersion(0)
+{
+    this->m_name = strdup((name != NULL) ? name : "");
+    this->m_description = strdup((description != NULL) ? description : "");
+}
+
+Type::~Type(void)
+{
+    delete this->m_layout;
+}
+
+::Smp::SimpleTypeKind Type::GetSimpleType(void) const
+{
+    return this->m_simpleType;
+}
+
+const ::Smp::Uuid Type::GetUuid(void) const
+{
+    return this->m_uuid;
+}
+
+void Type::Publish(
+        ::Smp::IPublication* receiver,
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        void* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    PublishSimple(receiver, this->m_simpleType, name, description, address,
+            view, state, input, output);
+}
+
+void Type::PublishSimple(
+        ::Smp::IPublication* receiver,
+        ::Smp::SimpleTypeKind simpleType,
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        void* address,
+        ::Smp::Bool view,
+        ::Smp::Bool state,
+        ::Smp::Bool input,
+        ::Smp::Bool output)
+{
+    switch (simpleType) {
+        case ::Smp::ST_None:
+            break;
+        case ::Smp::ST_Char8:
+            receiver->PublishField(name, description, static_cast< ::Smp::Char8*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_Bool:
+            receiver->PublishField(name, description, static_cast< ::Smp::Bool*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_Int8:
+            receiver->PublishField(name, description, static_cast< ::Smp::Int8*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_UInt8:
+            receiver->PublishField(name, description, static_cast< ::Smp::UInt8*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_Int16:
+            receiver->PublishField(name, description, static_cast< ::Smp::Int16*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_UInt16:
+            receiver->PublishField(name, description, static_cast< ::Smp::UInt16*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_Int32:
+            receiver->PublishField(name, description, static_cast< ::Smp::Int32*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_UInt32:
+            receiver->PublishField(name, description, static_cast< ::Smp::UInt32*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_UInt64:
+            receiver->PublishField(name, description, static_cast< ::Smp::UInt64*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_Float32:
+            receiver->PublishField(name, description, static_cast< ::Smp::Float32*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_Float64:
+            receiver->PublishField(name, description, static_cast< ::Smp::Float64*>(address),
+                    view, state, input, output);
+            break;
+        case ::Smp::ST_Int64:
+        case ::Smp::ST_Duration:
+        case ::Smp::ST_DateTime:
+            // Durations and date times have no overload of their own.
+            receiver->PublishField(name, description, static_cast< ::Smp::Int64*>(address),
+                    view, state, input, output);
+            break;
+        default:
+            throw ::Smp::Publication::InvalidFieldType(simpleType);
+    }
+}
+
+const Layout& Type::GetLayout(void) const
+{
+    if ((this->m_layout != NULL) && (this->m_layoutVersion != s_layoutVersion)) {
+        // A type this one may be made of has changed since.
+        delete this->m_layout;
+        this->m_layout = NULL;
+    }
+
+    if (this->m_layout == NULL) {
+        Layout* layout = new Layout();
+
+        try {
+            Flatten(*layout, "", 0, Layout::ENTRY_VIEW | Layout::ENTRY_STATE);
+        } catch (...) {
+            delete layout;
+            throw;
+        }
+
+        layout->Compile();
+        this->m_layout = layout;
+        this->m_layoutVersion = s_layoutVersion;
+    }
+
+    return *this->m_layout;
+}
+
+void Type::Flatten(
+        Layout& layout,
+        const ::std::string& name,
+        ::Smp::Int64 offset,
+        ::Smp::UInt8 flags) const
+{
+    if (this->m_simpleType == ::Smp::ST_None) {
+        return;
+    }
+
+    if (Publication::GetTypeSize(this->m_simpleType) == 0) {
+        throw ::Smp::Publication::InvalidFieldType(this->m_simpleType);
+    }
+
+    layout.Add(name, offset, this->m_simpleType, 1, flags);
+}
+
+void Type::ResetLayout(void)
+{
+    delete this->m_layout;
+    this->m_layout = NULL;
+    ++s_layoutVersion;
+}
+
+EnumerationType::EnumerationType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid& uuid,
+        ::Smp::Int16 memorySize) :
+    Type(name, description, uuid, GetEnumerationKind(memorySize))
+{
+}
+
+EnumerationType::~EnumerationType(void)
+{
+}
+
+void EnumerationType::AddLiteral(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Int32 value)
+{
+    Literal literal;
+    literal.name = (name != NULL) ? name : "";
+    literal.value = value;
+
+    this->m_literals.push_back(literal);
+}
+
+const EnumerationType::LiteralCollection& EnumerationType::GetLiterals(void) const
+{
+    return this->m_literals;
+}
+
+ArrayType::ArrayType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid& uuid,
+        const ::Smp::Publication::ITypeRegistry* registry,
+        const ::Smp::Uuid& itemUuid,
+        ::Smp::Int64 itemSize,
+        ::Smp::Int64 count) :
+    Type(name, description, uuid, ::Smp::ST_None),
+    m_registry(registry),
+    m_itemUuid(itemUuid),
+    m_itemSize(itemSize),
+    m_count(count)
+{
+}
+
+ArrayType::~ArrayType(void)
+{
+}
+
+void ArrayType::Publish(
+        ::Smp::IPublication* receiver,
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        void* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    ::Smp::Publication::IType* itemType = this->m_registry->GetType(this->m_itemUuid);
+
+    if (itemType == NULL) {
+        throw ::Smp::Publication::NotRegistered(this->m_itemUuid);
+    }
+
+    const ::Smp::SimpleTypeKind itemKind = itemType->GetSimpleType();
+
+    if ((itemKind != ::Smp::ST_None) &&
+            (static_cast< ::Smp::Int64>(Publication::GetTypeSize(itemKind)) == this->m_itemSize)) {
+        receiver->PublishArray(name, description, this->m_count, address, itemKind,
+                view, state, input, output);
+        return;
+    }
+
+    ::Smp::IPublication* array = receiver->PublishArray(name, description);
+    char* item = static_cast< char*>(address);
+    char itemName[24];
+
+    for (::Smp::Int64 i = 0; i < this->m_count; ++i) {
+        snprintf(itemName, sizeof(itemName), "%lld", static_cast< long long>(i));
+        itemType->Publish(array, itemName, description, item + (i * this->m_itemSize),
+                view, state, input, output);
+    }
+}
+
+void ArrayType::Flatten(
+        Layout& layout,
+        const ::std::string& name,
+        ::Smp::Int64 offset,
+        ::Smp::UInt8 flags) const
+{
+    const Type& itemType = GetRegisteredType(this->m_registry, this->m_itemUuid);
+    const ::Smp::SimpleTypeKind itemKind = itemType.GetSimpleType();
+
+    if ((itemKind != ::Smp::ST_None) &&
+            (static_cast< ::Smp::Int64>(Publication::GetTypeSize(itemKind)) == this->m_itemSize)) {
+        layout.Add(name, offset, itemKind, this->m_count, flags | Layout::ENTRY_ARRAY);
+        return;
+    }
+
+    char itemName[24];
+
+    for (::Smp::Int64 i = 0; i < this->m_count; ++i) {
+        snprintf(itemName, sizeof(itemName), "[%lld]", static_cast< long long>(i));
+        itemType.Flatten(layout, name + itemName, offset + (i * this->m_itemSize), flags);
+    }
+}
+
+StringType::StringType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid& uuid,
+        ::Smp::Int64 length) :
+    Type(name, description, uuid, ::Smp::ST_None),
+    m_length(length)
+{
+}
+
+StringType::~StringType(void)
+{
+}
+
+void StringType::Publish(
+        ::Smp::IPublication* receiver,
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        void* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    receiver->PublishArray(name, description, this->m_length + 1, address, ::Smp::ST_Char8,
+            view, state, input, output);
+}
+
+void StringType::Flatten(
+        Layout& layout,
+        const ::std::string& name,
+        ::Smp::Int64 offset,
+        ::Smp::UInt8 flags) const
+{
+    layout.Add(name, offset, ::Smp::ST_Char8, this->m_length + 1, flags | Layout::ENTRY_ARRAY);
+}
+
+StructureType::StructureType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid& uuid,
+        const ::Smp::Publication::ITypeRegistry* registry) :
+    Type(name, description, uuid, ::Smp::ST_None),
+    m_registry(registry)
+{
+}
+
+StructureType::~StructureType(void)
+{
+}
+
+void StructureType::AddField(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid uuid,
+        const ::Smp::Int64 offset,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    Field field;
+    field.name = (name != NULL) ? name : "";
+    field.description = (description != NULL) ? description : "";
+    field.uuid = uuid;
+    field.offset = offset;
+    field.view = view;
+    field.state = state;
+    field.input = input;
+    field.output = output;
+
+    this->m_fields.push_back(field);
+    ResetLayout();
+}
+
+void StructureType::Publish(
+        ::Smp::IPublication* receiver,
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        void* address,
+        const ::Smp::Bool view,
+        const ::Smp::Bool state,
+        const ::Smp::Bool input,
+        const ::Smp::Bool output)
+{
+    PublishFields(receiver->PublishStructure(name, description), static_cast< char*>(address),
+            view, state, input, output);
+}
+
+void StructureType::PublishFields(
+        ::Smp::IPublication* receiver,
+        char* address,
+        ::Smp::Bool view,
+        ::Smp::Bool state,
+        ::Smp::Bool input,
+        ::Smp::Bool output)
+{
+    for (FieldCollection::const_iterator it(this->m_fields.begin());
+            it != this->m_fields.end();
+            ++it) {
+        ::Smp::Publication::IType* type = this->m_registry->GetType(it->uuid);
+
+        if (type == NULL) {
+            throw ::Smp::Publication::NotRegistered(it->uuid);
+        }
+
+        type->Publish(receiver, it->name.c_str(), it->description.c_str(), address + it->offset,
+                view && it->view, state && it->state, input || it->input, output || it->output);
+    }
+}
+
+void StructureType::Flatten(
+        Layout& layout,
+        const ::std::string& name,
+        ::Smp::Int64 offset,
+        ::Smp::UInt8 flags) const
+{
+    FlattenFields(layout, name + ".", offset, flags);
+}
+
+void StructureType::FlattenFields(
+        Layout& layout,
+        const ::std::string& name,
+        ::Smp::Int64 offset,
+        ::Smp::UInt8 flags) const
+{
+    for (FieldCollection::const_iterator it(this->m_fields.begin());
+            it != this->m_fields.end();
+            ++it) {
+        GetRegisteredType(this->m_registry, it->uuid).Flatten(layout, name + it->name,
+                offset + it->offset, GetFieldFlags(flags, *it));
+    }
+}
+
+const StructureType::FieldCollection& StructureType::GetFields(void) const
+{
+    return this->m_fields;
+}
+
+ClassType::ClassType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid& uuid,
+        const ::Smp::Publication::ITypeRegistry* registry,
+        const ::Smp::Uuid& baseClassUuid) :
+    StructureType(name, description, uuid, registry),
+    m_baseClassUuid(baseClassUuid)
+{
+}
+
+ClassType::~ClassType(void)
+{
+}
+
+void ClassType::PublishFields(
+        ::Smp::IPublication* receiver,
+        char* address,
+        ::Smp::Bool view,
+        ::Smp::Bool state,
+        ::Smp::Bool input,
+        ::Smp::Bool output)
+{
+    if (::Smp::Mdk::NullUuid != this->m_baseClassUuid) {
+        StructureType* base = dynamic_cast< StructureType*>(
+                this->m_registry->GetType(this->m_baseClassUuid));
+
+        if (base == NULL) {
+            throw ::Smp::Publication::NotRegistered(this->m_baseClassUuid);
+        }
+
+        base->PublishFields(receiver, address, view, state, input, output);
+    }
+
+    StructureType::PublishFields(receiver, address, view, state, input, output);
+}
+
+void ClassType::FlattenFields(
+        Layout& layout,
+        const ::std::string& name,
+        ::Smp::Int64 offset,
+        ::Smp::UInt8 flags) const
+{
+    if (::Smp::Mdk::NullUuid != this->m_baseClassUuid) {
+        const StructureType* base = dynamic_cast< const StructureType*>(
+                this->m_registry->GetType(this->m_baseClassUuid));
+
+        if (base == NULL) {
+            throw ::Smp::Publication::NotRegistered(this->m_baseClassUuid);
+        }
+
+        base->FlattenFields(layout, name, offset, flags);
+    }
+
+    StructureType::FlattenFields(layout, name, offset, flags);
+}
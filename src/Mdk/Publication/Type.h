@@ -0,0 +1,358 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_PUBLICATION_TYPE_H_
+#define MDK_PUBLICATION_TYPE_H_
+
+#include "Smp/IPublication.h"
+#include "Smp/Publication/IClassType.h"
+#include "Smp/Publication/IEnumerationType.h"
+#include "Smp/Publication/IStructureType.h"
+#include "Mdk/Object.h"
+#include "Mdk/Publication/Layout.h"
+
+#include <string>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Publication
+        {
+            /// Type registered in a TypeRegistry.  Types of simple kind,
+            /// such as the predefined types and integer and float types,
+            /// publish themselves as a field of that kind.  Every type
+            /// also has a flattened Layout, built on first use and shared
+            /// by all its instances; the types it is made of must be
+            /// registered and complete by then.
+            class Type :
+                public ::Smp::Mdk::Object,
+                public virtual ::Smp::Publication::IType
+            {
+                public:
+                    /// Names are not validated, as they come from type
+                    /// registration, which cannot report invalid names.
+                    Type(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid& uuid,
+                            ::Smp::SimpleTypeKind simpleType);
+                    virtual ~Type(void);
+
+                    virtual ::Smp::SimpleTypeKind GetSimpleType(void) const;
+                    virtual const ::Smp::Uuid GetUuid(void) const;
+
+                    /// @throw ::Smp::Publication::InvalidFieldType if the
+                    ///        type is ST_String8.
+                    virtual void Publish(
+                            ::Smp::IPublication* receiver,
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            void* address,
+                            const ::Smp::Bool view,
+                            const ::Smp::Bool state,
+                            const ::Smp::Bool input,
+                            const ::Smp::Bool output);
+
+                    /// Publish a field of the given simple type through the
+                    /// matching PublishField() overload.
+                    static void PublishSimple(
+                            ::Smp::IPublication* receiver,
+                            ::Smp::SimpleTypeKind simpleType,
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            void* address,
+                            ::Smp::Bool view,
+                            ::Smp::Bool state,
+                            ::Smp::Bool input,
+                            ::Smp::Bool output);
+
+                    /// Flattened layout of the type, built on first use,
+                    /// and rebuilt on the next use once any type has been
+                    /// changed, as the type may be made of it.  The layout
+                    /// returned is valid until then.  Building is not
+                    /// synchronised, so the first use should not race with
+                    /// other threads.
+                    /// @throw ::Smp::Publication::NotRegistered if a type
+                    ///        the type is made of is not registered.
+                    /// @throw ::Smp::Publication::InvalidFieldType if the
+                    ///        type, or one it is made of, is ST_String8.
+                    const Layout& GetLayout(void) const;
+
+                    /// Add the entries of an instance of the type at offset,
+                    /// named name, to layout.
+                    virtual void Flatten(
+                            Layout& layout,
+                            const ::std::string& name,
+                            ::Smp::Int64 offset,
+                            ::Smp::UInt8 flags) const;
+
+                protected:
+                    /// Drop the layout when the type changes, and have the
+                    /// layouts of all the other types rebuilt.
+                    void ResetLayout(void);
+
+                private:
+                    Type(
+                            const Type&);
+                    Type& operator= (
+                            const Type&);
+
+                    ::Smp::Uuid m_uuid;
+                    ::Smp::SimpleTypeKind m_simpleType;
+                    mutable Layout* m_layout;
+                    /// Version of the types the layout was built from.
+                    mutable ::Smp::UInt64 m_layoutVersion;
+
+                    /// Increased every time a type changes.
+                    static ::Smp::UInt64 s_layoutVersion;
+            };
+
+            /// Enumeration type, published as an integer of its memory
+            /// size.
+            class EnumerationType :
+                public ::Smp::Mdk::Publication::Type,
+                public virtual ::Smp::Publication::IEnumerationType
+            {
+                public:
+                    struct Literal
+                    {
+                        ::std::string name;
+                        ::Smp::Int32 value;
+                    };
+
+                    typedef ::std::vector< Literal> LiteralCollection;
+
+                    EnumerationType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid& uuid,
+                            ::Smp::Int16 memorySize);
+                    virtual ~EnumerationType(void);
+
+                    virtual void AddLiteral(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Int32 value);
+
+                    const LiteralCollection& GetLiterals(void) const;
+
+                private:
+                    LiteralCollection m_literals;
+            };
+
+            /// Array type, published as an array of simple type if its
+            /// items are of simple type, or item by item otherwise.
+            class ArrayType :
+                public ::Smp::Mdk::Publication::Type
+            {
+                public:
+                    ArrayType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid& uuid,
+                            const ::Smp::Publication::ITypeRegistry* registry,
+                            const ::Smp::Uuid& itemUuid,
+                            ::Smp::Int64 itemSize,
+                            ::Smp::Int64 count);
+                    virtual ~ArrayType(void);
+
+                    /// @throw ::Smp::Publication::NotRegistered if the item
+                    ///        type is not registered.
+                    virtual void Publish(
+                            ::Smp::IPublication* receiver,
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            void* address,
+                            const ::Smp::Bool view,
+                            const ::Smp::Bool state,
+                            const ::Smp::Bool input,
+                            const ::Smp::Bool output);
+
+                    /// @throw ::Smp::Publication::NotRegistered if the item
+                    ///        type is not registered.
+                    virtual void Flatten(
+                            Layout& layout,
+                            const ::std::string& name,
+                            ::Smp::Int64 offset,
+                            ::Smp::UInt8 flags) const;
+
+                private:
+                    const ::Smp::Publication::ITypeRegistry* m_registry;
+                    ::Smp::Uuid m_itemUuid;
+                    ::Smp::Int64 m_itemSize;
+                    ::Smp::Int64 m_count;
+            };
+
+            /// String type of a given length, published as an array of
+            /// characters including the terminating null character.
+            class StringType :
+                public ::Smp::Mdk::Publication::Type
+            {
+                public:
+                    StringType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid& uuid,
+                            ::Smp::Int64 length);
+                    virtual ~StringType(void);
+
+                    virtual void Publish(
+                            ::Smp::IPublication* receiver,
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            void* address,
+                            const ::Smp::Bool view,
+                            const ::Smp::Bool state,
+                            const ::Smp::Bool input,
+                            const ::Smp::Bool output);
+
+                    virtual void Flatten(
+                            Layout& layout,
+                            const ::std::string& name,
+                            ::Smp::Int64 offset,
+                            ::Smp::UInt8 flags) const;
+
+                private:
+                    ::Smp::Int64 m_length;
+            };
+
+            /// Structure type, published as a nested structure whose fields
+            /// publish themselves through their own types.  View and state
+            /// flags of fields apply only if they apply to the structure.
+            class StructureType :
+                public ::Smp::Mdk::Publication::Type,
+                public virtual ::Smp::Publication::IStructureType
+            {
+                public:
+                    struct Field
+                    {
+                        ::std::string name;
+                        ::std::string description;
+                        ::Smp::Uuid uuid;
+                        ::Smp::Int64 offset;
+                        ::Smp::Bool view;
+                        ::Smp::Bool state;
+                        ::Smp::Bool input;
+                        ::Smp::Bool output;
+                    };
+
+                    typedef ::std::vector< Field> FieldCollection;
+
+                    StructureType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid& uuid,
+                            const ::Smp::Publication::ITypeRegistry* registry);
+                    virtual ~StructureType(void);
+
+                    virtual void AddField(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid uuid,
+                            const ::Smp::Int64 offset,
+                            const ::Smp::Bool view = true,
+                            const ::Smp::Bool state = true,
+                            const ::Smp::Bool input = false,
+                            const ::Smp::Bool output = false);
+
+                    /// @throw ::Smp::Publication::NotRegistered if the type
+                    ///        of a field is not registered.
+                    virtual void Publish(
+                            ::Smp::IPublication* receiver,
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            void* address,
+                            const ::Smp::Bool view,
+                            const ::Smp::Bool state,
+                            const ::Smp::Bool input,
+                            const ::Smp::Bool output);
+
+                    /// Publish the fields of the structure at address
+                    /// through receiver.
+                    virtual void PublishFields(
+                            ::Smp::IPublication* receiver,
+                            char* address,
+                            ::Smp::Bool view,
+                            ::Smp::Bool state,
+                            ::Smp::Bool input,
+                            ::Smp::Bool output);
+
+                    /// @throw ::Smp::Publication::NotRegistered if the type
+                    ///        of a field is not registered.
+                    virtual void Flatten(
+                            Layout& layout,
+                            const ::std::string& name,
+                            ::Smp::Int64 offset,
+                            ::Smp::UInt8 flags) const;
+
+                    /// Add the entries of the fields of the structure at
+                    /// offset to layout.
+                    virtual void FlattenFields(
+                            Layout& layout,
+                            const ::std::string& name,
+                            ::Smp::Int64 offset,
+                            ::Smp::UInt8 flags) const;
+
+                    const FieldCollection& GetFields(void) const;
+
+                protected:
+                    const ::Smp::Publication::ITypeRegistry* m_registry;
+
+                private:
+                    FieldCollection m_fields;
+            };
+
+            /// Class type, whose fields follow the fields of its base
+            /// class, if any.
+            class ClassType :
+                public ::Smp::Mdk::Publication::StructureType,
+                public virtual ::Smp::Publication::IClassType
+            {
+                public:
+                    ClassType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid& uuid,
+                            const ::Smp::Publication::ITypeRegistry* registry,
+                            const ::Smp::Uuid& baseClassUuid);
+                    virtual ~ClassType(void);
+
+                    virtual void PublishFields(
+                            ::Smp::IPublication* receiver,
+                            char* address,
+                            ::Smp::Bool view,
+                            ::Smp::Bool state,
+                            ::Smp::Bool input,
+                            ::Smp::Bool output);
+
+                    virtual void FlattenFields(
+                            Layout& layout,
+                            const ::std::string& name,
+                            ::Smp::Int64 offset,
+                            ::Smp::UInt8 flags) const;
+
+                private:
+                    ::Smp::Uuid m_baseClassUuid;
+            };
+        }
+    }
+}
+
+#endif  // MDK_PUBLICATION_TYPE_H_
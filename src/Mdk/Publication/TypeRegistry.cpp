@@ -0,0 +1,260 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Publication/TypeRegistry.h"
+#include "Mdk/Uuid.h"
+
+using namespace ::Smp::Mdk::Publication;
+
+const size_t TypeRegistry::MIN_CAPACITY;
+
+TypeRegistry::TypeRegistry(void)
+{
+    for (size_t i = 0; i <= ::Smp::ST_String8; ++i) {
+        this->m_simpleTypes[i] = NULL;
+    }
+
+    AddSimpleType("Void", ::Smp::Publication::Uuid_Void, ::Smp::ST_None);
+    AddSimpleType("Char8", ::Smp::Publication::Uuid_Char8, ::Smp::ST_Char8);
+    AddSimpleType("Bool", ::Smp::Publication::Uuid_Bool, ::Smp::ST_Bool);
+    AddSimpleType("Int8", ::Smp::Publication::Uuid_Int8, ::Smp::ST_Int8);
+    AddSimpleType("Int16", ::Smp::Publication::Uuid_Int16, ::Smp::ST_Int16);
+    AddSimpleType("Int32", ::Smp::Publication::Uuid_Int32, ::Smp::ST_Int32);
+    AddSimpleType("Int64", ::Smp::Publication::Uuid_Int64, ::Smp::ST_Int64);
+    AddSimpleType("UInt8", ::Smp::Publication::Uuid_UInt8, ::Smp::ST_UInt8);
+    AddSimpleType("UInt16", ::Smp::Publication::Uuid_UInt16, ::Smp::ST_UInt16);
+    AddSimpleType("UInt32", ::Smp::Publication::Uuid_UInt32, ::Smp::ST_UInt32);
+    AddSimpleType("UInt64", ::Smp::Publication::Uuid_UInt64, ::Smp::ST_UInt64);
+    AddSimpleType("Float32", ::Smp::Publication::Uuid_Float32, ::Smp::ST_Float32);
+    AddSimpleType("Float64", ::Smp::Publication::Uuid_Float64, ::Smp::ST_Float64);
+    AddSimpleType("DateTime", ::Smp::Publication::Uuid_DateTime, ::Smp::ST_DateTime);
+    AddSimpleType("Duration", ::Smp::Publication::Uuid_Duration, ::Smp::ST_Duration);
+    AddSimpleType("String8", ::Smp::Publication::Uuid_String8, ::Smp::ST_String8);
+}
+
+TypeRegistry::~TypeRegistry(void)
+{
+    for (TypeCollection::iterator it(this->m_types.begin());
+            it != this->m_types.end();
+            ++it) {
+        delete *it;
+    }
+}
+
+::Smp::Publication::IType* TypeRegistry::GetType(
+        const ::Smp::SimpleTypeKind type) const
+{
+    if ((type < ::Smp::ST_None) || (type > ::Smp::ST_String8)) {
+        return NULL;
+    }
+
+    return this->m_simpleTypes[type];
+}
+
+::Smp::Publication::IType* TypeRegistry::GetType(
+        const ::Smp::Uuid typeUuid) const
+{
+    if (this->m_slots.empty()) {
+        return NULL;
+    }
+
+    const ::Smp::Mdk::Uuid uuid(typeUuid);
+    const size_t mask = this->m_slots.size() - 1;
+
+    for (size_t i = uuid.Hash() & mask; this->m_slots[i] != NULL; i = (i + 1) & mask) {
+        if (uuid == this->m_slots[i]->GetUuid()) {
+            return this->m_slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+const ::Smp::Publication::IType* TypeRegistry::AddFloatType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::Float64 minimum,
+        const ::Smp::Float64 maximum,
+        const ::Smp::Bool minInclusive,
+        const ::Smp::Bool maxInclusive,
+        ::Smp::String8 unit,
+        const ::Smp::SimpleTypeKind type)
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    CheckUnique(name, typeUuid);
+
+    return Register(new Type(name, description, typeUuid, type));
+}
+
+const ::Smp::Publication::IType* TypeRegistry::AddIntegerType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::Int64 minimum,
+        const ::Smp::Int64 maximum,
+        const ::Smp::SimpleTypeKind type)
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    CheckUnique(name, typeUuid);
+
+    return Register(new Type(name, description, typeUuid, type));
+}
+
+::Smp::Publication::IEnumerationType* TypeRegistry::AddEnumerationType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::Int16 memorySize)
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    CheckUnique(name, typeUuid);
+
+    return Register(new EnumerationType(name, description, typeUuid, memorySize));
+}
+
+const ::Smp::Publication::IType* TypeRegistry::AddArrayType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::Uuid itemTypeUuid,
+        const ::Smp::Int64 itemSize,
+        const ::Smp::Int64 arrayCount)
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    CheckUnique(name, typeUuid);
+
+    return Register(new ArrayType(name, description, typeUuid, this,
+                itemTypeUuid, itemSize, arrayCount));
+}
+
+const ::Smp::Publication::IType* TypeRegistry::AddStringType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::Int64 length)
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    CheckUnique(name, typeUuid);
+
+    return Register(new StringType(name, description, typeUuid, length));
+}
+
+::Smp::Publication::IStructureType* TypeRegistry::AddStructureType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid)
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    CheckUnique(name, typeUuid);
+
+    return Register(new StructureType(name, description, typeUuid, this));
+}
+
+::Smp::Publication::IClassType* TypeRegistry::AddClassType(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        const ::Smp::Uuid typeUuid,
+        const ::Smp::Uuid baseClassUuid)
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    CheckUnique(name, typeUuid);
+
+    return Register(new ClassType(name, description, typeUuid, this, baseClassUuid));
+}
+
+void TypeRegistry::Reserve(
+        size_t count)
+{
+    if ((count * 2) <= this->m_slots.size()) {
+        return;
+    }
+
+    // Keep the load factor at or below 1/2.
+    size_t capacity = MIN_CAPACITY;
+
+    while (capacity < (count * 2)) {
+        capacity *= 2;
+    }
+
+    Rehash(capacity);
+}
+
+size_t TypeRegistry::GetTypeCount(void) const
+{
+    return this->m_types.size();
+}
+
+void TypeRegistry::CheckUnique(
+        ::Smp::String8 name,
+        const ::Smp::Uuid& typeUuid) const
+    throw (::Smp::Publication::AlreadyRegistered)
+{
+    ::Smp::Publication::IType* registered = GetType(typeUuid);
+
+    if (registered != NULL) {
+        throw ::Smp::Publication::AlreadyRegistered((name != NULL) ? name : "", registered);
+    }
+}
+
+template < typename T> T* TypeRegistry::Register(
+        T* type)
+{
+    Reserve(this->m_types.size() + 1);
+
+    const size_t mask = this->m_slots.size() - 1;
+    size_t i = ::Smp::Mdk::Uuid::Hash(type->GetUuid()) & mask;
+
+    while (this->m_slots[i] != NULL) {
+        i = (i + 1) & mask;
+    }
+
+    this->m_slots[i] = type;
+    this->m_types.push_back(type);
+
+    return type;
+}
+
+void TypeRegistry::AddSimpleType(
+        ::Smp::String8 name,
+        const ::Smp::Uuid& typeUuid,
+        ::Smp::SimpleTypeKind type)
+{
+    this->m_simpleTypes[type] = Register(new Type(name, name, typeUuid, type));
+}
+
+void TypeRegistry::Rehash(
+        size_t capacity)
+{
+    TypeCollection slots(capacity, static_cast< Type*>(NULL));
+    const size_t mask = capacity - 1;
+
+    for (TypeCollection::const_iterator it(this->m_types.begin());
+            it != this->m_types.end();
+            ++it) {
+        size_t i = ::Smp::Mdk::Uuid::Hash((*it)->GetUuid()) & mask;
+
+        while (slots[i] != NULL) {
+            i = (i + 1) & mask;
+        }
+
+        slots[i] = *it;
+    }
+
+    this->m_slots.swap(slots);
+}
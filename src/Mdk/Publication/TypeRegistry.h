@@ -0,0 +1,152 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_PUBLICATION_TYPEREGISTRY_H_
+#define MDK_PUBLICATION_TYPEREGISTRY_H_
+
+#include "Smp/Publication/ITypeRegistry.h"
+#include "Mdk/Publication/Type.h"
+
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Publication
+        {
+            /// Registry of types, looked up by uuid.  Types are kept in an
+            /// open addressing hash table with linear probing, hashed with
+            /// Mdk::Uuid::Hash(), so that registering n types takes linear
+            /// time.  The predefined types of simple kind are registered
+            /// on construction, and also kept in an array indexed by kind.
+            /// The registry owns the types registered.
+            class TypeRegistry :
+                public virtual ::Smp::Publication::ITypeRegistry
+            {
+                public:
+                    TypeRegistry(void);
+                    virtual ~TypeRegistry(void);
+
+                    virtual ::Smp::Publication::IType* GetType(
+                            const ::Smp::SimpleTypeKind type) const;
+
+                    virtual ::Smp::Publication::IType* GetType(
+                            const ::Smp::Uuid typeUuid) const;
+
+                    virtual const ::Smp::Publication::IType* AddFloatType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::Float64 minimum,
+                            const ::Smp::Float64 maximum,
+                            const ::Smp::Bool minInclusive,
+                            const ::Smp::Bool maxInclusive,
+                            ::Smp::String8 unit,
+                            const ::Smp::SimpleTypeKind type = ::Smp::ST_Float64)
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    virtual const ::Smp::Publication::IType* AddIntegerType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::Int64 minimum,
+                            const ::Smp::Int64 maximum,
+                            const ::Smp::SimpleTypeKind type = ::Smp::ST_Int32)
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    virtual ::Smp::Publication::IEnumerationType* AddEnumerationType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::Int16 memorySize)
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    virtual const ::Smp::Publication::IType* AddArrayType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::Uuid itemTypeUuid,
+                            const ::Smp::Int64 itemSize,
+                            const ::Smp::Int64 arrayCount)
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    virtual const ::Smp::Publication::IType* AddStringType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::Int64 length)
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    virtual ::Smp::Publication::IStructureType* AddStructureType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid)
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    virtual ::Smp::Publication::IClassType* AddClassType(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            const ::Smp::Uuid typeUuid,
+                            const ::Smp::Uuid baseClassUuid)
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    /// Make room for count types without further rehashing.
+                    void Reserve(
+                            size_t count);
+
+                    /// Number of types registered, predefined ones included.
+                    size_t GetTypeCount(void) const;
+
+                private:
+                    TypeRegistry(
+                            const TypeRegistry&);
+                    TypeRegistry& operator= (
+                            const TypeRegistry&);
+
+                    static const size_t MIN_CAPACITY = 64;
+
+                    typedef ::std::vector< Type*> TypeCollection;
+
+                    /// @throw ::Smp::Publication::AlreadyRegistered if a type
+                    ///        with the same uuid is registered.
+                    void CheckUnique(
+                            ::Smp::String8 name,
+                            const ::Smp::Uuid& typeUuid) const
+                        throw (::Smp::Publication::AlreadyRegistered);
+
+                    template < typename T> T* Register(
+                            T* type);
+
+                    void AddSimpleType(
+                            ::Smp::String8 name,
+                            const ::Smp::Uuid& typeUuid,
+                            ::Smp::SimpleTypeKind type);
+
+                    void Rehash(
+                            size_t capacity);
+
+                    TypeCollection m_types;
+                    TypeCollection m_slots;
+                    Type* m_simpleTypes[::Smp::ST_String8 + 1];
+            };
+        }
+    }
+}
+
+#endif  // MDK_PUBLICATION_TYPEREGISTRY_H_
@@ -21,8 +21,11 @@
 
 #include "Smp/IReference.h"
 #include "Mdk/Object.h"
+#include "Mdk/NameIndex.h"
+#include "Mdk/PointerIndex.h"
+#include "Mdk/CachedCast.h"
 
-#include <algorithm>
+#include <cstring>
 
 namespace Smp
 {
@@ -30,18 +33,25 @@ namespace Mdk
 {
 template <typename T>
 class Reference : public ::Smp::Mdk::Object,
-                  public virtual ::Smp::IReference
+                  public virtual ::Smp::IReference,
+                  public ::Smp::Mdk::Indexed< ::Smp::IComponent>
 {
 public:
     typedef typename ::std::vector<T *> ProviderCollection;
     typedef typename ProviderCollection::const_iterator ProviderIterator;
 
+    /// @param preserveOrder If true, Remove keeps the order in which the
+    ///        remaining providers were added, at O(N) cost.  Otherwise the
+    ///        last provider is moved into the place of the removed one.
     Reference(
         ::Smp::String8 name,
         ::Smp::String8 description,
-        ::Smp::IComponent *parent) throw(::Smp::InvalidObjectName)
+        ::Smp::IComponent *parent,
+        ::Smp::Bool preserveOrder = false) throw(::Smp::InvalidObjectName)
         : Object(name, description),
-          m_parent(parent)
+          m_parent(parent),
+          m_preserveOrder(preserveOrder),
+          m_shadowedNames(0)
     {
     }
 
@@ -55,26 +65,51 @@ public:
         return &(this->m_components);
     }
 
+    /// Providers may be renamed while referenced, which the reference is
+    /// not told about.  A name that is not found is looked for among the
+    /// providers, and the provider found is re-keyed.  Lookups must not
+    /// run concurrently.
     virtual ::Smp::IComponent *GetComponent(
         ::Smp::String8 name) const
     {
-        ::Smp::ComponentCollection::const_iterator it(
-            this->m_components.begin());
-        ::Smp::ComponentCollection::const_iterator endIt(
-            this->m_components.end());
-        ::Smp::IComponent *comp = NULL;
+        ::Smp::IComponent *component = this->m_componentsIndex.Find(name);
 
-        while ((comp == NULL) && (it != endIt))
+        if ((component != NULL) || (name == NULL))
         {
-            if (::strcmp(name, (*it)->GetName()) == 0)
+            return component;
+        }
+
+        for (::Smp::ComponentCollection::const_iterator it(this->m_components.begin());
+             it != this->m_components.end();
+             ++it)
+        {
+            if (((*it)->GetName() != NULL) && (::strcmp(name, (*it)->GetName()) == 0))
             {
-                comp = *it;
+                // Renamed to name since it was indexed, or shadowed by a
+                // provider that has been renamed away from name.
+                if (!this->m_componentsIndex.Rekey(*it, NULL) &&
+                    this->m_componentsIndex.Insert(*it))
+                {
+                    --this->m_shadowedNames;
+                }
+
+                return *it;
             }
-
-            ++it;
         }
 
-        return comp;
+        return NULL;
+    }
+
+    virtual const ::Smp::Mdk::NameIndex< ::Smp::IComponent> &GetIndex(void) const
+    {
+        return this->m_componentsIndex;
+    }
+
+    virtual bool Rekey(
+        ::Smp::IComponent *component,
+        ::Smp::String8 oldName)
+    {
+        return this->m_componentsIndex.Rekey(component, oldName);
     }
 
     virtual ::Smp::Int64 Count(void) const
@@ -106,6 +141,9 @@ public:
     {
         this->m_providers.clear();
         this->m_components.clear();
+        this->m_positions.Clear();
+        this->m_componentsIndex.Clear();
+        this->m_shadowedNames = 0;
     }
 
     virtual T *At(
@@ -127,6 +165,8 @@ public:
     }
 
 protected:
+    /// Add a provider.  A provider that is already referenced is not
+    /// added again.
     virtual void Add(
         ::Smp::IComponent *component) throw(::Smp::InvalidObjectType)
     {
@@ -135,15 +175,30 @@ protected:
             return;
         }
 
-        T *provider = dynamic_cast<T *>(component);
+        T *provider = this->m_providerCast(component);
 
         if (provider == NULL)
         {
             throw ::Smp::InvalidObjectType(component);
         }
 
-        this->m_providers.push_back(provider);
-        this->m_components.push_back(component);
+        Insert(component, provider);
+    }
+
+    /// Add a provider whose type is known at compile time, so that no
+    /// run-time cast is needed.
+    template <typename U>
+    void Add(
+        U *component)
+    {
+        T *provider = component;
+
+        if (provider == NULL)
+        {
+            return;
+        }
+
+        Insert(provider, provider);
     }
 
     virtual ::Smp::Bool Remove(
@@ -154,44 +209,113 @@ protected:
             return false;
         }
 
-        T *provider = dynamic_cast<T *>(component);
+        const size_t position = this->m_positions.Find(component);
 
-        if (provider == NULL)
+        if (position == PositionIndex::NPOS)
         {
             return false;
         }
 
-        ::Smp::Bool res = true;
-
-        typename ProviderCollection::iterator it = ::std::find(
-            this->m_providers.begin(),
-            this->m_providers.end(), provider);
+        this->m_positions.Remove(component);
 
-        if (it != this->m_providers.end())
+        if (this->m_preserveOrder)
         {
-            this->m_providers.erase(it);
+            this->m_providers.erase(this->m_providers.begin() + position);
+            this->m_components.erase(this->m_components.begin() + position);
 
-            ::Smp::ComponentCollection::iterator jt =
-                ::std::find(this->m_components.begin(),
-                            this->m_components.end(), provider);
-
-            if (jt != this->m_components.end())
+            for (size_t i = position; i < this->m_components.size(); ++i)
             {
-                this->m_components.erase(jt);
+                this->m_positions.Insert(this->m_components[i], i);
             }
         }
         else
         {
-            res = false;
+            const size_t last = this->m_components.size() - 1;
+
+            if (position != last)
+            {
+                this->m_providers[position] = this->m_providers[last];
+                this->m_components[position] = this->m_components[last];
+                this->m_positions.Insert(this->m_components[position], position);
+            }
+
+            this->m_providers.pop_back();
+            this->m_components.pop_back();
         }
 
-        return res;
+        RemoveName(component);
+
+        return true;
     }
 
 private:
+    typedef ::Smp::Mdk::PointerIndex< ::Smp::IComponent> PositionIndex;
+
+    void Insert(
+        ::Smp::IComponent *component,
+        T *provider)
+    {
+        if (this->m_positions.Find(component) != PositionIndex::NPOS)
+        {
+            return;
+        }
+
+        this->m_positions.Insert(component, this->m_components.size());
+
+        this->m_providers.push_back(provider);
+        this->m_components.push_back(component);
+
+        // Several providers may share a name; only the first one added is
+        // found by name, the others are counted as shadowed.
+        if (!this->m_componentsIndex.Insert(component))
+        {
+            ++this->m_shadowedNames;
+        }
+    }
+
+    void RemoveName(
+        ::Smp::IComponent *component)
+    {
+        if (!this->m_componentsIndex.Remove(component))
+        {
+            --this->m_shadowedNames;
+            return;
+        }
+
+        if (this->m_shadowedNames == 0)
+        {
+            return;
+        }
+
+        // Another provider with the same name may now become visible.
+        ::Smp::ComponentCollection::const_iterator it(this->m_components.begin());
+        ::Smp::ComponentCollection::const_iterator endIt(this->m_components.end());
+        ::Smp::Bool found = false;
+
+        while (!found && (it != endIt))
+        {
+            found = ((*it)->GetName() != NULL) &&
+                    (::strcmp(component->GetName(), (*it)->GetName()) == 0);
+
+            // A provider renamed since it was added may already be
+            // indexed under the name.
+            if (found && this->m_componentsIndex.Insert(*it))
+            {
+                --this->m_shadowedNames;
+            }
+
+            ++it;
+        }
+    }
+
     ::Smp::IComponent *m_parent;
     ProviderCollection m_providers;
     ::Smp::ComponentCollection m_components;
+    PositionIndex m_positions;
+    mutable ::Smp::Mdk::NameIndex< ::Smp::IComponent> m_componentsIndex;
+    ::Smp::Bool m_preserveOrder;
+    mutable ::Smp::Int64 m_shadowedNames;
+    ::Smp::Mdk::CachedCast< ::Smp::IComponent, T> m_providerCast;
 };
 } // namespace Mdk
 } // namespace Smp
@@ -0,0 +1,708 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Services/Resolver.h"
+
+#include "Smp/ISimulator.h"
+
+#include <algorithm>
+
+#include <string.h>
+
+using namespace ::Smp::Mdk::Services;
+
+const ::Smp::UInt32 Resolver::DEFAULT_CACHE_SIZE;
+const ::Smp::UInt32 Resolver::NONE;
+
+namespace
+{
+    const ::Smp::Char8 RESOLVER_PATH_SEPARATOR = '/';
+
+    /// Length of the path segment starting at path.
+    size_t SegmentLength(
+            const ::Smp::Char8* path)
+    {
+        const ::Smp::Char8* end = path;
+
+        while ((*end != '\0') && (*end != RESOLVER_PATH_SEPARATOR)) {
+            ++end;
+        }
+
+        return end - path;
+    }
+
+    /// Start of the segment following the one of the given length.
+    const ::Smp::Char8* NextSegment(
+            const ::Smp::Char8* path,
+            size_t length)
+    {
+        path += length;
+
+        return (*path == RESOLVER_PATH_SEPARATOR) ? path + 1 : path;
+    }
+}
+
+namespace
+{
+    const ::Smp::Char8* SkipRootSeparator(
+            const ::Smp::Char8* path)
+    {
+        return (*path == RESOLVER_PATH_SEPARATOR) ? path + 1 : path;
+    }
+
+    size_t CommonPrefixLength(
+            const ::Smp::Char8* first,
+            const ::Smp::Char8* second)
+    {
+        size_t length = 0;
+
+        if (first != NULL) {
+            while ((first[length] != '\0') && (first[length] == second[length])) {
+                ++length;
+            }
+        }
+
+        return length;
+    }
+
+    /// Orders positions in a collection of paths by the paths there.
+    class PathLess
+    {
+        public:
+            explicit PathLess(
+                    const Resolver::PathCollection& paths) :
+                m_paths(paths)
+            {
+            }
+
+            bool operator()(
+                    size_t first,
+                    size_t second) const
+            {
+                return ::strcmp(SkipRootSeparator(this->m_paths[first]),
+                        SkipRootSeparator(this->m_paths[second])) < 0;
+            }
+
+        private:
+            const Resolver::PathCollection& m_paths;
+    };
+
+    struct Hop
+    {
+        Hop(
+                size_t _end,
+                ::Smp::IComponent* _component) :
+            end(_end),
+            component(_component)
+        {
+        }
+
+        size_t end;
+        ::Smp::IComponent* component;
+    };
+
+    typedef ::std::vector< Hop> HopCollection;
+}
+
+Resolver::Resolver(
+        ::Smp::String8 name,
+        ::Smp::String8 description,
+        ::Smp::IComposite* parent,
+        ::Smp::UInt32 cacheSize)
+    throw (::Smp::InvalidObjectName) :
+        Component(name, description, parent),
+        m_cacheSize(cacheSize),
+        m_count(0),
+        m_newest(Resolver::NONE),
+        m_oldest(Resolver::NONE),
+        m_free(Resolver::NONE)
+{
+    if (cacheSize > 0) {
+        // Keep at least two buckets per entry, so that chains are short.
+        ::Smp::UInt32 buckets = 16;
+
+        while (buckets < (cacheSize * 2)) {
+            buckets *= 2;
+        }
+
+        this->m_entries.resize(cacheSize);
+        this->m_buckets.resize(buckets, Resolver::NONE);
+    }
+
+    ClearCache();
+
+    ::Smp::Mdk::Component::AddHierarchyObserver(this);
+}
+
+Resolver::~Resolver(void)
+{
+    ::Smp::Mdk::Component::RemoveHierarchyObserver(this);
+}
+
+::Smp::IComponent* Resolver::ResolveAbsolute(
+        ::Smp::String8 absolutePath)
+{
+    return Resolve(absolutePath, NULL);
+}
+
+::Smp::IComponent* Resolver::ResolveRelative(
+        ::Smp::String8 relativePath,
+        ::Smp::IComponent* sender)
+{
+    if (sender == NULL) {
+        return NULL;
+    }
+
+    return Resolve(relativePath, sender);
+}
+
+void Resolver::ResolveAll(
+        const PathCollection& paths,
+        ::Smp::ComponentCollection& components)
+{
+    components.assign(paths.size(), NULL);
+
+    // Sort the paths, so that paths sharing a prefix are next to each
+    // other, and only the part following the shared prefix is walked.
+    ::std::vector< size_t> order;
+    order.reserve(paths.size());
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (paths[i] != NULL) {
+            order.push_back(i);
+        }
+    }
+
+    ::std::sort(order.begin(), order.end(), PathLess(paths));
+
+    // Components reached by the walk of the previous path, with the
+    // offset of the end of the segment leading to each of them.
+    HopCollection hops;
+    const ::Smp::Char8* previous = NULL;
+
+    for (::std::vector< size_t>::const_iterator it(order.begin());
+            it != order.end();
+            ++it) {
+        const ::Smp::Char8* path = SkipRootSeparator(paths[*it]);
+        const size_t common = CommonPrefixLength(previous, path);
+
+        // Keep the hops ending within the shared prefix, at the end of a
+        // segment of this path as well.
+        while (!hops.empty() &&
+                ((hops.back().end > common) ||
+                 ((path[hops.back().end] != RESOLVER_PATH_SEPARATOR) &&
+                  (path[hops.back().end] != '\0')))) {
+            hops.pop_back();
+        }
+
+        previous = path;
+
+        if (hops.empty()) {
+            const size_t length = SegmentLength(path);
+            ::Smp::IComponent* root = (length > 0) ? FindRoot(path, length) : NULL;
+
+            if (root == NULL) {
+                continue;
+            }
+
+            hops.push_back(Hop(length, root));
+        }
+
+        ::Smp::IComponent* current = hops.back().component;
+        const ::Smp::Char8* cursor = path + hops.back().end;
+
+        for (;;) {
+            if (*cursor == RESOLVER_PATH_SEPARATOR) {
+                ++cursor;
+            }
+
+            if (*cursor == '\0') {
+                components[*it] = current;
+                break;
+            }
+
+            cursor = Step(current, cursor);
+
+            if (cursor == NULL) {
+                break;
+            }
+
+            hops.push_back(Hop(cursor - path, current));
+        }
+    }
+}
+
+void Resolver::AddRoot(
+        ::Smp::IComponent* root)
+    throw (::Smp::DuplicateName)
+{
+    if (root == NULL) {
+        return;
+    }
+
+    if (!this->m_rootsIndex.Insert(root)) {
+        throw ::Smp::DuplicateName(root->GetName());
+    }
+
+    this->m_roots.push_back(root);
+    ClearCache();
+}
+
+void Resolver::ClearCache(void)
+{
+    this->m_buckets.assign(this->m_buckets.size(), Resolver::NONE);
+    this->m_count = 0;
+    this->m_newest = Resolver::NONE;
+    this->m_oldest = Resolver::NONE;
+
+    // Chain all the entries in the free list, through nextInBucket.
+    this->m_free = Resolver::NONE;
+
+    for (::Smp::UInt32 i = this->m_cacheSize; i > 0; --i) {
+        this->m_entries[i - 1].nextInBucket = this->m_free;
+        this->m_free = i - 1;
+    }
+}
+
+void Resolver::OnHierarchyChanged(
+        const ::Smp::IComponent* component)
+{
+    if (this->m_count == 0) {
+        return;
+    }
+
+    if (component == NULL) {
+        ClearCache();
+        return;
+    }
+
+    ::Smp::UInt32 i = this->m_newest;
+
+    while (i != Resolver::NONE) {
+        const Entry& entry = this->m_entries[i];
+        const ::Smp::UInt32 older = entry.older;
+
+        if (::std::find(entry.trail.begin(), entry.trail.end(), component) !=
+                entry.trail.end()) {
+            Evict(i);
+        }
+
+        i = older;
+    }
+}
+
+void Resolver::OnComponentsChanged(
+        const ::Smp::IComposite* composite,
+        ::Smp::ComponentCollection::const_iterator first,
+        ::Smp::ComponentCollection::const_iterator last)
+{
+    if (this->m_count == 0) {
+        return;
+    }
+
+    ComponentTrail changed(first, last);
+
+    if (composite != NULL) {
+        changed.push_back(composite);
+    }
+
+    ::std::sort(changed.begin(), changed.end());
+
+    ::Smp::UInt32 i = this->m_newest;
+
+    while (i != Resolver::NONE) {
+        const Entry& entry = this->m_entries[i];
+        const ::Smp::UInt32 older = entry.older;
+
+        for (ComponentTrail::const_iterator it(entry.trail.begin());
+                it != entry.trail.end();
+                ++it) {
+            if (::std::binary_search(changed.begin(), changed.end(), *it)) {
+                Evict(i);
+                break;
+            }
+        }
+
+        i = older;
+    }
+}
+
+::Smp::UInt32 Resolver::GetCacheSize(void) const
+{
+    return this->m_cacheSize;
+}
+
+::Smp::UInt32 Resolver::GetCachedCount(void) const
+{
+    return this->m_count;
+}
+
+::Smp::IComponent* Resolver::Resolve(
+        ::Smp::String8 path,
+        ::Smp::IComponent* sender)
+{
+    if (path == NULL) {
+        return NULL;
+    }
+
+    const ::Smp::UInt32 hash = Resolver::Hash(path, sender);
+    const ::Smp::UInt32 entry = Lookup(path, sender, hash);
+
+    if (entry != Resolver::NONE) {
+        return this->m_entries[entry].component;
+    }
+
+    ::Smp::IComponent* component = NULL;
+
+    this->m_trail.clear();
+
+    if (sender != NULL) {
+        component = Walk(sender, path);
+    } else {
+        const ::Smp::Char8* segment = SkipRootSeparator(path);
+        const size_t length = SegmentLength(segment);
+
+        if (length > 0) {
+            component = Walk(FindRoot(segment, length),
+                    NextSegment(segment, length));
+        }
+    }
+
+    // Only successful resolutions are cached, as failing ones may
+    // succeed once the missing component is added.
+    if (component != NULL) {
+        Store(path, sender, hash, component);
+    }
+
+    return component;
+}
+
+::Smp::IComponent* Resolver::FindRoot(
+        const ::Smp::Char8* name,
+        size_t length)
+{
+    ::Smp::IComponent* root = this->m_rootsIndex.Find(name, length);
+
+    if (root != NULL) {
+        return root;
+    }
+
+    ::Smp::ISimulator* simulator =
+        dynamic_cast< ::Smp::ISimulator*>(this->m_parent);
+
+    if (simulator != NULL) {
+        const ::std::string rootName(name, length);
+
+        root = simulator->GetModel(rootName.c_str());
+
+        if (root == NULL) {
+            root = simulator->GetService(rootName.c_str());
+        }
+    }
+
+    return root;
+}
+
+::Smp::IComponent* Resolver::Walk(
+        ::Smp::IComponent* current,
+        const ::Smp::Char8* path)
+{
+    while (current != NULL) {
+        this->m_trail.push_back(current);
+
+        if (*path == '\0') {
+            break;
+        }
+
+        path = Step(current, path);
+
+        if (path == NULL) {
+            return NULL;
+        }
+
+        if (*path == RESOLVER_PATH_SEPARATOR) {
+            ++path;
+        }
+    }
+
+    return current;
+}
+
+const ::Smp::Char8* Resolver::Step(
+        ::Smp::IComponent*& current,
+        const ::Smp::Char8* path)
+{
+    size_t length = SegmentLength(path);
+
+    if ((length == 1) && (path[0] == '.')) {
+        return path + length;
+    }
+
+    if ((length == 2) && (path[0] == '.') && (path[1] == '.')) {
+        current = current->GetParent();
+        return (current != NULL) ? path + length : NULL;
+    }
+
+    if (length == 0) {
+        return NULL;
+    }
+
+    // The segment names either a container or a reference of the current
+    // component, and the next one a component in it.
+    ::Smp::IComposite* composite = this->m_compositeCast(current);
+    ::Smp::IContainer* container = (composite != NULL) ?
+        FindContainer(composite, path, length) : NULL;
+    ::Smp::IReference* reference = NULL;
+
+    if (container == NULL) {
+        ::Smp::IAggregate* aggregate = this->m_aggregateCast(current);
+
+        if (aggregate != NULL) {
+            reference = FindReference(aggregate, path, length);
+        }
+
+        if (reference == NULL) {
+            return NULL;
+        }
+    }
+
+    path = NextSegment(path, length);
+    length = SegmentLength(path);
+
+    if (length == 0) {
+        return NULL;
+    }
+
+    ::Smp::IComponent* child = (container != NULL) ?
+        FindComponent(container, path, length) :
+        FindComponent(reference, path, length);
+
+    if (child == NULL) {
+        return NULL;
+    }
+
+    current = child;
+
+    return path + length;
+}
+
+::Smp::IContainer* Resolver::FindContainer(
+        ::Smp::IComposite* composite,
+        const ::Smp::Char8* name,
+        size_t length)
+{
+    ::Smp::Mdk::Indexed< ::Smp::IContainer>* indexed =
+        this->m_mdkCompositeCast(composite);
+
+    if (indexed != NULL) {
+        return indexed->GetIndex().Find(name, length);
+    }
+
+    // Only composites other than Mdk ones need the segment copied.
+    const ::std::string containerName(name, length);
+
+    return composite->GetContainer(containerName.c_str());
+}
+
+::Smp::IComponent* Resolver::FindComponent(
+        ::Smp::IContainer* container,
+        const ::Smp::Char8* name,
+        size_t length)
+{
+    ::Smp::Mdk::Indexed< ::Smp::IComponent>* indexed =
+        this->m_mdkContainerCast(container);
+
+    if (indexed != NULL) {
+        return indexed->GetIndex().Find(name, length);
+    }
+
+    const ::std::string componentName(name, length);
+
+    return container->GetComponent(componentName.c_str());
+}
+
+::Smp::IReference* Resolver::FindReference(
+        ::Smp::IAggregate* aggregate,
+        const ::Smp::Char8* name,
+        size_t length)
+{
+    ::Smp::Mdk::Indexed< ::Smp::IReference>* indexed =
+        this->m_mdkAggregateCast(aggregate);
+
+    if (indexed != NULL) {
+        return indexed->GetIndex().Find(name, length);
+    }
+
+    const ::std::string referenceName(name, length);
+
+    return aggregate->GetReference(referenceName.c_str());
+}
+
+::Smp::IComponent* Resolver::FindComponent(
+        ::Smp::IReference* reference,
+        const ::Smp::Char8* name,
+        size_t length)
+{
+    ::Smp::Mdk::Indexed< ::Smp::IComponent>* indexed =
+        this->m_mdkReferenceCast(reference);
+
+    if (indexed != NULL) {
+        ::Smp::IComponent* component = indexed->GetIndex().Find(name, length);
+
+        if (component != NULL) {
+            return component;
+        }
+    }
+
+    // Providers renamed while referenced are only re-keyed by a lookup
+    // through GetComponent().
+    const ::std::string componentName(name, length);
+
+    return reference->GetComponent(componentName.c_str());
+}
+
+::Smp::UInt32 Resolver::Hash(
+        ::Smp::String8 path,
+        const ::Smp::IComponent* sender)
+{
+    const ::Smp::UInt32 hash =
+        ::Smp::Mdk::NameIndex< ::Smp::IComponent>::Hash(path);
+    const size_t address = reinterpret_cast< size_t>(sender);
+
+    return hash ^ static_cast< ::Smp::UInt32>((address >> 4) * 2654435761U);
+}
+
+::Smp::UInt32 Resolver::Lookup(
+        ::Smp::String8 path,
+        const ::Smp::IComponent* sender,
+        ::Smp::UInt32 hash)
+{
+    if (this->m_count == 0) {
+        return Resolver::NONE;
+    }
+
+    const ::Smp::UInt32 mask = this->m_buckets.size() - 1;
+    ::Smp::UInt32 i = this->m_buckets[hash & mask];
+
+    while (i != Resolver::NONE) {
+        const Entry& entry = this->m_entries[i];
+
+        if ((entry.hash == hash) && (entry.sender == sender) &&
+                (::strcmp(entry.path.c_str(), path) == 0)) {
+            if (i != this->m_newest) {
+                Unlink(i);
+                LinkNewest(i);
+            }
+
+            return i;
+        }
+
+        i = entry.nextInBucket;
+    }
+
+    return Resolver::NONE;
+}
+
+void Resolver::Store(
+        ::Smp::String8 path,
+        const ::Smp::IComponent* sender,
+        ::Smp::UInt32 hash,
+        ::Smp::IComponent* component)
+{
+    if (this->m_cacheSize == 0) {
+        return;
+    }
+
+    if (this->m_free == Resolver::NONE) {
+        Evict(this->m_oldest);
+    }
+
+    const ::Smp::UInt32 mask = this->m_buckets.size() - 1;
+    const ::Smp::UInt32 i = this->m_free;
+    Entry& entry = this->m_entries[i];
+
+    this->m_free = entry.nextInBucket;
+    ++this->m_count;
+
+    // Assigning reuses the storage of evicted entries when possible.
+    entry.path.assign(path);
+    entry.trail.assign(this->m_trail.begin(), this->m_trail.end());
+    entry.sender = sender;
+    entry.hash = hash;
+    entry.component = component;
+    entry.nextInBucket = this->m_buckets[hash & mask];
+    this->m_buckets[hash & mask] = i;
+
+    LinkNewest(i);
+}
+
+void Resolver::Evict(
+        ::Smp::UInt32 entry)
+{
+    const ::Smp::UInt32 mask = this->m_buckets.size() - 1;
+    Entry& e = this->m_entries[entry];
+
+    Unlink(entry);
+
+    // Take the entry out of the chain of its bucket.
+    ::Smp::UInt32* link = &(this->m_buckets[e.hash & mask]);
+
+    while (*link != entry) {
+        link = &(this->m_entries[*link].nextInBucket);
+    }
+    *link = e.nextInBucket;
+
+    e.nextInBucket = this->m_free;
+    this->m_free = entry;
+    --this->m_count;
+}
+
+void Resolver::Unlink(
+        ::Smp::UInt32 entry)
+{
+    Entry& e = this->m_entries[entry];
+
+    if (e.newer != Resolver::NONE) {
+        this->m_entries[e.newer].older = e.older;
+    } else {
+        this->m_newest = e.older;
+    }
+
+    if (e.older != Resolver::NONE) {
+        this->m_entries[e.older].newer = e.newer;
+    } else {
+        this->m_oldest = e.newer;
+    }
+}
+
+void Resolver::LinkNewest(
+        ::Smp::UInt32 entry)
+{
+    Entry& e = this->m_entries[entry];
+
+    e.newer = Resolver::NONE;
+    e.older = this->m_newest;
+
+    if (this->m_newest != Resolver::NONE) {
+        this->m_entries[this->m_newest].newer = entry;
+    } else {
+        this->m_oldest = entry;
+    }
+
+    this->m_newest = entry;
+}
@@ -0,0 +1,227 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_SERVICES_RESOLVER_H_
+#define MDK_SERVICES_RESOLVER_H_
+
+#include "Smp/Services/IResolver.h"
+#include "Smp/IComposite.h"
+#include "Smp/IAggregate.h"
+#include "Mdk/Component.h"
+#include "Mdk/HierarchyObserver.h"
+#include "Mdk/NameIndex.h"
+#include "Mdk/CachedCast.h"
+
+#include <string>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Services
+        {
+            /// Resolver service.
+            /// The component hierarchy is walked as a trie: every path
+            /// segment is looked up in place, through the index of the
+            /// composite, aggregate, container or reference it names a
+            /// child of, so resolution takes time proportional to the
+            /// depth of the path and no segment is copied.  Resolved paths
+            /// are kept in a least recently used cache, which makes
+            /// repeated resolutions constant time.  Every cached entry
+            /// records the components its resolution went through, and is
+            /// evicted only when one of them is reported changed by a
+            /// hierarchy notification.
+            ///
+            /// Absolute paths start with the name of a root component,
+            /// optionally preceded by '/'.  Roots are either registered
+            /// with AddRoot(), or models and services of the simulator
+            /// given as parent.  Relative paths start from the sender, and
+            /// may use "." and ".." to refer to a component and its parent.
+            class Resolver :
+                public ::Smp::Mdk::Component,
+                public virtual ::Smp::Services::IResolver,
+                public ::Smp::Mdk::HierarchyObserver
+            {
+                public:
+                    static const ::Smp::UInt32 DEFAULT_CACHE_SIZE = 256;
+
+                    typedef ::std::vector< ::Smp::String8> PathCollection;
+
+                    Resolver(
+                            ::Smp::String8 name,
+                            ::Smp::String8 description,
+                            ::Smp::IComposite* parent,
+                            ::Smp::UInt32 cacheSize = DEFAULT_CACHE_SIZE)
+                        throw (::Smp::InvalidObjectName);
+                    virtual ~Resolver(void);
+
+                    virtual ::Smp::IComponent* ResolveAbsolute(
+                            ::Smp::String8 absolutePath);
+
+                    virtual ::Smp::IComponent* ResolveRelative(
+                            ::Smp::String8 relativePath,
+                            ::Smp::IComponent* sender);
+
+                    /// Resolve many absolute paths at once, such as those
+                    /// of a configuration.  The paths are sorted, so that
+                    /// the prefix shared by consecutive paths is walked
+                    /// only once.  The cache is neither used nor filled.
+                    /// @param paths Absolute paths to resolve.
+                    /// @param components Components identified by the
+                    ///        paths, in the same order, or NULL for invalid
+                    ///        paths.
+                    void ResolveAll(
+                            const PathCollection& paths,
+                            ::Smp::ComponentCollection& components);
+
+                    /// Make a component resolvable as the first segment of
+                    /// absolute paths.
+                    void AddRoot(
+                            ::Smp::IComponent* root)
+                        throw (::Smp::DuplicateName);
+
+                    /// Forget all the resolved paths.
+                    void ClearCache(void);
+
+                    /// Evict the resolved paths going through component,
+                    /// or all of them if component is NULL.
+                    virtual void OnHierarchyChanged(
+                            const ::Smp::IComponent* component);
+
+                    /// Evict, in a single pass, the resolved paths going
+                    /// through composite or any of the given components.
+                    virtual void OnComponentsChanged(
+                            const ::Smp::IComposite* composite,
+                            ::Smp::ComponentCollection::const_iterator first,
+                            ::Smp::ComponentCollection::const_iterator last);
+
+                    ::Smp::UInt32 GetCacheSize(void) const;
+
+                    /// Number of resolved paths currently cached.
+                    ::Smp::UInt32 GetCachedCount(void) const;
+
+                private:
+                    static const ::Smp::UInt32 NONE = 0xFFFFFFFFU;
+
+                    typedef ::std::vector< const ::Smp::IComponent*> ComponentTrail;
+
+                    struct Entry
+                    {
+                        ::std::string path;
+                        ComponentTrail trail;
+                        const ::Smp::IComponent* sender;
+                        ::Smp::UInt32 hash;
+                        ::Smp::IComponent* component;
+                        ::Smp::UInt32 newer;
+                        ::Smp::UInt32 older;
+                        ::Smp::UInt32 nextInBucket;
+                    };
+
+                    typedef ::std::vector< Entry> EntryCollection;
+                    typedef ::std::vector< ::Smp::UInt32> BucketCollection;
+
+                    ::Smp::IComponent* Resolve(
+                            ::Smp::String8 path,
+                            ::Smp::IComponent* sender);
+
+                    ::Smp::IComponent* FindRoot(
+                            const ::Smp::Char8* name,
+                            size_t length);
+
+                    ::Smp::IComponent* Walk(
+                            ::Smp::IComponent* current,
+                            const ::Smp::Char8* path);
+
+                    /// Walk down a single segment, or a container or
+                    /// reference segment and the component segment after
+                    /// it.
+                    /// @return End of the last segment walked, or NULL if
+                    ///         the path is invalid.
+                    const ::Smp::Char8* Step(
+                            ::Smp::IComponent*& current,
+                            const ::Smp::Char8* path);
+
+                    ::Smp::IContainer* FindContainer(
+                            ::Smp::IComposite* composite,
+                            const ::Smp::Char8* name,
+                            size_t length);
+
+                    ::Smp::IComponent* FindComponent(
+                            ::Smp::IContainer* container,
+                            const ::Smp::Char8* name,
+                            size_t length);
+
+                    ::Smp::IReference* FindReference(
+                            ::Smp::IAggregate* aggregate,
+                            const ::Smp::Char8* name,
+                            size_t length);
+
+                    ::Smp::IComponent* FindComponent(
+                            ::Smp::IReference* reference,
+                            const ::Smp::Char8* name,
+                            size_t length);
+
+                    static ::Smp::UInt32 Hash(
+                            ::Smp::String8 path,
+                            const ::Smp::IComponent* sender);
+
+                    ::Smp::UInt32 Lookup(
+                            ::Smp::String8 path,
+                            const ::Smp::IComponent* sender,
+                            ::Smp::UInt32 hash);
+
+                    void Store(
+                            ::Smp::String8 path,
+                            const ::Smp::IComponent* sender,
+                            ::Smp::UInt32 hash,
+                            ::Smp::IComponent* component);
+
+                    void Evict(
+                            ::Smp::UInt32 entry);
+
+                    void Unlink(
+                            ::Smp::UInt32 entry);
+
+                    void LinkNewest(
+                            ::Smp::UInt32 entry);
+
+                    ::Smp::Mdk::NameIndex< ::Smp::IComponent> m_rootsIndex;
+                    ::Smp::ComponentCollection m_roots;
+
+                    EntryCollection m_entries;
+                    BucketCollection m_buckets;
+                    ::Smp::UInt32 m_cacheSize;
+                    ::Smp::UInt32 m_count;
+                    ::Smp::UInt32 m_newest;
+                    ::Smp::UInt32 m_oldest;
+                    ::Smp::UInt32 m_free;
+                    ComponentTrail m_trail;
+
+                    ::Smp::Mdk::CachedCast< ::Smp::IComponent, ::Smp::IComposite> m_compositeCast;
+                    ::Smp::Mdk::CachedCast< ::Smp::IComposite, ::Smp::Mdk::Indexed< ::Smp::IContainer> > m_mdkCompositeCast;
+                    ::Smp::Mdk::CachedCast< ::Smp::IContainer, ::Smp::Mdk::Indexed< ::Smp::IComponent> > m_mdkContainerCast;
+                    ::Smp::Mdk::CachedCast< ::Smp::IComponent, ::Smp::IAggregate> m_aggregateCast;
+                    ::Smp::Mdk::CachedCast< ::Smp::IAggregate, ::Smp::Mdk::Indexed< ::Smp::IReference> > m_mdkAggregateCast;
+                    ::Smp::Mdk::CachedCast< ::Smp::IReference, ::Smp::Mdk::Indexed< ::Smp::IComponent> > m_mdkReferenceCast;
+            };
+        }
+    }
+}
+
+#endif  // MDK_SERVICES_RESOLVER_H_
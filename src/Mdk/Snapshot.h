@@ -0,0 +1,259 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_SNAPSHOT_H_
+#define MDK_SNAPSHOT_H_
+
+#include "Smp/SimpleTypes.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// Versioned, copy-on-write value shared between one writer and
+        /// any number of reader threads.
+        /// The writer publishes a new immutable version of the value with
+        /// Publish().  Readers take a Snapshot of the current version with
+        /// Acquire(), which never blocks and never sees a partially updated
+        /// value.  Every version is reference counted and freed when the
+        /// last snapshot of it goes away.
+        ///
+        /// A replaced version cannot be released by Publish() while a
+        /// reader may have loaded it without having taken its reference
+        /// yet.  Readers announce themselves on one of two counters, the
+        /// one of the current epoch.  A replaced version is retired, and
+        /// released once both counters have been seen at zero after its
+        /// retirement.  Publish() flips the epoch every time the counter of
+        /// the previous epoch has drained, so that new readers never keep
+        /// it busy.  Neither readers nor the writer ever wait; retired
+        /// versions are released by a later Publish(), or on destruction.
+        /// Publish() is not reentrant: writers must be serialised by the
+        /// caller.
+        template < typename V> class SnapshotCell
+        {
+            public:
+                class Snapshot;
+
+            private:
+                friend class Snapshot;
+
+                struct Version
+                {
+                    Version(
+                            const V& _value,
+                            ::Smp::UInt64 _number) :
+                        value(_value),
+                        number(_number),
+                        refs(1)
+                    {
+                    }
+
+                    const V value;
+                    const ::Smp::UInt64 number;
+                    long refs;
+                };
+
+                static void Release(
+                        Version* version)
+                {
+                    if (__atomic_sub_fetch(&version->refs, 1, __ATOMIC_ACQ_REL) == 0)
+                    {
+                        delete version;
+                    }
+                }
+
+            public:
+                /// Reference to one version of the value.
+                class Snapshot
+                {
+                    public:
+                        Snapshot(
+                                const Snapshot& other) :
+                            m_version(other.m_version)
+                        {
+                            __atomic_add_fetch(&this->m_version->refs, 1, __ATOMIC_RELAXED);
+                        }
+
+                        ~Snapshot(void)
+                        {
+                            Release(this->m_version);
+                        }
+
+                        Snapshot& operator= (
+                                const Snapshot& other)
+                        {
+                            if (this->m_version != other.m_version)
+                            {
+                                __atomic_add_fetch(&other.m_version->refs, 1, __ATOMIC_RELAXED);
+                                Release(this->m_version);
+                                this->m_version = other.m_version;
+                            }
+
+                            return *this;
+                        }
+
+                        const V& operator* (void) const
+                        {
+                            return this->m_version->value;
+                        }
+
+                        const V* operator-> (void) const
+                        {
+                            return &this->m_version->value;
+                        }
+
+                        /// Version number, increased by every Publish().
+                        ::Smp::UInt64 GetVersion(void) const
+                        {
+                            return this->m_version->number;
+                        }
+
+                    private:
+                        friend class SnapshotCell;
+
+                        /// Adopts a reference already taken on version.
+                        explicit Snapshot(
+                                Version* version) :
+                            m_version(version)
+                        {
+                        }
+
+                        Version* m_version;
+                };
+
+                SnapshotCell(void) :
+                    m_current(new Version(V(), 0)),
+                    m_epoch(0)
+                {
+                    this->m_readers[0] = 0;
+                    this->m_readers[1] = 0;
+                }
+
+                ~SnapshotCell(void)
+                {
+                    for (size_t i = 0; i < this->m_retired.size(); ++i)
+                    {
+                        Release(this->m_retired[i].version);
+                    }
+
+                    Release(this->m_current);
+                }
+
+                Snapshot Acquire(void) const
+                {
+                    // Announcing the reader before loading the current
+                    // version lets Publish() know when no reader can still
+                    // be about to take a reference on a retired version.
+                    const unsigned int epoch = __atomic_load_n(&this->m_epoch, __ATOMIC_SEQ_CST);
+                    __atomic_add_fetch(&this->m_readers[epoch], 1, __ATOMIC_SEQ_CST);
+                    Version* version = __atomic_load_n(&this->m_current, __ATOMIC_SEQ_CST);
+                    __atomic_add_fetch(&version->refs, 1, __ATOMIC_RELAXED);
+                    __atomic_sub_fetch(&this->m_readers[epoch], 1, __ATOMIC_RELEASE);
+
+                    return Snapshot(version);
+                }
+
+                void Publish(
+                        const V& value)
+                {
+                    Version* version = new Version(value, this->m_current->number + 1);
+
+                    Retired retired;
+                    retired.version = __atomic_exchange_n(&this->m_current, version, __ATOMIC_SEQ_CST);
+                    retired.pending = 3;
+                    this->m_retired.push_back(retired);
+
+                    // New readers announce themselves in the current epoch,
+                    // so the counter of the previous one drains.
+                    const unsigned int epoch = this->m_epoch;
+                    const unsigned int previous = 1 - epoch;
+
+                    if (__atomic_load_n(&this->m_readers[previous], __ATOMIC_SEQ_CST) == 0)
+                    {
+                        Drained(previous);
+                        __atomic_store_n(&this->m_epoch, previous, __ATOMIC_SEQ_CST);
+                    }
+
+                    // The current epoch may happen to be idle too.
+                    if (__atomic_load_n(&this->m_readers[epoch], __ATOMIC_SEQ_CST) == 0)
+                    {
+                        Drained(epoch);
+                    }
+                }
+
+                /// Number of replaced versions not released yet.
+                size_t GetRetiredCount(void) const
+                {
+                    return this->m_retired.size();
+                }
+
+                ::Smp::UInt64 GetVersion(void) const
+                {
+                    return __atomic_load_n(&this->m_current, __ATOMIC_ACQUIRE)->number;
+                }
+
+            private:
+                SnapshotCell(
+                        const SnapshotCell&);
+                SnapshotCell& operator= (
+                        const SnapshotCell&);
+
+                struct Retired
+                {
+                    Version* version;
+                    /// Bit i is set until counter i has been seen at zero.
+                    unsigned int pending;
+                };
+
+                /// Counter epoch was seen at zero: release the versions
+                /// retired before that which no reader can be loading.
+                void Drained(
+                        unsigned int epoch)
+                {
+                    size_t kept = 0;
+
+                    for (size_t i = 0; i < this->m_retired.size(); ++i)
+                    {
+                        Retired& retired = this->m_retired[i];
+                        retired.pending &= ~(1U << epoch);
+
+                        if (retired.pending == 0)
+                        {
+                            Release(retired.version);
+                        }
+                        else
+                        {
+                            this->m_retired[kept++] = retired;
+                        }
+                    }
+
+                    this->m_retired.resize(kept);
+                }
+
+                Version* m_current;
+                mutable long m_readers[2];
+                unsigned int m_epoch;
+                ::std::vector< Retired> m_retired;
+        };
+    }
+}
+
+#endif  // MDK_SNAPSHOT_H_
@@ -0,0 +1,86 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/StateTable.h"
+
+using namespace ::Smp::Mdk;
+
+StateTable::StateTable(
+        ::Smp::UInt32 columnCount) :
+    m_columns(columnCount),
+    m_rowCount(0)
+{
+}
+
+StateTable::~StateTable(void)
+{
+}
+
+::Smp::UInt32 StateTable::GetColumnCount(void) const
+{
+    return this->m_columns.size();
+}
+
+::Smp::UInt32 StateTable::GetRowCount(void) const
+{
+    return this->m_rowCount;
+}
+
+::Smp::UInt32 StateTable::AddRow(void)
+{
+    for (::std::vector< ColumnData>::iterator it(this->m_columns.begin());
+            it != this->m_columns.end();
+            ++it) {
+        it->push_back(0.0);
+    }
+
+    return this->m_rowCount++;
+}
+
+void StateTable::Reserve(
+        ::Smp::UInt32 rowCount)
+{
+    for (::std::vector< ColumnData>::iterator it(this->m_columns.begin());
+            it != this->m_columns.end();
+            ++it) {
+        it->reserve(rowCount);
+    }
+}
+
+void StateTable::Clear(void)
+{
+    for (::std::vector< ColumnData>::iterator it(this->m_columns.begin());
+            it != this->m_columns.end();
+            ++it) {
+        it->clear();
+    }
+
+    this->m_rowCount = 0;
+}
+
+::Smp::Float64* StateTable::Column(
+        ::Smp::UInt32 column)
+{
+    return (this->m_rowCount > 0) ? &this->m_columns[column][0] : NULL;
+}
+
+const ::Smp::Float64* StateTable::Column(
+        ::Smp::UInt32 column) const
+{
+    return (this->m_rowCount > 0) ? &this->m_columns[column][0] : NULL;
+}
@@ -0,0 +1,82 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STATETABLE_H_
+#define MDK_STATETABLE_H_
+
+#include "Smp/SimpleTypes.h"
+
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        /// State of a population of identical models, stored as structure
+        /// of arrays: one contiguous column of Float64 per state variable,
+        /// and one row per model.
+        class StateTable
+        {
+            public:
+                explicit StateTable(
+                        ::Smp::UInt32 columnCount);
+                ~StateTable(void);
+
+                ::Smp::UInt32 GetColumnCount(void) const;
+                ::Smp::UInt32 GetRowCount(void) const;
+
+                /// Add a row with all its values set to zero.
+                /// @return Index of the new row.
+                ::Smp::UInt32 AddRow(void);
+
+                void Reserve(
+                        ::Smp::UInt32 rowCount);
+
+                void Clear(void);
+
+                /// Values of a column, GetRowCount() of them.  Adding rows
+                /// may move the column, so the pointer must not be kept.
+                ::Smp::Float64* Column(
+                        ::Smp::UInt32 column);
+                const ::Smp::Float64* Column(
+                        ::Smp::UInt32 column) const;
+
+                ::Smp::Float64& At(
+                        ::Smp::UInt32 column,
+                        ::Smp::UInt32 row)
+                {
+                    return this->m_columns[column][row];
+                }
+
+                ::Smp::Float64 At(
+                        ::Smp::UInt32 column,
+                        ::Smp::UInt32 row) const
+                {
+                    return this->m_columns[column][row];
+                }
+
+            private:
+                typedef ::std::vector< ::Smp::Float64> ColumnData;
+
+                ::std::vector< ColumnData> m_columns;
+                ::Smp::UInt32 m_rowCount;
+        };
+    }
+}
+
+#endif  // MDK_STATETABLE_H_
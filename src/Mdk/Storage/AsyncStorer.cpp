@@ -0,0 +1,176 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/AsyncStorer.h"
+#include "Mdk/Storage/ChunkedStorage.h"
+#include "Mdk/Storage/FileStorageWriter.h"
+
+#include <string.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+AsyncStorer::AsyncStorer(
+        ::Smp::Services::IEventManager* eventManager) :
+    m_eventManager(eventManager),
+    m_pending(false),
+    m_done(0),
+    m_writing(NULL)
+{
+}
+
+AsyncStorer::~AsyncStorer(void)
+{
+    try {
+        Wait();
+    } catch (::Smp::IPersist::CannotStore&) {
+    }
+}
+
+void AsyncStorer::Add(
+        ::Smp::IPersist* component)
+{
+    if (component != NULL) {
+        this->m_components.push_back(component);
+    }
+}
+
+void AsyncStorer::Begin(
+        ::Smp::String8 filename)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (filename == NULL) {
+        throw ::Smp::IPersist::CannotStore("no file name");
+    }
+
+    // The previous store leaves before the next one enters.  If it failed,
+    // its error is reported and the new store is not started.
+    Wait();
+
+    Emit(::Smp::Services::SMP_EnterStoringId);
+
+    this->m_buffer.Clear();
+
+    try {
+        for (ComponentCollection::const_iterator it(this->m_components.begin());
+                it != this->m_components.end();
+                ++it) {
+            (*it)->Store(&this->m_buffer);
+        }
+    } catch (...) {
+        Emit(::Smp::Services::SMP_LeaveStoringId);
+        throw;
+    }
+
+    this->m_writing = &this->m_buffer;
+    this->m_filename = filename;
+    this->m_error.clear();
+    __atomic_store_n(&this->m_done, 0, __ATOMIC_RELAXED);
+
+    if (pthread_create(&this->m_thread, NULL, &AsyncStorer::Run, this) != 0) {
+        // Write in the foreground rather than not at all.
+        Write();
+        this->m_pending = false;
+        Complete();
+        return;
+    }
+
+    this->m_pending = true;
+}
+
+::Smp::Bool AsyncStorer::Poll(void)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (!this->m_pending) {
+        return true;
+    }
+
+    if (__atomic_load_n(&this->m_done, __ATOMIC_ACQUIRE) == 0) {
+        return false;
+    }
+
+    Wait();
+
+    return true;
+}
+
+void AsyncStorer::Wait(void)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (!this->m_pending) {
+        return;
+    }
+
+    pthread_join(this->m_thread, NULL);
+    this->m_pending = false;
+
+    Complete();
+}
+
+::Smp::Bool AsyncStorer::IsPending(void) const
+{
+    return this->m_pending;
+}
+
+void* AsyncStorer::Run(
+        void* storer)
+{
+    AsyncStorer* self = static_cast< AsyncStorer*>(storer);
+
+    self->Write();
+    __atomic_store_n(&self->m_done, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+void AsyncStorer::Write(void)
+{
+    try {
+        FileStorageWriter writer(this->m_filename.c_str());
+
+        ChunkedStorage::Store(&writer, this->m_writing->GetData(), this->m_writing->GetSize());
+
+        writer.Sync();
+        writer.Close();
+    } catch (::Smp::IPersist::CannotStore& ex) {
+        this->m_error = (ex.message != NULL) ? ex.message : "cannot write file";
+    } catch (...) {
+        // Nothing may escape the background thread.
+        this->m_error = "cannot write file";
+    }
+}
+
+void AsyncStorer::Complete(void)
+    throw (::Smp::IPersist::CannotStore)
+{
+    this->m_writing = NULL;
+
+    // Leave is emitted whether the store succeeded or not.
+    Emit(::Smp::Services::SMP_LeaveStoringId);
+
+    if (!this->m_error.empty()) {
+        throw ::Smp::IPersist::CannotStore(this->m_error.c_str());
+    }
+}
+
+void AsyncStorer::Emit(
+        ::Smp::Services::EventId event)
+{
+    if (this->m_eventManager != NULL) {
+        this->m_eventManager->Emit(event);
+    }
+}
@@ -0,0 +1,132 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_ASYNCSTORER_H_
+#define MDK_STORAGE_ASYNCSTORER_H_
+
+#include "Smp/IPersist.h"
+#include "Smp/Services/IEventManager.h"
+#include "Mdk/Storage/MemoryStorageWriter.h"
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Store of persistent components that does not wait for the
+            /// file to be written.  Begin() captures the state of the
+            /// components in memory, which only costs a copy, and hands
+            /// the capture to a background thread that writes and syncs
+            /// the file while the simulation goes on.
+            ///
+            /// Begin() emits SMP_EnterStoringId, and SMP_LeaveStoringId is
+            /// emitted once the file is on disk or the store has failed, so
+            /// every Enter is followed by its Leave before the next Enter.
+            /// Both are emitted on the thread calling Begin(), Poll() or
+            /// Wait(), never on the background thread, as entry points are
+            /// not expected to be called concurrently with the simulation.
+            ///
+            /// Stores are single-flight: there is one capture buffer, and
+            /// at most one store is written at a time.  Begin() while a
+            /// store is pending blocks until that store has been written
+            /// and synced.  To never block the simulation, call Poll()
+            /// until it returns true before calling Begin() again, and
+            /// skip or delay the next store meanwhile.
+            class AsyncStorer
+            {
+                public:
+                    explicit AsyncStorer(
+                            ::Smp::Services::IEventManager* eventManager = NULL);
+
+                    /// Wait for the pending store, ignoring errors.
+                    ~AsyncStorer(void);
+
+                    /// Add a component to the stores.  Components are
+                    /// stored in the order they are added.
+                    void Add(
+                            ::Smp::IPersist* component);
+
+                    /// Capture the state of the components and start
+                    /// writing it to filename in the background.  If a store
+                    /// is pending, blocks until it has been written first,
+                    /// as stores are single-flight.  If the previous store
+                    /// failed, its error is thrown and this store is not
+                    /// started: nothing is captured and no event emitted,
+                    /// so Begin() can simply be called again.
+                    /// @throw ::Smp::IPersist::CannotStore if a component
+                    ///        cannot be stored, or the previous store
+                    ///        failed.
+                    void Begin(
+                            ::Smp::String8 filename)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Complete the pending store if it has been written.
+                    /// @return true if there is no store pending anymore.
+                    /// @throw ::Smp::IPersist::CannotStore if the store
+                    ///        that completed failed.
+                    ::Smp::Bool Poll(void)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Wait for the pending store to be written.
+                    /// @throw ::Smp::IPersist::CannotStore if it failed.
+                    void Wait(void)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    ::Smp::Bool IsPending(void) const;
+
+                private:
+                    AsyncStorer(
+                            const AsyncStorer&);
+                    AsyncStorer& operator= (
+                            const AsyncStorer&);
+
+                    typedef ::std::vector< ::Smp::IPersist*> ComponentCollection;
+
+                    static void* Run(
+                            void* storer);
+
+                    void Write(void);
+
+                    void Complete(void)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    void Emit(
+                            ::Smp::Services::EventId event);
+
+                    ComponentCollection m_components;
+                    ::Smp::Services::IEventManager* m_eventManager;
+                    ::Smp::Mdk::Storage::MemoryStorageWriter m_buffer;
+
+                    // State of the pending store, shared with the thread.
+                    pthread_t m_thread;
+                    ::Smp::Bool m_pending;
+                    int m_done;
+                    const ::Smp::Mdk::Storage::MemoryStorageWriter* m_writing;
+                    ::std::string m_filename;
+                    ::std::string m_error;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_ASYNCSTORER_H_
@@ -0,0 +1,221 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/CheckpointRing.h"
+#include "Mdk/Storage/MemoryStorageReader.h"
+
+using namespace ::Smp::Mdk::Storage;
+
+CheckpointRing::CheckpointRing(
+        ::Smp::String8 name,
+        size_t capacity,
+        ::Smp::Duration interval)
+    throw (::Smp::InvalidObjectName) :
+        Component(name, "Ring of in-memory snapshots", NULL),
+        m_snapshots((capacity > 0) ? capacity : 1),
+        m_spare(new Snapshot()),
+        m_first(0),
+        m_count(0),
+        m_interval(interval),
+        m_timeKeeper(NULL),
+        m_failedCount(0),
+        m_take("Take", "Take a snapshot", this, &CheckpointRing::TakeNow)
+{
+    for (size_t i = 0; i < this->m_snapshots.size(); ++i) {
+        this->m_snapshots[i] = new Snapshot();
+        this->m_snapshots[i]->time = 0;
+    }
+
+    this->m_spare->time = 0;
+}
+
+CheckpointRing::~CheckpointRing(void)
+{
+    for (size_t i = 0; i < this->m_snapshots.size(); ++i) {
+        delete this->m_snapshots[i];
+    }
+
+    delete this->m_spare;
+}
+
+void CheckpointRing::Add(
+        ::Smp::IPersist* component)
+{
+    if (component != NULL) {
+        this->m_components.push_back(component);
+    }
+}
+
+void CheckpointRing::Take(
+        ::Smp::Duration time)
+    throw (::Smp::IPersist::CannotStore)
+{
+    size_t count = this->m_count;
+
+    while ((count > 0) && (GetSnapshot(count - 1).time > time)) {
+        --count;
+    }
+
+    // Store into the spare snapshot, so that the ring is left as it was if
+    // a component cannot be stored.
+    Snapshot* taken = this->m_spare;
+    taken->buffer.Clear();
+
+    for (ComponentCollection::const_iterator it(this->m_components.begin());
+            it != this->m_components.end();
+            ++it) {
+        (*it)->Store(&taken->buffer);
+    }
+
+    taken->time = time;
+
+    size_t slot;
+
+    if (count == this->m_snapshots.size()) {
+        // Replace the oldest snapshot, whose buffer becomes the spare.
+        slot = this->m_first;
+        this->m_first = (this->m_first + 1) % this->m_snapshots.size();
+    } else {
+        slot = (this->m_first + count) % this->m_snapshots.size();
+        ++count;
+    }
+
+    this->m_spare = this->m_snapshots[slot];
+    this->m_snapshots[slot] = taken;
+    this->m_count = count;
+}
+
+::Smp::Bool CheckpointRing::Update(
+        ::Smp::Duration time)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if ((this->m_count > 0) &&
+            (time < (GetSnapshot(this->m_count - 1).time + this->m_interval))) {
+        return false;
+    }
+
+    Take(time);
+
+    return true;
+}
+
+::Smp::Services::EventId CheckpointRing::Schedule(
+        ::Smp::Services::IScheduler* scheduler,
+        ::Smp::Services::ITimeKeeper* timeKeeper,
+        ::Smp::Duration start)
+{
+    this->m_timeKeeper = timeKeeper;
+
+    return scheduler->AddSimulationTimeEvent(&this->m_take, start, this->m_interval, -1);
+}
+
+::Smp::Duration CheckpointRing::Rollback(
+        ::Smp::Duration time,
+        Replayer* replayer)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    size_t count = this->m_count;
+
+    while ((count > 0) && (GetSnapshot(count - 1).time > time)) {
+        --count;
+    }
+
+    if (count == 0) {
+        throw ::Smp::IPersist::CannotRestore("no snapshot before time");
+    }
+
+    const Snapshot& snapshot = GetSnapshot(count - 1);
+    MemoryStorageReader reader(snapshot.buffer.GetData(), snapshot.buffer.GetSize());
+
+    for (ComponentCollection::const_iterator it(this->m_components.begin());
+            it != this->m_components.end();
+            ++it) {
+        (*it)->Restore(&reader);
+    }
+
+    if (reader.GetRemaining() != 0) {
+        throw ::Smp::IPersist::CannotRestore("snapshot larger than state");
+    }
+
+    this->m_count = count;
+
+    if ((replayer != NULL) && (snapshot.time < time)) {
+        replayer->Replay(snapshot.time, time);
+    }
+
+    return snapshot.time;
+}
+
+void CheckpointRing::Clear(void)
+{
+    this->m_first = 0;
+    this->m_count = 0;
+}
+
+const ::Smp::IEntryPoint* CheckpointRing::GetTakeEntryPoint(void) const
+{
+    return &this->m_take;
+}
+
+size_t CheckpointRing::GetFailedCount(void) const
+{
+    return this->m_failedCount;
+}
+
+::Smp::String8 CheckpointRing::GetLastError(void) const
+{
+    return (this->m_failedCount > 0) ? this->m_lastError.c_str() : NULL;
+}
+
+size_t CheckpointRing::GetCapacity(void) const
+{
+    return this->m_snapshots.size();
+}
+
+size_t CheckpointRing::GetCount(void) const
+{
+    return this->m_count;
+}
+
+::Smp::Duration CheckpointRing::GetTime(
+        size_t snapshot) const
+{
+    return this->m_snapshots[(this->m_first + snapshot) % this->m_snapshots.size()]->time;
+}
+
+void CheckpointRing::TakeNow(void)
+{
+    if (this->m_timeKeeper == NULL) {
+        return;
+    }
+
+    // Nothing may be thrown through the scheduler; the ring is left as it
+    // was and the next scheduled snapshot is tried as usual.
+    try {
+        Take(this->m_timeKeeper->GetSimulationTime());
+    } catch (::Smp::IPersist::CannotStore& ex) {
+        ++this->m_failedCount;
+        this->m_lastError = (ex.message != NULL) ? ex.message : "cannot store";
+    }
+}
+
+CheckpointRing::Snapshot& CheckpointRing::GetSnapshot(
+        size_t snapshot)
+{
+    return *this->m_snapshots[(this->m_first + snapshot) % this->m_snapshots.size()];
+}
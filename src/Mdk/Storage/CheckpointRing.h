@@ -0,0 +1,179 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_CHECKPOINTRING_H_
+#define MDK_STORAGE_CHECKPOINTRING_H_
+
+#include "Smp/IPersist.h"
+#include "Smp/Services/IScheduler.h"
+#include "Smp/Services/ITimeKeeper.h"
+#include "Mdk/Component.h"
+#include "Mdk/EntryPoint.h"
+#include "Mdk/Storage/MemoryStorageWriter.h"
+
+#include <string>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Ring of the last snapshots of a set of persistent
+            /// components, kept in memory.  Snapshots are taken every
+            /// interval of simulation time, either by calling Update() or
+            /// by scheduling the Take entry point; once the ring is full,
+            /// the oldest snapshot is replaced, and its buffer reused.  A
+            /// snapshot is taken into a spare buffer, so that the ring is
+            /// left untouched when a component cannot be stored.  Failures
+            /// of scheduled snapshots are counted rather than thrown
+            /// through the scheduler.
+            ///
+            /// Rollback() restores the closest snapshot at or before a
+            /// given time and discards the snapshots after it, as they
+            /// belong to a timeline that is being rewritten.  Re-running
+            /// the simulation from the snapshot up to the target time is
+            /// left to a Replayer, as the scheduler has no way to run up to
+            /// a given time.
+            class CheckpointRing :
+                public ::Smp::Mdk::Component
+            {
+                public:
+                    /// Runs the simulation forward after a rollback.
+                    class Replayer
+                    {
+                        public:
+                            virtual ~Replayer(void)
+                            {
+                            }
+
+                            /// Run the simulation from the time of the
+                            /// restored snapshot up to the target time.
+                            virtual void Replay(
+                                    ::Smp::Duration from,
+                                    ::Smp::Duration to) = 0;
+                    };
+
+                    CheckpointRing(
+                            ::Smp::String8 name,
+                            size_t capacity,
+                            ::Smp::Duration interval)
+                        throw (::Smp::InvalidObjectName);
+                    virtual ~CheckpointRing(void);
+
+                    /// Add a component to the snapshots.  Components are
+                    /// stored and restored in the order they are added.
+                    void Add(
+                            ::Smp::IPersist* component);
+
+                    /// Take a snapshot at the given simulation time.
+                    /// Snapshots after that time are discarded, once it has
+                    /// been taken.
+                    void Take(
+                            ::Smp::Duration time)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Take a snapshot if interval has elapsed since the
+                    /// newest one.
+                    /// @return true if a snapshot was taken.
+                    ::Smp::Bool Update(
+                            ::Smp::Duration time)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Schedule the Take entry point every interval of
+                    /// simulation time from start, with the simulation time
+                    /// read from timeKeeper.
+                    /// @return Identifier of the scheduler event.
+                    ::Smp::Services::EventId Schedule(
+                            ::Smp::Services::IScheduler* scheduler,
+                            ::Smp::Services::ITimeKeeper* timeKeeper,
+                            ::Smp::Duration start = 0);
+
+                    /// Restore the newest snapshot taken at or before time,
+                    /// discard the snapshots after it, and have replayer
+                    /// run the simulation up to time.
+                    /// @return Time of the snapshot restored.
+                    /// @throw ::Smp::IPersist::CannotRestore if there is no
+                    ///        such snapshot.
+                    ::Smp::Duration Rollback(
+                            ::Smp::Duration time,
+                            Replayer* replayer = NULL)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    /// Discard all the snapshots.
+                    void Clear(void);
+
+                    /// Entry point taking a snapshot at the current
+                    /// simulation time, once scheduled.
+                    const ::Smp::IEntryPoint* GetTakeEntryPoint(void) const;
+
+                    /// Number of snapshots the Take entry point failed to
+                    /// take.
+                    size_t GetFailedCount(void) const;
+
+                    /// Error of the last snapshot the Take entry point
+                    /// failed to take, or NULL if there is none.
+                    ::Smp::String8 GetLastError(void) const;
+
+                    size_t GetCapacity(void) const;
+
+                    /// Number of snapshots kept.
+                    size_t GetCount(void) const;
+
+                    /// Time of the given snapshot, from the oldest (0) to
+                    /// the newest (GetCount() - 1).
+                    ::Smp::Duration GetTime(
+                            size_t snapshot) const;
+
+                private:
+                    CheckpointRing(
+                            const CheckpointRing&);
+                    CheckpointRing& operator= (
+                            const CheckpointRing&);
+
+                    typedef ::std::vector< ::Smp::IPersist*> ComponentCollection;
+
+                    struct Snapshot
+                    {
+                        ::Smp::Duration time;
+                        ::Smp::Mdk::Storage::MemoryStorageWriter buffer;
+                    };
+
+                    void TakeNow(void);
+
+                    Snapshot& GetSnapshot(
+                            size_t snapshot);
+
+                    ComponentCollection m_components;
+                    ::std::vector< Snapshot*> m_snapshots;
+                    /// Buffer the next snapshot is taken into.
+                    Snapshot* m_spare;
+                    size_t m_first;
+                    size_t m_count;
+                    ::Smp::Duration m_interval;
+                    ::Smp::Services::ITimeKeeper* m_timeKeeper;
+                    size_t m_failedCount;
+                    ::std::string m_lastError;
+                    ::Smp::Mdk::EntryPoint m_take;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_CHECKPOINTRING_H_
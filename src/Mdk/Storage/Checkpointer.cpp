@@ -0,0 +1,284 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/Checkpointer.h"
+#include "Mdk/Storage/MemoryStorageReader.h"
+
+#include <string.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+const size_t Checkpointer::DEFAULT_BLOCK_SIZE;
+
+namespace
+{
+    const ::Smp::UInt32 CHECKPOINT_MAGIC = 0x4B434D53U;  // "SMCK"
+
+    enum CheckpointKind
+    {
+        CHECKPOINT_FULL = 0,
+        CHECKPOINT_DELTA = 1
+    };
+
+    /// Header stored in front of every checkpoint.  It is followed by the
+    /// index and the data of each block stored.
+    struct CheckpointHeader
+    {
+        ::Smp::UInt32 magic;
+        ::Smp::UInt32 kind;
+        ::Smp::UInt64 imageSize;
+        ::Smp::UInt32 blockSize;
+        ::Smp::UInt32 blockCount;
+    };
+}
+
+Checkpointer::Checkpointer(
+        size_t blockSize) :
+    m_blockSize((blockSize > 0) ? blockSize : DEFAULT_BLOCK_SIZE),
+    m_hasImage(false)
+{
+}
+
+Checkpointer::~Checkpointer(void)
+{
+}
+
+void Checkpointer::Add(
+        ::Smp::IPersist* component)
+{
+    if (component != NULL) {
+        this->m_components.push_back(component);
+        Reset();
+    }
+}
+
+::Smp::UInt32 Checkpointer::Checkpoint(
+        ::Smp::IStorageWriter* writer,
+        ::Smp::Bool full)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (writer == NULL) {
+        throw ::Smp::IPersist::CannotStore("no storage writer");
+    }
+
+    full = full || !this->m_hasImage;
+
+    try {
+        // Capture the whole state in memory; this only costs a copy.
+        this->m_image.Clear();
+
+        for (ComponentCollection::const_iterator it(this->m_components.begin());
+                it != this->m_components.end();
+                ++it) {
+            (*it)->Store(&this->m_image);
+        }
+
+        const char* data = static_cast< const char*>(this->m_image.GetData());
+        const size_t blockCount = GetBlockCount();
+
+        // Find the blocks that changed.  The hashes are only kept for the
+        // next checkpoint once the blocks have been written.
+        this->m_changed.clear();
+        this->m_newHashes.resize(blockCount);
+
+        for (size_t i = 0; i < blockCount; ++i) {
+            const ::Smp::UInt64 hash =
+                Checkpointer::Hash(data + (i * this->m_blockSize), GetBlockLength(i));
+
+            if (full || (i >= this->m_hashes.size()) || (hash != this->m_hashes[i])) {
+                this->m_changed.push_back(static_cast< ::Smp::UInt32>(i));
+            }
+
+            this->m_newHashes[i] = hash;
+        }
+
+        CheckpointHeader header;
+        header.magic = CHECKPOINT_MAGIC;
+        header.kind = full ? CHECKPOINT_FULL : CHECKPOINT_DELTA;
+        header.imageSize = this->m_image.GetSize();
+        header.blockSize = static_cast< ::Smp::UInt32>(this->m_blockSize);
+        header.blockCount = static_cast< ::Smp::UInt32>(this->m_changed.size());
+
+        writer->Store(&header, sizeof(header));
+
+        for (BlockCollection::const_iterator it(this->m_changed.begin());
+                it != this->m_changed.end();
+                ++it) {
+            ::Smp::UInt32 block = *it;
+
+            writer->Store(&block, sizeof(block));
+            writer->Store(const_cast< char*>(data + (block * this->m_blockSize)),
+                    static_cast< ::Smp::Int32>(GetBlockLength(block)));
+        }
+
+        this->m_hashes.swap(this->m_newHashes);
+        this->m_hasImage = true;
+
+        return header.blockCount;
+    } catch (...) {
+        // The image no longer matches the last checkpoint written, and the
+        // stream may hold a partial one: the next checkpoint is full.
+        Reset();
+        throw;
+    }
+}
+
+void Checkpointer::Apply(
+        ::Smp::IStorageReader* reader)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    if (reader == NULL) {
+        throw ::Smp::IPersist::CannotRestore("no storage reader");
+    }
+
+    CheckpointHeader header;
+    reader->Restore(&header, sizeof(header));
+
+    if (header.magic != CHECKPOINT_MAGIC) {
+        throw ::Smp::IPersist::CannotRestore("not a checkpoint");
+    }
+
+    if (header.blockSize != this->m_blockSize) {
+        throw ::Smp::IPersist::CannotRestore("checkpoint block size mismatch");
+    }
+
+    if ((header.kind == CHECKPOINT_DELTA) && !this->m_hasImage) {
+        throw ::Smp::IPersist::CannotRestore("delta checkpoint without full image");
+    }
+
+    // Until the checkpoint has been read in full, the image matches no
+    // checkpoint: a failure leaves nothing to restore or apply deltas to.
+    this->m_hasImage = false;
+
+    try {
+        try {
+            if (header.kind == CHECKPOINT_FULL) {
+                this->m_image.Clear();
+            }
+            this->m_image.Resize(static_cast< size_t>(header.imageSize));
+        } catch (::Smp::IPersist::CannotStore&) {
+            throw ::Smp::IPersist::CannotRestore("out of memory");
+        }
+
+        char* data = static_cast< char*>(this->m_image.GetData());
+        const size_t blockCount = GetBlockCount();
+
+        for (::Smp::UInt32 i = 0; i < header.blockCount; ++i) {
+            ::Smp::UInt32 block = 0;
+            reader->Restore(&block, sizeof(block));
+
+            if (block >= blockCount) {
+                throw ::Smp::IPersist::CannotRestore("checkpoint block out of range");
+            }
+
+            reader->Restore(data + (block * this->m_blockSize),
+                    static_cast< ::Smp::Int32>(GetBlockLength(block)));
+        }
+
+        // The next delta is relative to the image as restored.
+        this->m_hashes.resize(blockCount);
+
+        for (size_t i = 0; i < blockCount; ++i) {
+            this->m_hashes[i] =
+                Checkpointer::Hash(data + (i * this->m_blockSize), GetBlockLength(i));
+        }
+    } catch (...) {
+        Reset();
+        throw;
+    }
+
+    this->m_hasImage = true;
+}
+
+void Checkpointer::Restore(void)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    if (!this->m_hasImage) {
+        throw ::Smp::IPersist::CannotRestore("no checkpoint applied");
+    }
+
+    MemoryStorageReader reader(this->m_image.GetData(), this->m_image.GetSize());
+
+    for (ComponentCollection::const_iterator it(this->m_components.begin());
+            it != this->m_components.end();
+            ++it) {
+        (*it)->Restore(&reader);
+    }
+
+    if (reader.GetRemaining() != 0) {
+        throw ::Smp::IPersist::CannotRestore("checkpoint larger than state");
+    }
+}
+
+void Checkpointer::Reset(void)
+{
+    this->m_hashes.clear();
+    this->m_newHashes.clear();
+    this->m_hasImage = false;
+}
+
+size_t Checkpointer::GetBlockSize(void) const
+{
+    return this->m_blockSize;
+}
+
+size_t Checkpointer::GetImageSize(void) const
+{
+    return this->m_image.GetSize();
+}
+
+::Smp::UInt64 Checkpointer::Hash(
+        const char* data,
+        size_t size)
+{
+    // Multiply and rotate over 64-bit words, which is much faster than a
+    // byte-wise hash on blocks of several kilobytes.
+    const ::Smp::UInt64 prime = 0x9E3779B97F4A7C15ULL;
+    ::Smp::UInt64 hash = size * prime;
+    ::Smp::UInt64 word;
+
+    while (size >= sizeof(word)) {
+        memcpy(&word, data, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash = (hash << 31) | (hash >> 33);
+        data += sizeof(word);
+        size -= sizeof(word);
+    }
+
+    if (size > 0) {
+        word = 0;
+        memcpy(&word, data, size);
+        hash = (hash ^ word) * prime;
+    }
+
+    return hash ^ (hash >> 29);
+}
+
+size_t Checkpointer::GetBlockCount(void) const
+{
+    return (this->m_image.GetSize() + this->m_blockSize - 1) / this->m_blockSize;
+}
+
+size_t Checkpointer::GetBlockLength(
+        size_t block) const
+{
+    const size_t offset = block * this->m_blockSize;
+    const size_t remaining = this->m_image.GetSize() - offset;
+
+    return (remaining < this->m_blockSize) ? remaining : this->m_blockSize;
+}
@@ -0,0 +1,118 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_CHECKPOINTER_H_
+#define MDK_STORAGE_CHECKPOINTER_H_
+
+#include "Smp/IPersist.h"
+#include "Mdk/Storage/MemoryStorageWriter.h"
+
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Incremental checkpoints of a set of persistent components.
+            /// The state of the components is captured in memory and split
+            /// in blocks, and a hash of every block is kept.  The first
+            /// checkpoint stores all the blocks, a full image; further
+            /// checkpoints only store the blocks whose hash changed, a
+            /// delta.  A checkpoint is restored by applying a full image
+            /// and the deltas following it, in order, and then restoring
+            /// the components from the result.
+            class Checkpointer
+            {
+                public:
+                    static const size_t DEFAULT_BLOCK_SIZE = 4096;
+
+                    explicit Checkpointer(
+                            size_t blockSize = DEFAULT_BLOCK_SIZE);
+                    ~Checkpointer(void);
+
+                    /// Add a component to the checkpoints.  Components are
+                    /// stored and restored in the order they are added.
+                    void Add(
+                            ::Smp::IPersist* component);
+
+                    /// Store a checkpoint: a full image if full is true or
+                    /// if there is no previous checkpoint, a delta
+                    /// otherwise.
+                    /// @return Number of blocks stored.
+                    ::Smp::UInt32 Checkpoint(
+                            ::Smp::IStorageWriter* writer,
+                            ::Smp::Bool full = false)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Apply a checkpoint read from reader to the image.
+                    /// A delta can only be applied on top of a full image.
+                    void Apply(
+                            ::Smp::IStorageReader* reader)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    /// Restore the components from the image, after the
+                    /// checkpoints in the chain have been applied.
+                    void Restore(void)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    /// Make the next checkpoint a full image.
+                    void Reset(void);
+
+                    size_t GetBlockSize(void) const;
+
+                    /// Size of the state of the components, as of the last
+                    /// checkpoint stored or applied.
+                    size_t GetImageSize(void) const;
+
+                private:
+                    Checkpointer(
+                            const Checkpointer&);
+                    Checkpointer& operator= (
+                            const Checkpointer&);
+
+                    typedef ::std::vector< ::Smp::IPersist*> ComponentCollection;
+                    typedef ::std::vector< ::Smp::UInt64> HashCollection;
+                    typedef ::std::vector< ::Smp::UInt32> BlockCollection;
+
+                    static ::Smp::UInt64 Hash(
+                            const char* data,
+                            size_t size);
+
+                    size_t GetBlockCount(void) const;
+
+                    /// Bytes in the given block of the image; the last block
+                    /// may be shorter than the others.
+                    size_t GetBlockLength(
+                            size_t block) const;
+
+                    ComponentCollection m_components;
+                    ::Smp::Mdk::Storage::MemoryStorageWriter m_image;
+                    HashCollection m_hashes;
+                    /// Hashes of the checkpoint being written.
+                    HashCollection m_newHashes;
+                    BlockCollection m_changed;
+                    size_t m_blockSize;
+                    ::Smp::Bool m_hasImage;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_CHECKPOINTER_H_
@@ -0,0 +1,56 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Mdk/Storage/ChunkedStorage.h"
+
+using namespace ::Smp::Mdk::Storage;
+
+const size_t ChunkedStorage::MAX_CHUNK_SIZE;
+
+void ChunkedStorage::Store(
+        ::Smp::IStorageWriter* writer,
+        const void* address,
+        size_t size)
+    throw (::Smp::IPersist::CannotStore)
+{
+    char* data = static_cast< char*>(const_cast< void*>(address));
+
+    for (size_t offset = 0; offset < size; offset += MAX_CHUNK_SIZE) {
+        const size_t left = size - offset;
+        const size_t chunk = (left < MAX_CHUNK_SIZE) ? left : MAX_CHUNK_SIZE;
+
+        writer->Store(data + offset, static_cast< ::Smp::Int32>(chunk));
+    }
+}
+
+void ChunkedStorage::Restore(
+        ::Smp::IStorageReader* reader,
+        void* address,
+        size_t size)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    char* data = static_cast< char*>(address);
+
+    for (size_t offset = 0; offset < size; offset += MAX_CHUNK_SIZE) {
+        const size_t left = size - offset;
+        const size_t chunk = (left < MAX_CHUNK_SIZE) ? left : MAX_CHUNK_SIZE;
+
+        reader->Restore(data + offset, static_cast< ::Smp::Int32>(chunk));
+    }
+}
@@ -0,0 +1,60 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MDK_STORAGE_CHUNKEDSTORAGE_H_
+#define MDK_STORAGE_CHUNKEDSTORAGE_H_
+
+#include "Smp/IPersist.h"
+
+#include <cstddef>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Store and restore blocks of memory larger than the Int32
+            /// size taken by IStorageWriter::Store and
+            /// IStorageReader::Restore, in as many calls as needed.
+            class ChunkedStorage
+            {
+                public:
+                    /// Largest block handed to a single Store or Restore.
+                    static const size_t MAX_CHUNK_SIZE = 1 << 30;
+
+                    /// Store size bytes at address.
+                    static void Store(
+                            ::Smp::IStorageWriter* writer,
+                            const void* address,
+                            size_t size)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Restore size bytes at address.
+                    static void Restore(
+                            ::Smp::IStorageReader* reader,
+                            void* address,
+                            size_t size)
+                        throw (::Smp::IPersist::CannotRestore);
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_CHUNKEDSTORAGE_H_
@@ -0,0 +1,163 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/CompressedStorageReader.h"
+#include "Mdk/Storage/CompressedStorageWriter.h"
+
+#include <string.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+CompressedStorageReader::CompressedStorageReader(
+        ::Smp::IStorageReader* reader) :
+    m_reader(reader),
+    m_count(0),
+    m_current(0),
+    m_position(0)
+{
+}
+
+CompressedStorageReader::~CompressedStorageReader(void)
+{
+}
+
+void CompressedStorageReader::Restore(
+        void* address,
+        ::Smp::Int32 size)
+{
+    char* data = static_cast< char*>(address);
+    size_t remaining = (size > 0) ? static_cast< size_t>(size) : 0;
+
+    while (remaining > 0) {
+        while ((this->m_current < this->m_count) &&
+                (this->m_position == this->m_sizes[this->m_current])) {
+            ++this->m_current;
+            this->m_position = 0;
+        }
+
+        if (this->m_current == this->m_count) {
+            ReadBatch();
+            continue;
+        }
+
+        const size_t available = this->m_sizes[this->m_current] - this->m_position;
+        const size_t chunk = (remaining < available) ? remaining : available;
+
+        memcpy(data, &this->m_raw[this->m_current][this->m_position], chunk);
+        this->m_position += chunk;
+        data += chunk;
+        remaining -= chunk;
+    }
+}
+
+void CompressedStorageReader::ReadBatch(void)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    if (this->m_reader == NULL) {
+        throw ::Smp::IPersist::CannotRestore("no storage reader");
+    }
+
+    ::Smp::UInt32 count = 0;
+    this->m_reader->Restore(&count, sizeof(count));
+
+    if ((count == 0) || (count > CompressedStorageWriter::MAX_THREAD_COUNT)) {
+        throw ::Smp::IPersist::CannotRestore("corrupt compressed batch");
+    }
+
+    if (this->m_raw.size() < count) {
+        this->m_raw.resize(count);
+        this->m_compressed.resize(count);
+    }
+    this->m_sizes.resize(count);
+
+    ::std::vector< ::Smp::UInt32> stored(count);
+
+    for (::Smp::UInt32 i = 0; i < count; ++i) {
+        ::Smp::UInt32 header[2];
+        this->m_reader->Restore(header, sizeof(header));
+
+        const bool raw = ((header[1] & CompressedStorageWriter::RAW_BLOCK) != 0);
+        stored[i] = header[1] & ~CompressedStorageWriter::RAW_BLOCK;
+
+        if (header[0] >= CompressedStorageWriter::RAW_BLOCK) {
+            throw ::Smp::IPersist::CannotRestore("corrupt compressed block");
+        }
+
+        this->m_sizes[i] = header[0];
+
+        if (raw) {
+            if (stored[i] != header[0]) {
+                throw ::Smp::IPersist::CannotRestore("corrupt compressed block");
+            }
+
+            // Marks a block that needs no decompression.
+            stored[i] = CompressedStorageWriter::RAW_BLOCK;
+        }
+    }
+
+    ::std::vector< LzCodec::Block> blocks;
+    blocks.reserve(count);
+
+    for (::Smp::UInt32 i = 0; i < count; ++i) {
+        const size_t size = this->m_sizes[i];
+
+        if (this->m_raw[i].size() < size) {
+            this->m_raw[i].resize(size);
+        }
+
+        if (stored[i] == CompressedStorageWriter::RAW_BLOCK) {
+            if (size > 0) {
+                this->m_reader->Restore(&this->m_raw[i][0], static_cast< ::Smp::Int32>(size));
+            }
+            continue;
+        }
+
+        if (this->m_compressed[i].size() < stored[i]) {
+            this->m_compressed[i].resize(stored[i]);
+        }
+
+        if (stored[i] > 0) {
+            this->m_reader->Restore(&this->m_compressed[i][0],
+                    static_cast< ::Smp::Int32>(stored[i]));
+        }
+
+        LzCodec::Block block;
+        block.source = (stored[i] > 0) ? &this->m_compressed[i][0] : NULL;
+        block.sourceSize = stored[i];
+        block.target = (size > 0) ? &this->m_raw[i][0] : NULL;
+        block.targetSize = size;
+        block.ok = false;
+        blocks.push_back(block);
+    }
+
+    if (!blocks.empty()) {
+        LzCodec::Decompress(&blocks[0], blocks.size());
+    }
+
+    for (::std::vector< LzCodec::Block>::const_iterator it(blocks.begin());
+            it != blocks.end();
+            ++it) {
+        if (!it->ok) {
+            throw ::Smp::IPersist::CannotRestore("corrupt compressed block");
+        }
+    }
+
+    this->m_count = count;
+    this->m_current = 0;
+    this->m_position = 0;
+}
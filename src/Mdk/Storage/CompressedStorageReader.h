@@ -0,0 +1,74 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_COMPRESSEDSTORAGEREADER_H_
+#define MDK_STORAGE_COMPRESSEDSTORAGEREADER_H_
+
+#include "Smp/IPersist.h"
+#include "Mdk/Storage/LzCodec.h"
+
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Storage reader decompressing what a CompressedStorageWriter
+            /// wrote to another storage writer.  Batches are read one at a
+            /// time, as they are needed, and their blocks decompressed on
+            /// a thread each.
+            class CompressedStorageReader :
+                public virtual ::Smp::IStorageReader
+            {
+                public:
+                    explicit CompressedStorageReader(
+                            ::Smp::IStorageReader* reader);
+                    virtual ~CompressedStorageReader(void);
+
+                    /// @throw ::Smp::IPersist::CannotRestore if the
+                    ///        compressed data is corrupt.
+                    virtual void Restore(
+                            void* address,
+                            ::Smp::Int32 size);
+
+                private:
+                    CompressedStorageReader(
+                            const CompressedStorageReader&);
+                    CompressedStorageReader& operator= (
+                            const CompressedStorageReader&);
+
+                    typedef ::std::vector< char> Buffer;
+
+                    void ReadBatch(void)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    ::Smp::IStorageReader* m_reader;
+                    ::std::vector< Buffer> m_raw;
+                    ::std::vector< Buffer> m_compressed;
+                    ::std::vector< size_t> m_sizes;
+                    size_t m_count;
+                    size_t m_current;
+                    size_t m_position;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_COMPRESSEDSTORAGEREADER_H_
@@ -0,0 +1,160 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/CompressedStorageWriter.h"
+
+#include <string.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+const size_t CompressedStorageWriter::DEFAULT_BLOCK_SIZE;
+const ::Smp::UInt32 CompressedStorageWriter::MAX_THREAD_COUNT;
+const ::Smp::UInt32 CompressedStorageWriter::RAW_BLOCK;
+
+CompressedStorageWriter::CompressedStorageWriter(
+        ::Smp::IStorageWriter* writer,
+        size_t blockSize,
+        ::Smp::UInt32 threadCount) :
+    m_writer(writer),
+    m_blockSize((blockSize > 0) ? blockSize : DEFAULT_BLOCK_SIZE),
+    m_raw((threadCount == 0) ? 1 :
+            (threadCount > MAX_THREAD_COUNT) ? MAX_THREAD_COUNT : threadCount),
+    m_compressed(m_raw.size()),
+    m_blocks(m_raw.size()),
+    m_current(0),
+    m_used(0),
+    m_rawSize(0),
+    m_storedSize(0)
+{
+    // Stored sizes must leave the flag free.
+    if (this->m_blockSize >= RAW_BLOCK) {
+        this->m_blockSize = RAW_BLOCK - 1;
+    }
+
+    for (size_t i = 0; i < this->m_raw.size(); ++i) {
+        this->m_raw[i].resize(this->m_blockSize);
+        this->m_compressed[i].resize(LzCodec::GetBound(this->m_blockSize));
+    }
+}
+
+CompressedStorageWriter::~CompressedStorageWriter(void)
+{
+    try {
+        Flush();
+    } catch (::Smp::IPersist::CannotStore&) {
+    }
+}
+
+void CompressedStorageWriter::Store(
+        void* address,
+        ::Smp::Int32 size)
+{
+    const char* data = static_cast< const char*>(address);
+    size_t remaining = (size > 0) ? static_cast< size_t>(size) : 0;
+
+    this->m_rawSize += remaining;
+
+    while (remaining > 0) {
+        if (this->m_used == this->m_blockSize) {
+            ++this->m_current;
+            this->m_used = 0;
+
+            if (this->m_current == this->m_raw.size()) {
+                Flush();
+            }
+        }
+
+        const size_t room = this->m_blockSize - this->m_used;
+        const size_t chunk = (remaining < room) ? remaining : room;
+
+        memcpy(&this->m_raw[this->m_current][this->m_used], data, chunk);
+        this->m_used += chunk;
+        data += chunk;
+        remaining -= chunk;
+    }
+}
+
+void CompressedStorageWriter::Flush(void)
+    throw (::Smp::IPersist::CannotStore)
+{
+    // Full blocks, and the one being filled if not empty.
+    const size_t count = (this->m_current < this->m_raw.size()) ?
+        this->m_current + ((this->m_used > 0) ? 1 : 0) : this->m_current;
+
+    if (count == 0) {
+        return;
+    }
+
+    if (this->m_writer == NULL) {
+        throw ::Smp::IPersist::CannotStore("no storage writer");
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        LzCodec::Block& block = this->m_blocks[i];
+
+        block.source = &this->m_raw[i][0];
+        block.sourceSize = ((i == this->m_current) && (this->m_used > 0)) ?
+            this->m_used : this->m_blockSize;
+        block.target = &this->m_compressed[i][0];
+        block.targetSize = this->m_compressed[i].size();
+    }
+
+    LzCodec::Compress(&this->m_blocks[0], count);
+
+    ::Smp::UInt32 header[2];
+    ::Smp::UInt32 blockCount = static_cast< ::Smp::UInt32>(count);
+
+    this->m_writer->Store(&blockCount, sizeof(blockCount));
+    this->m_storedSize += sizeof(blockCount);
+
+    for (size_t i = 0; i < count; ++i) {
+        const LzCodec::Block& block = this->m_blocks[i];
+        const bool raw = !block.ok || (block.targetSize >= block.sourceSize);
+
+        header[0] = static_cast< ::Smp::UInt32>(block.sourceSize);
+        header[1] = raw ?
+            (static_cast< ::Smp::UInt32>(block.sourceSize) | RAW_BLOCK) :
+            static_cast< ::Smp::UInt32>(block.targetSize);
+
+        this->m_writer->Store(header, sizeof(header));
+        this->m_storedSize += sizeof(header);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const LzCodec::Block& block = this->m_blocks[i];
+        const bool raw = !block.ok || (block.targetSize >= block.sourceSize);
+        const size_t size = raw ? block.sourceSize : block.targetSize;
+
+        this->m_writer->Store(const_cast< char*>(raw ? block.source : block.target),
+                static_cast< ::Smp::Int32>(size));
+        this->m_storedSize += size;
+    }
+
+    this->m_current = 0;
+    this->m_used = 0;
+}
+
+::Smp::Int64 CompressedStorageWriter::GetRawSize(void) const
+{
+    return this->m_rawSize;
+}
+
+::Smp::Int64 CompressedStorageWriter::GetStoredSize(void) const
+{
+    return this->m_storedSize;
+}
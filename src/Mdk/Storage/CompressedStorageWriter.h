@@ -0,0 +1,98 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_COMPRESSEDSTORAGEWRITER_H_
+#define MDK_STORAGE_COMPRESSEDSTORAGEWRITER_H_
+
+#include "Smp/IPersist.h"
+#include "Mdk/Storage/LzCodec.h"
+
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Storage writer compressing what is stored into another
+            /// storage writer, to be read back by a CompressedStorageReader.
+            /// Data is cut in blocks that are compressed independently with
+            /// LzCodec.  Up to threadCount blocks, at most MAX_THREAD_COUNT,
+            /// are compressed at once, on as many threads, and written out
+            /// as a batch: the number
+            /// of blocks, the raw and stored size of each, and their data.
+            /// Blocks that do not compress are stored as they are.
+            class CompressedStorageWriter :
+                public virtual ::Smp::IStorageWriter
+            {
+                public:
+                    static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+                    /// Largest number of blocks in a batch; readers take
+                    /// larger batches for corrupt data.
+                    static const ::Smp::UInt32 MAX_THREAD_COUNT = 1024;
+                    /// Flag in the stored size of blocks kept uncompressed,
+                    /// which also bounds the block size.
+                    static const ::Smp::UInt32 RAW_BLOCK = 0x80000000U;
+
+                    CompressedStorageWriter(
+                            ::Smp::IStorageWriter* writer,
+                            size_t blockSize = DEFAULT_BLOCK_SIZE,
+                            ::Smp::UInt32 threadCount = 1);
+
+                    /// Flush, ignoring errors.  Call Flush() first to find
+                    /// out whether all the data was written.
+                    virtual ~CompressedStorageWriter(void);
+
+                    virtual void Store(
+                            void* address,
+                            ::Smp::Int32 size);
+
+                    /// Compress and write all the buffered data.
+                    void Flush(void)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Bytes stored so far, before compression.
+                    ::Smp::Int64 GetRawSize(void) const;
+
+                    /// Bytes written to the underlying writer so far.
+                    ::Smp::Int64 GetStoredSize(void) const;
+
+                private:
+                    CompressedStorageWriter(
+                            const CompressedStorageWriter&);
+                    CompressedStorageWriter& operator= (
+                            const CompressedStorageWriter&);
+
+                    typedef ::std::vector< char> Buffer;
+
+                    ::Smp::IStorageWriter* m_writer;
+                    size_t m_blockSize;
+                    ::std::vector< Buffer> m_raw;
+                    ::std::vector< Buffer> m_compressed;
+                    ::std::vector< LzCodec::Block> m_blocks;
+                    size_t m_current;
+                    size_t m_used;
+                    ::Smp::Int64 m_rawSize;
+                    ::Smp::Int64 m_storedSize;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_COMPRESSEDSTORAGEWRITER_H_
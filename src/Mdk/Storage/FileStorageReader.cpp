@@ -0,0 +1,89 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/FileStorageReader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+FileStorageReader::FileStorageReader(
+        ::Smp::String8 filename)
+    throw (::Smp::IPersist::CannotRestore) :
+        m_mapping(NULL),
+        m_size(0)
+{
+    if (filename == NULL) {
+        throw ::Smp::IPersist::CannotRestore("no file name");
+    }
+
+    const int fd = open(filename, O_RDONLY);
+
+    if (fd < 0) {
+        throw ::Smp::IPersist::CannotRestore(strerror(errno));
+    }
+
+    struct stat status;
+
+    if (fstat(fd, &status) != 0) {
+        const int error = errno;
+        close(fd);
+
+        throw ::Smp::IPersist::CannotRestore(strerror(error));
+    }
+
+    this->m_size = static_cast< size_t>(status.st_size);
+
+    // Empty files cannot be mapped, and need no mapping anyway.
+    if (this->m_size > 0) {
+        void* mapping = mmap(NULL, this->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping == MAP_FAILED) {
+            const int error = errno;
+            close(fd);
+
+            throw ::Smp::IPersist::CannotRestore(strerror(error));
+        }
+
+        madvise(mapping, this->m_size, MADV_SEQUENTIAL);
+        this->m_mapping = mapping;
+    }
+
+    // The mapping stays valid once the descriptor is closed.
+    close(fd);
+
+    SetData(this->m_mapping, this->m_size);
+}
+
+FileStorageReader::~FileStorageReader(void)
+{
+    if (this->m_mapping != NULL) {
+        munmap(this->m_mapping, this->m_size);
+        this->m_mapping = NULL;
+    }
+}
+
+size_t FileStorageReader::GetSize(void) const
+{
+    return this->m_size;
+}
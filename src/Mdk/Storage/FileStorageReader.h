@@ -0,0 +1,59 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_FILESTORAGEREADER_H_
+#define MDK_STORAGE_FILESTORAGEREADER_H_
+
+#include "Mdk/Storage/MemoryStorageReader.h"
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Storage reader from a file mapped in memory.  The file is
+            /// mapped once when opened; restoring a block is then a bounds
+            /// check and a memcpy, with pages brought in by the kernel as
+            /// they are read.
+            class FileStorageReader :
+                public ::Smp::Mdk::Storage::MemoryStorageReader
+            {
+                public:
+                    explicit FileStorageReader(
+                            ::Smp::String8 filename)
+                        throw (::Smp::IPersist::CannotRestore);
+                    virtual ~FileStorageReader(void);
+
+                    /// Size of the file.
+                    size_t GetSize(void) const;
+
+                private:
+                    FileStorageReader(
+                            const FileStorageReader&);
+                    FileStorageReader& operator= (
+                            const FileStorageReader&);
+
+                    void* m_mapping;
+                    size_t m_size;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_FILESTORAGEREADER_H_
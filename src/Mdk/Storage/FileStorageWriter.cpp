@@ -0,0 +1,169 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/FileStorageWriter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+const size_t FileStorageWriter::DEFAULT_BUFFER_SIZE;
+
+FileStorageWriter::FileStorageWriter(
+        ::Smp::String8 filename,
+        size_t bufferSize)
+    throw (::Smp::IPersist::CannotStore) :
+        m_fd(-1),
+        m_buffer(NULL),
+        m_bufferSize((bufferSize > 0) ? bufferSize : DEFAULT_BUFFER_SIZE),
+        m_buffered(0),
+        m_written(0)
+{
+    if (filename == NULL) {
+        throw ::Smp::IPersist::CannotStore("no file name");
+    }
+
+    this->m_buffer = static_cast< char*>(malloc(this->m_bufferSize));
+
+    if (this->m_buffer == NULL) {
+        throw ::Smp::IPersist::CannotStore("out of memory");
+    }
+
+    this->m_fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (this->m_fd < 0) {
+        free(this->m_buffer);
+        this->m_buffer = NULL;
+
+        throw ::Smp::IPersist::CannotStore(strerror(errno));
+    }
+}
+
+FileStorageWriter::~FileStorageWriter(void)
+{
+    try {
+        Close();
+    } catch (::Smp::IPersist::CannotStore&) {
+    }
+
+    free(this->m_buffer);
+    this->m_buffer = NULL;
+}
+
+void FileStorageWriter::Store(
+        void* address,
+        ::Smp::Int32 size)
+{
+    if (size <= 0) {
+        return;
+    }
+
+    const size_t blockSize = static_cast< size_t>(size);
+
+    if ((this->m_buffered + blockSize) > this->m_bufferSize) {
+        Flush();
+
+        // Blocks larger than the buffer are written straight away.
+        if (blockSize > this->m_bufferSize) {
+            Write(static_cast< const char*>(address), blockSize);
+            return;
+        }
+    }
+
+    memcpy(this->m_buffer + this->m_buffered, address, blockSize);
+    this->m_buffered += blockSize;
+}
+
+void FileStorageWriter::Flush(void)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (this->m_buffered > 0) {
+        const size_t buffered = this->m_buffered;
+
+        this->m_buffered = 0;
+        Write(this->m_buffer, buffered);
+    }
+}
+
+void FileStorageWriter::Sync(void)
+    throw (::Smp::IPersist::CannotStore)
+{
+    Flush();
+
+    if ((this->m_fd >= 0) && (fsync(this->m_fd) != 0)) {
+        throw ::Smp::IPersist::CannotStore(strerror(errno));
+    }
+}
+
+void FileStorageWriter::Close(void)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (this->m_fd < 0) {
+        return;
+    }
+
+    try {
+        Flush();
+    } catch (::Smp::IPersist::CannotStore&) {
+        close(this->m_fd);
+        this->m_fd = -1;
+        throw;
+    }
+
+    const int result = close(this->m_fd);
+    this->m_fd = -1;
+
+    if (result != 0) {
+        throw ::Smp::IPersist::CannotStore(strerror(errno));
+    }
+}
+
+::Smp::Int64 FileStorageWriter::GetSize(void) const
+{
+    return this->m_written + this->m_buffered;
+}
+
+void FileStorageWriter::Write(
+        const char* data,
+        size_t size)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (this->m_fd < 0) {
+        throw ::Smp::IPersist::CannotStore("file is closed");
+    }
+
+    while (size > 0) {
+        const ssize_t written = write(this->m_fd, data, size);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            throw ::Smp::IPersist::CannotStore(strerror(errno));
+        }
+
+        data += written;
+        size -= written;
+        this->m_written += written;
+    }
+}
@@ -0,0 +1,95 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_FILESTORAGEWRITER_H_
+#define MDK_STORAGE_FILESTORAGEWRITER_H_
+
+#include "Smp/IPersist.h"
+
+#include <cstddef>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Storage writer to a file, through a large buffer in user
+            /// space.  Storing a block is a memcpy into the buffer; the
+            /// file is only written when the buffer is full, so that the
+            /// number of system calls does not depend on the number of
+            /// fields stored.
+            class FileStorageWriter :
+                public virtual ::Smp::IStorageWriter
+            {
+                public:
+                    static const size_t DEFAULT_BUFFER_SIZE = 4 * 1024 * 1024;
+
+                    /// Create or truncate the file.
+                    FileStorageWriter(
+                            ::Smp::String8 filename,
+                            size_t bufferSize = DEFAULT_BUFFER_SIZE)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Close the file, ignoring errors.  Call Close() first
+                    /// to find out whether the data was written.
+                    virtual ~FileStorageWriter(void);
+
+                    /// @throw ::Smp::IPersist::CannotStore if the file
+                    ///        cannot be written.
+                    virtual void Store(
+                            void* address,
+                            ::Smp::Int32 size);
+
+                    /// Write the buffered data to the file.
+                    void Flush(void)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Write the buffered data, and wait until the file is
+                    /// on disk.
+                    void Sync(void)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    void Close(void)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Number of bytes stored, including buffered ones.
+                    ::Smp::Int64 GetSize(void) const;
+
+                private:
+                    FileStorageWriter(
+                            const FileStorageWriter&);
+                    FileStorageWriter& operator= (
+                            const FileStorageWriter&);
+
+                    void Write(
+                            const char* data,
+                            size_t size)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    int m_fd;
+                    char* m_buffer;
+                    size_t m_bufferSize;
+                    size_t m_buffered;
+                    ::Smp::Int64 m_written;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_FILESTORAGEWRITER_H_
@@ -0,0 +1,301 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/LzCodec.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include <vector>
+
+using namespace ::Smp::Mdk::Storage;
+
+namespace
+{
+    const size_t LZ_MIN_MATCH = 4;
+    const size_t LZ_MAX_OFFSET = 0xFFFF;
+    const unsigned int LZ_HASH_BITS = 12;
+    const unsigned int LZ_RUN_MASK = 15;
+
+    ::Smp::UInt32 Read32(
+            const char* p)
+    {
+        ::Smp::UInt32 value;
+        memcpy(&value, p, sizeof(value));
+
+        return value;
+    }
+
+    ::Smp::UInt32 HashOf(
+            ::Smp::UInt32 sequence)
+    {
+        return (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+    }
+
+    /// Write a length beyond what fits in a token nibble, as a run of 255
+    /// and a final byte.
+    char* WriteLength(
+            char* op,
+            size_t length)
+    {
+        while (length >= 255) {
+            *op++ = static_cast< char>(255);
+            length -= 255;
+        }
+        *op++ = static_cast< char>(length);
+
+        return op;
+    }
+
+    char* WriteSequence(
+            char* op,
+            const char* literals,
+            size_t literalLength,
+            size_t offset,
+            size_t matchLength)
+    {
+        char* token = op++;
+        const size_t matchCode = (matchLength > 0) ? matchLength - LZ_MIN_MATCH : 0;
+
+        *token = static_cast< char>(
+                (((literalLength < LZ_RUN_MASK) ? literalLength : LZ_RUN_MASK) << 4) |
+                ((matchCode < LZ_RUN_MASK) ? matchCode : LZ_RUN_MASK));
+
+        if (literalLength >= LZ_RUN_MASK) {
+            op = WriteLength(op, literalLength - LZ_RUN_MASK);
+        }
+
+        memcpy(op, literals, literalLength);
+        op += literalLength;
+
+        if (matchLength > 0) {
+            *op++ = static_cast< char>(offset & 0xFF);
+            *op++ = static_cast< char>(offset >> 8);
+
+            if (matchCode >= LZ_RUN_MASK) {
+                op = WriteLength(op, matchCode - LZ_RUN_MASK);
+            }
+        }
+
+        return op;
+    }
+
+    /// Read an extended length; false if the input ends first.
+    bool ReadLength(
+            const unsigned char*& ip,
+            const unsigned char* end,
+            size_t& length)
+    {
+        unsigned char byte;
+
+        do {
+            if (ip >= end) {
+                return false;
+            }
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+
+        return true;
+    }
+
+    void* CompressBlock(
+            void* block)
+    {
+        LzCodec::Block* b = static_cast< LzCodec::Block*>(block);
+
+        b->ok = (b->targetSize >= LzCodec::GetBound(b->sourceSize));
+
+        if (b->ok) {
+            b->targetSize = LzCodec::Compress(b->source, b->sourceSize, b->target);
+        }
+
+        return NULL;
+    }
+
+    void* DecompressBlock(
+            void* block)
+    {
+        LzCodec::Block* b = static_cast< LzCodec::Block*>(block);
+
+        b->ok = LzCodec::Decompress(b->source, b->sourceSize, b->target, b->targetSize);
+
+        return NULL;
+    }
+
+    /// Run work on every block, the first one on the calling thread and
+    /// the others on threads of their own, or on the calling thread as
+    /// well if a thread cannot be created.
+    void RunParallel(
+            void* (*work)(void*),
+            LzCodec::Block* blocks,
+            size_t count)
+    {
+        ::std::vector< pthread_t> threads(count);
+        ::std::vector< bool> started(count, false);
+
+        for (size_t i = 1; i < count; ++i) {
+            started[i] = (pthread_create(&threads[i], NULL, work, &blocks[i]) == 0);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (started[i]) {
+                pthread_join(threads[i], NULL);
+            } else {
+                work(&blocks[i]);
+            }
+        }
+    }
+}
+
+size_t LzCodec::GetBound(
+        size_t size)
+{
+    return size + (size / 255) + 16;
+}
+
+size_t LzCodec::Compress(
+        const char* source,
+        size_t size,
+        char* target)
+{
+    ::Smp::UInt32 table[1 << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));
+
+    char* op = target;
+    size_t anchor = 0;
+    size_t i = 0;
+
+    // Positions are kept plus one, so that zero marks an empty slot.
+    while ((i + LZ_MIN_MATCH) <= size) {
+        const ::Smp::UInt32 sequence = Read32(source + i);
+        const ::Smp::UInt32 h = HashOf(sequence);
+        const size_t candidate = table[h];
+
+        table[h] = static_cast< ::Smp::UInt32>(i + 1);
+
+        if ((candidate == 0) ||
+                ((i - (candidate - 1)) > LZ_MAX_OFFSET) ||
+                (Read32(source + candidate - 1) != sequence)) {
+            ++i;
+            continue;
+        }
+
+        const size_t match = candidate - 1;
+        size_t length = LZ_MIN_MATCH;
+
+        while (((i + length) < size) && (source[match + length] == source[i + length])) {
+            ++length;
+        }
+
+        op = WriteSequence(op, source + anchor, i - anchor, i - match, length);
+        i += length;
+        anchor = i;
+    }
+
+    op = WriteSequence(op, source + anchor, size - anchor, 0, 0);
+
+    return op - target;
+}
+
+::Smp::Bool LzCodec::Decompress(
+        const char* source,
+        size_t size,
+        char* target,
+        size_t targetSize)
+{
+    const unsigned char* ip = reinterpret_cast< const unsigned char*>(source);
+    const unsigned char* const end = ip + size;
+    char* op = target;
+    char* const targetEnd = target + targetSize;
+
+    for (;;) {
+        if (ip >= end) {
+            return false;
+        }
+
+        const unsigned int token = *ip++;
+        size_t literalLength = token >> 4;
+
+        if ((literalLength == LZ_RUN_MASK) && !ReadLength(ip, end, literalLength)) {
+            return false;
+        }
+
+        if ((literalLength > static_cast< size_t>(end - ip)) ||
+                (literalLength > static_cast< size_t>(targetEnd - op))) {
+            return false;
+        }
+
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        // Only the last sequence fills the target, with literals.
+        if (op == targetEnd) {
+            return (ip == end);
+        }
+
+        if ((end - ip) < 2) {
+            return false;
+        }
+
+        const size_t offset = ip[0] | (static_cast< size_t>(ip[1]) << 8);
+        ip += 2;
+
+        if ((offset == 0) || (offset > static_cast< size_t>(op - target))) {
+            return false;
+        }
+
+        size_t matchLength = token & LZ_RUN_MASK;
+
+        if ((matchLength == LZ_RUN_MASK) && !ReadLength(ip, end, matchLength)) {
+            return false;
+        }
+        matchLength += LZ_MIN_MATCH;
+
+        if (matchLength > static_cast< size_t>(targetEnd - op)) {
+            return false;
+        }
+
+        const char* match = op - offset;
+
+        if (offset >= matchLength) {
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        } else {
+            // Overlapping match, such as a run of a repeated byte.
+            for (size_t i = 0; i < matchLength; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+}
+
+void LzCodec::Compress(
+        Block* blocks,
+        size_t count)
+{
+    RunParallel(&CompressBlock, blocks, count);
+}
+
+void LzCodec::Decompress(
+        Block* blocks,
+        size_t count)
+{
+    RunParallel(&DecompressBlock, blocks, count);
+}
@@ -0,0 +1,90 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_LZCODEC_H_
+#define MDK_STORAGE_LZCODEC_H_
+
+#include "Smp/SimpleTypes.h"
+
+#include <cstddef>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Byte-oriented LZ77 codec, in the spirit of LZ4, for blocks
+            /// held in memory.  A block is a series of sequences: a token
+            /// with the lengths of some literals and of a match, the
+            /// literals, and the 16-bit offset of the match.  The last
+            /// sequence has literals only.  Compression finds matches
+            /// through a hash table of 4-byte strings; it is fast rather
+            /// than thorough, which suits zeroed arrays and repeated
+            /// structures in state files.
+            class LzCodec
+            {
+                public:
+                    /// A block to compress or decompress.
+                    struct Block
+                    {
+                        const char* source;
+                        size_t sourceSize;
+                        char* target;
+                        /// Capacity of target on input; bytes written to
+                        /// it on output.
+                        size_t targetSize;
+                        ::Smp::Bool ok;
+                    };
+
+                    /// Largest compressed size of size bytes.
+                    static size_t GetBound(
+                            size_t size);
+
+                    /// Compress size bytes from source into target, which
+                    /// must hold GetBound(size) bytes.
+                    /// @return Compressed size.
+                    static size_t Compress(
+                            const char* source,
+                            size_t size,
+                            char* target);
+
+                    /// Decompress a block into exactly targetSize bytes.
+                    /// @return false if the block is corrupt.
+                    static ::Smp::Bool Decompress(
+                            const char* source,
+                            size_t size,
+                            char* target,
+                            size_t targetSize);
+
+                    /// Compress independent blocks, on one thread each.
+                    static void Compress(
+                            Block* blocks,
+                            size_t count);
+
+                    /// Decompress independent blocks, on one thread each.
+                    /// targetSize must be the exact decompressed size.
+                    static void Decompress(
+                            Block* blocks,
+                            size_t count);
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_LZCODEC_H_
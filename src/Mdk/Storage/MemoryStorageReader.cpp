@@ -0,0 +1,90 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/MemoryStorageReader.h"
+
+#include <string.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+MemoryStorageReader::MemoryStorageReader(void) :
+    m_data(NULL),
+    m_size(0),
+    m_position(0)
+{
+}
+
+MemoryStorageReader::MemoryStorageReader(
+        const void* data,
+        size_t size) :
+    m_data(static_cast< const char*>(data)),
+    m_size((data != NULL) ? size : 0),
+    m_position(0)
+{
+}
+
+MemoryStorageReader::~MemoryStorageReader(void)
+{
+}
+
+void MemoryStorageReader::Restore(
+        void* address,
+        ::Smp::Int32 size)
+{
+    if (size <= 0) {
+        return;
+    }
+
+    const size_t blockSize = static_cast< size_t>(size);
+
+    if (blockSize > (this->m_size - this->m_position)) {
+        throw ::Smp::IPersist::CannotRestore("unexpected end of storage");
+    }
+
+    memcpy(address, this->m_data + this->m_position, blockSize);
+    this->m_position += blockSize;
+}
+
+void MemoryStorageReader::Rewind(void)
+{
+    this->m_position = 0;
+}
+
+size_t MemoryStorageReader::GetPosition(void) const
+{
+    return this->m_position;
+}
+
+size_t MemoryStorageReader::GetRemaining(void) const
+{
+    return this->m_size - this->m_position;
+}
+
+const void* MemoryStorageReader::GetData(void) const
+{
+    return this->m_data;
+}
+
+void MemoryStorageReader::SetData(
+        const void* data,
+        size_t size)
+{
+    this->m_data = static_cast< const char*>(data);
+    this->m_size = (data != NULL) ? size : 0;
+    this->m_position = 0;
+}
@@ -0,0 +1,78 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_MEMORYSTORAGEREADER_H_
+#define MDK_STORAGE_MEMORYSTORAGEREADER_H_
+
+#include "Smp/IPersist.h"
+
+#include <cstddef>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Storage reader consuming a block of memory it does not own,
+            /// such as the data of a MemoryStorageWriter.  Restoring a
+            /// block is a bounds check and a memcpy.
+            class MemoryStorageReader :
+                public virtual ::Smp::IStorageReader
+            {
+                public:
+                    MemoryStorageReader(
+                            const void* data,
+                            size_t size);
+                    virtual ~MemoryStorageReader(void);
+
+                    /// @throw ::Smp::IPersist::CannotRestore if fewer than
+                    ///        size bytes are left to read.
+                    virtual void Restore(
+                            void* address,
+                            ::Smp::Int32 size);
+
+                    /// Start reading from the beginning again.
+                    void Rewind(void);
+
+                    /// Number of bytes read so far.
+                    size_t GetPosition(void) const;
+
+                    /// Number of bytes left to read.
+                    size_t GetRemaining(void) const;
+
+                    /// Block of memory being read, from its beginning.
+                    const void* GetData(void) const;
+
+                protected:
+                    MemoryStorageReader(void);
+
+                    void SetData(
+                            const void* data,
+                            size_t size);
+
+                private:
+                    const char* m_data;
+                    size_t m_size;
+                    size_t m_position;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_MEMORYSTORAGEREADER_H_
@@ -0,0 +1,121 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/MemoryStorageWriter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+const size_t MemoryStorageWriter::DEFAULT_CAPACITY;
+
+MemoryStorageWriter::MemoryStorageWriter(
+        size_t capacity) :
+    m_data(NULL),
+    m_size(0),
+    m_capacity(0)
+{
+    Reserve(capacity);
+}
+
+MemoryStorageWriter::~MemoryStorageWriter(void)
+{
+    free(this->m_data);
+    this->m_data = NULL;
+}
+
+void MemoryStorageWriter::Store(
+        void* address,
+        ::Smp::Int32 size)
+{
+    if (size <= 0) {
+        return;
+    }
+
+    const size_t blockSize = static_cast< size_t>(size);
+
+    if ((this->m_size + blockSize) > this->m_capacity) {
+        size_t capacity = (this->m_capacity > 0) ? this->m_capacity : DEFAULT_CAPACITY;
+
+        while (capacity < (this->m_size + blockSize)) {
+            capacity *= 2;
+        }
+
+        Reserve(capacity);
+    }
+
+    memcpy(this->m_data + this->m_size, address, blockSize);
+    this->m_size += blockSize;
+}
+
+void MemoryStorageWriter::Reserve(
+        size_t capacity)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (capacity <= this->m_capacity) {
+        return;
+    }
+
+    char* data = static_cast< char*>(realloc(this->m_data, capacity));
+
+    if (data == NULL) {
+        throw ::Smp::IPersist::CannotStore("out of memory");
+    }
+
+    this->m_data = data;
+    this->m_capacity = capacity;
+}
+
+void MemoryStorageWriter::Clear(void)
+{
+    this->m_size = 0;
+}
+
+void MemoryStorageWriter::Resize(
+        size_t size)
+    throw (::Smp::IPersist::CannotStore)
+{
+    Reserve(size);
+
+    if (size > this->m_size) {
+        memset(this->m_data + this->m_size, 0, size - this->m_size);
+    }
+
+    this->m_size = size;
+}
+
+void* MemoryStorageWriter::GetData(void)
+{
+    return this->m_data;
+}
+
+const void* MemoryStorageWriter::GetData(void) const
+{
+    return this->m_data;
+}
+
+size_t MemoryStorageWriter::GetSize(void) const
+{
+    return this->m_size;
+}
+
+size_t MemoryStorageWriter::GetCapacity(void) const
+{
+    return this->m_capacity;
+}
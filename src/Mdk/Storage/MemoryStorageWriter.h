@@ -0,0 +1,87 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_MEMORYSTORAGEWRITER_H_
+#define MDK_STORAGE_MEMORYSTORAGEWRITER_H_
+
+#include "Smp/IPersist.h"
+
+#include <cstddef>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Storage writer appending to a growable buffer in memory.
+            /// Storing a block is a bounds check and a memcpy; the buffer
+            /// grows geometrically, so that storing a large state made of
+            /// many small fields costs no more than copying it.
+            class MemoryStorageWriter :
+                public virtual ::Smp::IStorageWriter
+            {
+                public:
+                    static const size_t DEFAULT_CAPACITY = 64 * 1024;
+
+                    explicit MemoryStorageWriter(
+                            size_t capacity = DEFAULT_CAPACITY);
+                    virtual ~MemoryStorageWriter(void);
+
+                    virtual void Store(
+                            void* address,
+                            ::Smp::Int32 size);
+
+                    /// Make room for capacity bytes in total, so that
+                    /// storing them does not grow the buffer.
+                    void Reserve(
+                            size_t capacity)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Forget the stored data, keeping the buffer.
+                    void Clear(void);
+
+                    /// Set the number of bytes stored.  Bytes added at the
+                    /// end are zeroed.
+                    void Resize(
+                            size_t size)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    void* GetData(void);
+                    const void* GetData(void) const;
+
+                    /// Number of bytes stored.
+                    size_t GetSize(void) const;
+
+                    size_t GetCapacity(void) const;
+
+                private:
+                    MemoryStorageWriter(
+                            const MemoryStorageWriter&);
+                    MemoryStorageWriter& operator= (
+                            const MemoryStorageWriter&);
+
+                    char* m_data;
+                    size_t m_size;
+                    size_t m_capacity;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_MEMORYSTORAGEWRITER_H_
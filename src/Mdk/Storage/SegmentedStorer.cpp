@@ -0,0 +1,314 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mdk/Storage/SegmentedStorer.h"
+#include "Mdk/Storage/ChunkedStorage.h"
+#include "Mdk/Storage/FileStorageWriter.h"
+#include "Mdk/Storage/FileStorageReader.h"
+#include "Mdk/Component.h"
+
+#include <map>
+#include <set>
+#include <pthread.h>
+#include <unistd.h>
+
+using namespace ::Smp::Mdk::Storage;
+
+// First word of segmented state files.
+const ::Smp::UInt32 SEGMENTED_STORER_MAGIC = 0x31474553U;
+
+SegmentedStorer::SegmentedStorer(
+        ::Smp::UInt32 threadCount) :
+    m_threadCount(threadCount)
+{
+    if (this->m_threadCount == 0) {
+        const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+        this->m_threadCount = (processors > 0) ?
+            static_cast< ::Smp::UInt32>(processors) : 1;
+    }
+}
+
+SegmentedStorer::~SegmentedStorer(void)
+{
+    for (size_t i = 0; i < this->m_buffers.size(); ++i) {
+        delete this->m_buffers[i];
+    }
+}
+
+void SegmentedStorer::Add(
+        ::Smp::IPersist* component)
+{
+    if (component != NULL) {
+        this->m_components.push_back(component);
+        this->m_buffers.push_back(new MemoryStorageWriter());
+    }
+}
+
+void SegmentedStorer::Store(
+        ::Smp::String8 filename)
+    throw (::Smp::IPersist::CannotStore)
+{
+    if (filename == NULL) {
+        throw ::Smp::IPersist::CannotStore("no file name");
+    }
+
+    const size_t count = this->m_components.size();
+    TaskCollection tasks(count);
+    ::std::vector< ::std::string> names(count);
+    ::std::set< ::std::string> unique;
+
+    for (size_t i = 0; i < count; ++i) {
+        tasks[i].component = this->m_components[i];
+        tasks[i].buffer = this->m_buffers[i];
+        tasks[i].data = NULL;
+        tasks[i].size = 0;
+        names[i] = GetSegmentName(this->m_components[i]);
+
+        // Only one of the segments could be restored.
+        if (!unique.insert(names[i]).second) {
+            throw ::Smp::IPersist::CannotStore("duplicate segment name");
+        }
+    }
+
+    const ::std::string error = Run(tasks, &SegmentedStorer::StoreTask);
+
+    if (!error.empty()) {
+        throw ::Smp::IPersist::CannotStore(error.c_str());
+    }
+
+    // The index: magic, segment count, then offset, size, name length and
+    // name of every segment.  Segments follow the index, in order.
+    ::Smp::UInt64 offset = 2 * sizeof(::Smp::UInt32);
+
+    for (size_t i = 0; i < count; ++i) {
+        offset += 2 * sizeof(::Smp::UInt64) + sizeof(::Smp::UInt32) + names[i].size();
+    }
+
+    FileStorageWriter writer(filename);
+
+    ::Smp::UInt32 header[2] = { SEGMENTED_STORER_MAGIC, static_cast< ::Smp::UInt32>(count) };
+    writer.Store(header, sizeof(header));
+
+    for (size_t i = 0; i < count; ++i) {
+        ::Smp::UInt64 entry[2] = { offset, this->m_buffers[i]->GetSize() };
+        ::Smp::UInt32 length = static_cast< ::Smp::UInt32>(names[i].size());
+
+        writer.Store(entry, sizeof(entry));
+        writer.Store(&length, sizeof(length));
+        ChunkedStorage::Store(&writer, names[i].data(), names[i].size());
+
+        offset += entry[1];
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        ChunkedStorage::Store(&writer, this->m_buffers[i]->GetData(), this->m_buffers[i]->GetSize());
+    }
+
+    writer.Close();
+}
+
+void SegmentedStorer::Restore(
+        ::Smp::String8 filename)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    Restore(filename, this->m_components);
+}
+
+void SegmentedStorer::Restore(
+        ::Smp::String8 filename,
+        const ComponentCollection& components)
+    throw (::Smp::IPersist::CannotRestore)
+{
+    FileStorageReader reader(filename);
+    const char* data = static_cast< const char*>(reader.GetData());
+    const size_t fileSize = reader.GetSize();
+
+    ::Smp::UInt32 header[2];
+    reader.Restore(header, sizeof(header));
+
+    if (header[0] != SEGMENTED_STORER_MAGIC) {
+        throw ::Smp::IPersist::CannotRestore("not a segmented state file");
+    }
+
+    typedef ::std::map< ::std::string, ::std::pair< const char*, size_t> > SegmentMap;
+    SegmentMap segments;
+
+    for (::Smp::UInt32 i = 0; i < header[1]; ++i) {
+        ::Smp::UInt64 entry[2];
+        ::Smp::UInt32 length;
+
+        reader.Restore(entry, sizeof(entry));
+        reader.Restore(&length, sizeof(length));
+
+        if ((length > reader.GetRemaining()) ||
+                (entry[0] > fileSize) ||
+                (entry[1] > (fileSize - entry[0]))) {
+            throw ::Smp::IPersist::CannotRestore("corrupt segment index");
+        }
+
+        ::std::string name(length, '\0');
+
+        if (length > 0) {
+            reader.Restore(&name[0], static_cast< ::Smp::Int32>(length));
+        }
+
+        if (!segments.insert(::std::make_pair(name,
+                        ::std::make_pair(data + entry[0], static_cast< size_t>(entry[1])))).second) {
+            throw ::Smp::IPersist::CannotRestore("duplicate segment name");
+        }
+    }
+
+    TaskCollection tasks;
+    tasks.reserve(components.size());
+
+    for (ComponentCollection::const_iterator it(components.begin());
+            it != components.end();
+            ++it) {
+        if (*it == NULL) {
+            continue;
+        }
+
+        const SegmentMap::const_iterator segment(segments.find(GetSegmentName(*it)));
+
+        if (segment == segments.end()) {
+            throw ::Smp::IPersist::CannotRestore("no segment for component");
+        }
+
+        Task task;
+        task.component = *it;
+        task.buffer = NULL;
+        task.data = segment->second.first;
+        task.size = segment->second.second;
+        tasks.push_back(task);
+    }
+
+    const ::std::string error = Run(tasks, &SegmentedStorer::RestoreTask);
+
+    if (!error.empty()) {
+        throw ::Smp::IPersist::CannotRestore(error.c_str());
+    }
+}
+
+::Smp::UInt32 SegmentedStorer::GetThreadCount(void) const
+{
+    return this->m_threadCount;
+}
+
+::std::string SegmentedStorer::GetSegmentName(
+        ::Smp::IPersist* component)
+{
+    const ::Smp::Mdk::Component* mdkComponent =
+        dynamic_cast< const ::Smp::Mdk::Component*>(component);
+    const ::Smp::String8 name = (mdkComponent != NULL) ?
+        mdkComponent->GetPath() : component->GetName();
+
+    return (name != NULL) ? name : "";
+}
+
+void SegmentedStorer::StoreTask(
+        Task& task)
+{
+    task.buffer->Clear();
+
+    try {
+        task.component->Store(task.buffer);
+    } catch (::Smp::IPersist::CannotStore& ex) {
+        task.error = (ex.message != NULL) ? ex.message : "cannot store component";
+    } catch (...) {
+        // Nothing may escape the worker threads.
+        task.error = "cannot store component";
+    }
+}
+
+void SegmentedStorer::RestoreTask(
+        Task& task)
+{
+    MemoryStorageReader reader(task.data, task.size);
+
+    try {
+        task.component->Restore(&reader);
+    } catch (::Smp::IPersist::CannotRestore& ex) {
+        task.error = (ex.message != NULL) ? ex.message : "cannot restore component";
+        return;
+    } catch (...) {
+        // Nothing may escape the worker threads.
+        task.error = "cannot restore component";
+        return;
+    }
+
+    if (reader.GetRemaining() != 0) {
+        task.error = "segment larger than component state";
+    }
+}
+
+void* SegmentedStorer::RunPool(
+        void* pool)
+{
+    Pool* self = static_cast< Pool*>(pool);
+    const size_t count = self->tasks->size();
+
+    for (;;) {
+        const size_t i = __atomic_fetch_add(&self->next, 1, __ATOMIC_RELAXED);
+
+        if (i >= count) {
+            break;
+        }
+
+        self->work((*self->tasks)[i]);
+    }
+
+    return NULL;
+}
+
+::std::string SegmentedStorer::Run(
+        TaskCollection& tasks,
+        void (*work)(Task&)) const
+{
+    Pool pool;
+    pool.tasks = &tasks;
+    pool.work = work;
+    pool.next = 0;
+
+    // The calling thread is one of the workers.
+    const size_t threadCount = (tasks.size() < this->m_threadCount) ?
+        tasks.size() : this->m_threadCount;
+    ::std::vector< pthread_t> threads;
+
+    for (size_t i = 1; i < threadCount; ++i) {
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, &SegmentedStorer::RunPool, &pool) == 0) {
+            threads.push_back(thread);
+        }
+    }
+
+    RunPool(&pool);
+
+    for (size_t i = 0; i < threads.size(); ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (TaskCollection::const_iterator it(tasks.begin()); it != tasks.end(); ++it) {
+        if (!it->error.empty()) {
+            return it->error;
+        }
+    }
+
+    return ::std::string();
+}
@@ -0,0 +1,141 @@
+/** This file is part of smp-mdk
+ *
+ * Copyright (C) 2018 Juan R. Garcia Blanco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDK_STORAGE_SEGMENTEDSTORER_H_
+#define MDK_STORAGE_SEGMENTEDSTORER_H_
+
+#include "Smp/IPersist.h"
+#include "Mdk/Storage/MemoryStorageWriter.h"
+
+#include <string>
+#include <vector>
+
+namespace Smp
+{
+    namespace Mdk
+    {
+        namespace Storage
+        {
+            /// Store of persistent components into segmented state files.
+            /// Every component is stored into a segment of its own, and the
+            /// file starts with an index giving the name, offset and size
+            /// of every segment.  Components are stored into memory
+            /// buffers, and restored from the mapped file, on a pool of
+            /// threads; a file can also be restored for some of the
+            /// components only.
+            ///
+            /// Segments are named after the path of the component if it is
+            /// a ::Smp::Mdk::Component, after its name otherwise, and must
+            /// be unique.  Components must not share state, as they are
+            /// stored and restored concurrently.
+            class SegmentedStorer
+            {
+                public:
+                    typedef ::std::vector< ::Smp::IPersist*> ComponentCollection;
+
+                    /// @param threadCount Number of threads storing and
+                    ///        restoring components, or 0 for one per
+                    ///        processor.
+                    explicit SegmentedStorer(
+                            ::Smp::UInt32 threadCount = 0);
+                    ~SegmentedStorer(void);
+
+                    /// Add a component to the stores.  Segments are written
+                    /// in the order components are added.
+                    void Add(
+                            ::Smp::IPersist* component);
+
+                    /// Store all the components to filename.
+                    /// @throw ::Smp::IPersist::CannotStore if two segments
+                    ///        have the same name, a component cannot be
+                    ///        stored, or the file written.
+                    void Store(
+                            ::Smp::String8 filename)
+                        throw (::Smp::IPersist::CannotStore);
+
+                    /// Restore all the components from filename.
+                    /// @throw ::Smp::IPersist::CannotRestore if the file is
+                    ///        corrupt, has no segment for a component, or a
+                    ///        component cannot be restored or does not
+                    ///        restore its whole segment.
+                    void Restore(
+                            ::Smp::String8 filename)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    /// Restore the given components only from filename.
+                    /// The components need not have been added.
+                    void Restore(
+                            ::Smp::String8 filename,
+                            const ComponentCollection& components)
+                        throw (::Smp::IPersist::CannotRestore);
+
+                    ::Smp::UInt32 GetThreadCount(void) const;
+
+                private:
+                    SegmentedStorer(
+                            const SegmentedStorer&);
+                    SegmentedStorer& operator= (
+                            const SegmentedStorer&);
+
+                    /// Work on one component, done by any thread.
+                    struct Task
+                    {
+                        ::Smp::IPersist* component;
+                        ::Smp::Mdk::Storage::MemoryStorageWriter* buffer;
+                        const char* data;
+                        size_t size;
+                        ::std::string error;
+                    };
+
+                    typedef ::std::vector< Task> TaskCollection;
+
+                    struct Pool
+                    {
+                        TaskCollection* tasks;
+                        void (*work)(Task&);
+                        size_t next;
+                    };
+
+                    static ::std::string GetSegmentName(
+                            ::Smp::IPersist* component);
+
+                    static void StoreTask(
+                            Task& task);
+
+                    static void RestoreTask(
+                            Task& task);
+
+                    static void* RunPool(
+                            void* pool);
+
+                    /// Run work on every task, on up to m_threadCount
+                    /// threads.
+                    /// @return First error reported by a task, if any.
+                    ::std::string Run(
+                            TaskCollection& tasks,
+                            void (*work)(Task&)) const;
+
+                    ComponentCollection m_components;
+                    ::std::vector< ::Smp::Mdk::Storage::MemoryStorageWriter*> m_buffers;
+                    ::Smp::UInt32 m_threadCount;
+            };
+        }
+    }
+}
+
+#endif  // MDK_STORAGE_SEGMENTEDSTORER_H_
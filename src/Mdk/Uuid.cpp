@@ -79,6 +79,36 @@ Uuid& Uuid::operator= (
         (::memcmp(this->Data4, uuid.Data4, sizeof(this->Data4)) != 0);
 }
 
+::Smp::UInt32 Uuid::Hash(void) const
+{
+    return Uuid::Hash(*this);
+}
+
+::Smp::UInt32 Uuid::Hash(
+        const ::Smp::Uuid& uuid)
+{
+    ::Smp::UInt64 low = 0;
+    ::memcpy(&low, uuid.Data4, sizeof(low));
+
+    const ::Smp::UInt64 high =
+        (static_cast< ::Smp::UInt64>(uuid.Data1) << 32) |
+        (static_cast< ::Smp::UInt64>(uuid.Data2) << 16) |
+        uuid.Data3;
+
+    // Combine both words, then apply the 64-bit finalizer of MurmurHash3,
+    // so that uuids differing in a few bits, as generated ones often do,
+    // spread over the whole table.
+    ::Smp::UInt64 hash = (high * 0x9E3779B97F4A7C15ULL) ^ low;
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+
+    return static_cast< ::Smp::UInt32>(hash ^ (hash >> 32));
+}
+
 static struct BlockInfo
 {
     ::Smp::Bool isRaw;
@@ -50,6 +50,12 @@ namespace Smp
                     const char* uuidString);
             void Get(
                     char* uuidString) const;
+
+            /// Hash of the uuid, mixing all its bits, for hash tables.
+            ::Smp::UInt32 Hash(void) const;
+
+            static ::Smp::UInt32 Hash(
+                    const ::Smp::Uuid& uuid);
         };
 
         static const Uuid NullUuid = Uuid("00000000-0000-0000-0000-000000000000");
@@ -126,6 +126,8 @@ namespace Smp
                 sprintf(description, CannotRestoreTemplate, 
                     message);
             }
+
+            ~CannotRestore() throw() {}
         };
 
         /// Cannot store to storage writer (IStorageWriter).
@@ -149,6 +151,8 @@ namespace Smp
                 sprintf(description, CannotStoreTemplate, 
                     message);
             }
+
+            ~CannotStore() throw() {}
         };
 
         /// Restore component state from storage.
@@ -0,0 +1,88 @@
+#include "ArenaTest.h"
+
+#include "Mdk/Arena.h"
+#include "Mdk/Management/ManagedContainer.h"
+#include "Mdk/Management/ManagedComponent.h"
+
+using namespace ::Smp::Mdk;
+
+class CountedComponent :
+    public ::Smp::Mdk::Management::ManagedComponent
+{
+    public:
+        CountedComponent(
+                ::Smp::String8 name,
+                ::Smp::String8 desc,
+                ::Smp::IComposite* parent) :
+            ManagedComponent(name, desc, parent)
+        {
+            ++s_instances;
+        }
+
+        virtual ~CountedComponent(void)
+        {
+            --s_instances;
+        }
+
+        static int s_instances;
+};
+
+int CountedComponent::s_instances = 0;
+
+void ArenaTest::setUp(void)
+{
+}
+
+void ArenaTest::tearDown(void)
+{
+}
+
+void ArenaTest::testAllocate(void)
+{
+    Arena arena(256);
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), arena.GetUsedSize());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), arena.GetReservedSize());
+
+    char* p1 = static_cast< char*>(arena.Allocate(1));
+    char* p2 = static_cast< char*>(arena.Allocate(24));
+    CPPUNIT_ASSERT(p1 != NULL);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reinterpret_cast< size_t>(p2) % 16);
+    CPPUNIT_ASSERT(p2 >= (p1 + 1));
+    CPPUNIT_ASSERT_EQUAL(size_t(256), arena.GetReservedSize());
+
+    // Larger than a block.
+    void* p3 = arena.Allocate(1024);
+    CPPUNIT_ASSERT(p3 != NULL);
+    CPPUNIT_ASSERT_EQUAL(size_t(256 + 1024), arena.GetReservedSize());
+
+    // Blocks are kept and reused after a reset.
+    arena.Reset();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), arena.GetUsedSize());
+    CPPUNIT_ASSERT(arena.Allocate(1) == p1);
+    CPPUNIT_ASSERT_EQUAL(size_t(256 + 1024), arena.GetReservedSize());
+
+    arena.Release();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), arena.GetReservedSize());
+}
+
+void ArenaTest::testContainerChildren(void)
+{
+    Arena arena;
+    ::Smp::Mdk::Management::ManagedContainer< CountedComponent> cont1(
+            "cont1", "Container 1", NULL);
+    cont1.SetArena(&arena);
+    CPPUNIT_ASSERT(cont1.GetArena() == &arena);
+
+    for (int run = 0; run < 2; ++run) {
+        cont1.AddComponent(new (arena) CountedComponent("Comp1", "Comp 1", NULL));
+        cont1.AddComponent(new (arena) CountedComponent("Comp2", "Comp 2", NULL));
+        CPPUNIT_ASSERT_EQUAL(2, CountedComponent::s_instances);
+        CPPUNIT_ASSERT_EQUAL(::Smp::Int64(2), cont1.Count());
+
+        cont1.Clear();
+        CPPUNIT_ASSERT_EQUAL(0, CountedComponent::s_instances);
+
+        arena.Reset();
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef ARENATEST_H_
+#define ARENATEST_H_
+
+#include "BaseTest.h"
+
+class ArenaTest :
+    public BaseTest
+{
+    public: 
+        CPPUNIT_SUITE_BEGIN(ArenaTest)
+            CPPUNIT_TEST(ArenaTest, testAllocate)
+            CPPUNIT_TEST(ArenaTest, testContainerChildren)
+        CPPUNIT_SUITE_END()
+
+        void setUp(void);
+        void tearDown(void);
+
+        void testAllocate(void);
+        void testContainerChildren(void);
+};
+
+#endif // ARENATEST_H_
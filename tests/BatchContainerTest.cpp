@@ -0,0 +1,171 @@
+#include "BatchContainerTest.h"
+
+#include "Mdk/BatchContainer.h"
+#include "Mdk/Management/ManagedComponent.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace ::Smp::Mdk;
+
+class ThermalNode :
+    public ::Smp::Mdk::Management::ManagedComponent,
+    public ::Smp::Mdk::BatchMember
+{
+    public:
+        enum
+        {
+            TEMPERATURE,
+            HEAT_FLOW,
+            COLUMN_COUNT
+        };
+
+        ThermalNode(
+                ::Smp::String8 name,
+                ::Smp::String8 desc,
+                ::Smp::IComposite* parent) :
+            ManagedComponent(name, desc, parent)
+        {
+        }
+
+        ::Smp::Float64 GetTemperature(void) const
+        {
+            return State(TEMPERATURE);
+        }
+
+        void SetHeatFlow(
+                ::Smp::Float64 heatFlow)
+        {
+            State(HEAT_FLOW) = heatFlow;
+        }
+
+        static void StepBatch(
+                StateTable& state)
+        {
+            ::Smp::Float64* temperature = state.Column(TEMPERATURE);
+            const ::Smp::Float64* heatFlow = state.Column(HEAT_FLOW);
+            const ::Smp::UInt32 count = state.GetRowCount();
+
+            for (::Smp::UInt32 i = 0; i < count; ++i)
+            {
+                temperature[i] += heatFlow[i];
+            }
+        }
+};
+
+static void Cool(
+        StateTable& state)
+{
+    ::Smp::Float64* temperature = state.Column(ThermalNode::TEMPERATURE);
+
+    for (::Smp::UInt32 i = 0; i < state.GetRowCount(); ++i)
+    {
+        temperature[i] -= 1.0;
+    }
+}
+
+void BatchContainerTest::setUp(void)
+{
+}
+
+void BatchContainerTest::tearDown(void)
+{
+}
+
+void BatchContainerTest::testStateTable(void)
+{
+    StateTable table(2);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(2), table.GetColumnCount());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), table.GetRowCount());
+    CPPUNIT_ASSERT(table.Column(0) == NULL);
+
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), table.AddRow());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), table.AddRow());
+    CPPUNIT_ASSERT_EQUAL(0.0, table.At(1, 1));
+
+    table.At(1, 1) = 2.5;
+    CPPUNIT_ASSERT_EQUAL(2.5, table.Column(1)[1]);
+
+    table.Clear();
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), table.GetRowCount());
+}
+
+void BatchContainerTest::testStep(void)
+{
+    BatchContainer< ThermalNode> nodes("Nodes", "Thermal nodes", NULL,
+            ThermalNode::COLUMN_COUNT);
+    nodes.Reserve(100);
+
+    char name[32];
+    for (int i = 0; i < 100; ++i)
+    {
+        ::snprintf(name, sizeof(name), "Node%d", i);
+        ThermalNode* node = new ThermalNode(name, "Thermal node", NULL);
+        nodes.AddChild(node);
+        node->SetHeatFlow(i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(100), nodes.Count());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(100), nodes.GetState().GetRowCount());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(42), nodes.At(42)->GetRow());
+
+    nodes.Step();
+    nodes.Step();
+    CPPUNIT_ASSERT_EQUAL(84.0, nodes.GetChild("Node42")->GetTemperature());
+
+    nodes.Step(&Cool);
+    CPPUNIT_ASSERT_EQUAL(83.0, nodes.At(42)->GetTemperature());
+    CPPUNIT_ASSERT_EQUAL(-1.0, nodes.At(0)->GetTemperature());
+
+    nodes.Clear();
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), nodes.GetState().GetRowCount());
+}
+
+void BatchContainerTest::testAdd(void)
+{
+    BatchContainer< ThermalNode> nodes("Nodes", "Thermal nodes", NULL,
+            ThermalNode::COLUMN_COUNT);
+
+    // Every way of adding children gives them a row.
+    ThermalNode* first = new ThermalNode("Node0", "Thermal node", NULL);
+    nodes.Add(first);
+
+    ::Smp::IComponent* second = new ThermalNode("Node1", "Thermal node", NULL);
+    nodes.Add(second);
+
+    ::std::vector< ThermalNode*> range;
+    range.push_back(new ThermalNode("Node2", "Thermal node", NULL));
+    range.push_back(NULL);
+    range.push_back(new ThermalNode("Node3", "Thermal node", NULL));
+    nodes.AddRange(range.begin(), range.end());
+
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(4), nodes.Count());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(4), nodes.GetState().GetRowCount());
+
+    for (::Smp::UInt32 i = 0; i < 4; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(i, nodes.At(i)->GetRow());
+        nodes.At(i)->SetHeatFlow(i);
+    }
+
+    nodes.Step();
+    CPPUNIT_ASSERT_EQUAL(1.0, nodes.GetChild("Node1")->GetTemperature());
+    CPPUNIT_ASSERT_EQUAL(3.0, nodes.GetChild("Node3")->GetTemperature());
+
+    // A rejected child is not given a row.
+    bool exceptionCatched = false;
+    ThermalNode* duplicate = new ThermalNode("Node0", "Thermal node", NULL);
+
+    try
+    {
+        nodes.Add(duplicate);
+    }
+    catch (::Smp::DuplicateName&)
+    {
+        exceptionCatched = true;
+    }
+
+    CPPUNIT_ASSERT(exceptionCatched);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(4), nodes.GetState().GetRowCount());
+    delete duplicate;
+}
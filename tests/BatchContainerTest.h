@@ -0,0 +1,24 @@
+#ifndef BATCHCONTAINERTEST_H_
+#define BATCHCONTAINERTEST_H_
+
+#include "BaseTest.h"
+
+class BatchContainerTest :
+    public BaseTest
+{
+    public: 
+        CPPUNIT_SUITE_BEGIN(BatchContainerTest)
+            CPPUNIT_TEST(BatchContainerTest, testStateTable)
+            CPPUNIT_TEST(BatchContainerTest, testStep)
+            CPPUNIT_TEST(BatchContainerTest, testAdd)
+        CPPUNIT_SUITE_END()
+
+        void setUp(void);
+        void tearDown(void);
+
+        void testStateTable(void);
+        void testStep(void);
+        void testAdd(void);
+};
+
+#endif // BATCHCONTAINERTEST_H_
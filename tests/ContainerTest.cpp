@@ -1,6 +1,9 @@
 #include "ContainerTest.h"
 
+#include "Mdk/CachedCast.h"
+#include "Mdk/Component.h"
 #include "Mdk/Container.h"
+#include "Mdk/HierarchyObserver.h"
 
 using namespace ::Smp::Mdk;
 
@@ -78,6 +81,32 @@ class OtherComponentStub :
         ::std::string _desc;
 };
 
+class Padding
+{
+    public:
+        virtual ~Padding(void)
+        {
+        }
+
+        double _padding[4];
+};
+
+// Places the ComponentStub subobject at a different offset than in a
+// plain ComponentStub.
+class PaddedComponentStub :
+    public Padding,
+    public ComponentStub
+{
+    public:
+        PaddedComponentStub(
+                ::Smp::String8 name,
+                ::Smp::String8 desc,
+                ::Smp::IComposite* parent) :
+            ComponentStub(name, desc, parent)
+        {
+        }
+};
+
 template< typename T>
 class ContainerSubclass :
     public virtual ::Smp::Mdk::Container< T>
@@ -100,6 +129,19 @@ class ContainerSubclass :
         {
             Container< T>::Add(component);
         }
+
+        void AddTyped(
+                T* child)
+        {
+            Container< T>::Add(child);
+        }
+
+        template < typename ForwardIterator> void AddRangePublic(
+                ForwardIterator first,
+                ForwardIterator last)
+        {
+            Container< T>::AddRange(first, last);
+        }
 };
 
 void ContainerTest::setUp(void)
@@ -217,3 +259,153 @@ void ContainerTest::testExceptions(void)
     delete cont1;
 }
 
+
+void ContainerTest::testTypedAdd(void)
+{
+    ContainerSubclass< ComponentStub>* cont1 =
+        new ContainerSubclass< ComponentStub>("cont1", "Container 1", NULL);
+
+    ComponentStub* comp1 = new ComponentStub("Comp1", "Comp 1", NULL);
+    cont1->AddTyped(comp1);
+    CPPUNIT_ASSERT_EQUAL(comp1, cont1->GetChild("Comp1"));
+
+    bool exceptionCatched = false;
+    try
+    {
+        cont1->AddTyped(comp1);
+    }
+    catch (::Smp::DuplicateName& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // Alternate between types with different subobject offsets, so that
+    // the cached cast is replaced every time.
+    ComponentStub* comp2 = new ComponentStub("Comp2", "Comp 2", NULL);
+    ComponentStub* comp3 = new PaddedComponentStub("Comp3", "Comp 3", NULL);
+    ComponentStub* comp4 = new ComponentStub("Comp4", "Comp 4", NULL);
+    ComponentStub* comp5 = new PaddedComponentStub("Comp5", "Comp 5", NULL);
+    ComponentStub* comp6 = new PaddedComponentStub("Comp6", "Comp 6", NULL);
+    cont1->AddPublic(comp2);
+    cont1->AddPublic(comp3);
+    cont1->AddPublic(comp4);
+    cont1->AddPublic(comp5);
+    cont1->AddPublic(comp6);
+
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(6), cont1->Count());
+    CPPUNIT_ASSERT_EQUAL(comp2, cont1->At(1));
+    CPPUNIT_ASSERT_EQUAL(comp3, cont1->At(2));
+    CPPUNIT_ASSERT_EQUAL(comp4, cont1->At(3));
+    CPPUNIT_ASSERT_EQUAL(comp5, cont1->At(4));
+    CPPUNIT_ASSERT_EQUAL(comp6, cont1->At(5));
+
+    delete cont1;
+}
+
+class CastBase
+{
+    public:
+        virtual ~CastBase(void)
+        {
+        }
+};
+
+class CastLeft :
+    public CastBase
+{
+};
+
+class CastRight :
+    public CastBase
+{
+};
+
+class CastBoth :
+    public CastLeft,
+    public CastRight
+{
+};
+
+void ContainerTest::testCachedCast(void)
+{
+    // CastBoth has two CastBase subobjects, with different offsets to the
+    // CastLeft subobject.
+    ::Smp::Mdk::CachedCast< CastBase, CastLeft> cast;
+    CastBoth first;
+    CastBoth second;
+    CastLeft* left = &first;
+    CastRight* right = &first;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        CPPUNIT_ASSERT(cast(static_cast< CastBase*>(left)) == left);
+        CPPUNIT_ASSERT(cast(static_cast< CastBase*>(right)) == left);
+    }
+
+    CPPUNIT_ASSERT(cast(static_cast< CastBase*>(static_cast< CastRight*>(&second))) ==
+            static_cast< CastLeft*>(&second));
+    CPPUNIT_ASSERT(cast(NULL) == NULL);
+}
+
+class CountingObserver :
+    public ::Smp::Mdk::HierarchyObserver
+{
+    public:
+        CountingObserver(void) :
+            notifications(0),
+            components(0)
+        {
+        }
+
+        virtual void OnHierarchyChanged(
+                const ::Smp::IComponent* component)
+        {
+            ++this->notifications;
+        }
+
+        virtual void OnComponentsChanged(
+                const ::Smp::IComposite* composite,
+                ::Smp::ComponentCollection::const_iterator first,
+                ::Smp::ComponentCollection::const_iterator last)
+        {
+            ++this->notifications;
+            this->components += ::std::distance(first, last);
+        }
+
+        int notifications;
+        int components;
+};
+
+void ContainerTest::testHierarchyNotifications(void)
+{
+    CountingObserver observer;
+    ::Smp::Mdk::Component::AddHierarchyObserver(&observer);
+
+    ContainerSubclass< ComponentStub>* cont1 =
+        new ContainerSubclass< ComponentStub>("cont1", "Container 1", NULL);
+
+    // Observers hear about a whole range, or a whole clear, only once.
+    ComponentStub* range[3] = {
+        new ComponentStub("Comp1", "Comp 1", NULL),
+        new ComponentStub("Comp2", "Comp 2", NULL),
+        new ComponentStub("Comp3", "Comp 3", NULL)
+    };
+    cont1->AddRangePublic(range, range + 3);
+    CPPUNIT_ASSERT_EQUAL(1, observer.notifications);
+    CPPUNIT_ASSERT_EQUAL(3, observer.components);
+
+    cont1->AddTyped(new ComponentStub("Comp4", "Comp 4", NULL));
+    CPPUNIT_ASSERT_EQUAL(2, observer.notifications);
+
+    cont1->Clear();
+    CPPUNIT_ASSERT_EQUAL(3, observer.notifications);
+    CPPUNIT_ASSERT_EQUAL(7, observer.components);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(0), cont1->Count());
+
+    // An empty container has nothing to tell.
+    delete cont1;
+    CPPUNIT_ASSERT_EQUAL(3, observer.notifications);
+
+    ::Smp::Mdk::Component::RemoveHierarchyObserver(&observer);
+}
@@ -11,6 +11,9 @@ class ContainerTest :
             CPPUNIT_TEST(ContainerTest, testInstantiation)
             CPPUNIT_TEST(ContainerTest, testPublicInterface)
             CPPUNIT_TEST(ContainerTest, testExceptions)
+            CPPUNIT_TEST(ContainerTest, testTypedAdd)
+            CPPUNIT_TEST(ContainerTest, testCachedCast)
+            CPPUNIT_TEST(ContainerTest, testHierarchyNotifications)
         CPPUNIT_SUITE_END()
 
         void setUp(void);
@@ -19,6 +22,9 @@ class ContainerTest :
         void testInstantiation(void);
         void testPublicInterface(void);
         void testExceptions(void);
+        void testTypedAdd(void);
+        void testCachedCast(void);
+        void testHierarchyNotifications(void);
 };
 
 #endif // CONTAINERTEST_H_
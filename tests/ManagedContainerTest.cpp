@@ -1,5 +1,9 @@
 #include <ManagedContainerTest.h>
 #include "Mdk/Management/ManagedContainer.h"
+#include "Mdk/Management/ManagedComponent.h"
+#include "Mdk/Composite.h"
+
+#include <cstdio>
 
 using namespace ::Smp::Mdk::Management;
 
@@ -40,6 +44,58 @@ class ComponentStub :
         ::std::string _desc;
 };
 
+class PathComposite :
+    public ::Smp::Mdk::Management::ManagedComponent,
+    public ::Smp::Mdk::Composite
+{
+    public:
+        PathComposite(
+                ::Smp::String8 name,
+                ::Smp::String8 desc,
+                ::Smp::IComposite* parent) :
+            ManagedComponent(name, desc, parent),
+            m_children("Children", "Children", this)
+        {
+            AddContainer(&this->m_children);
+        }
+
+        virtual ~PathComposite(void)
+        {
+        }
+
+        ManagedContainer< ManagedComponent>* GetChildren(void)
+        {
+            return &this->m_children;
+        }
+
+    private:
+        ManagedContainer< ManagedComponent> m_children;
+};
+
+/// Component counting how many times its parent is looked up.
+class CountingComponent :
+    public ManagedComponent
+{
+    public:
+        CountingComponent(
+                ::Smp::String8 name,
+                ::Smp::String8 desc,
+                ::Smp::IComposite* parent) :
+            ManagedComponent(name, desc, parent),
+            m_lookups(0)
+        {
+        }
+
+        virtual ::Smp::IComposite* GetParent(void) const
+        {
+            ++this->m_lookups;
+
+            return ManagedComponent::GetParent();
+        }
+
+        mutable int m_lookups;
+};
+
 void ManagedContainerTest::setUp(void)
 {
 }
@@ -134,3 +190,191 @@ void ManagedContainerTest::testExceptions(void)
         delete cont1;
     }
 }
+
+void ManagedContainerTest::testComponentPath(void)
+{
+    PathComposite* root = new PathComposite("Root", "Root", NULL);
+    PathComposite* sub = new PathComposite("Sub", "Sub", NULL);
+    ManagedComponent* leaf = new ManagedComponent("Leaf", "Leaf", NULL);
+
+    CPPUNIT_ASSERT(strcmp("Root", root->GetPath()) == 0);
+    CPPUNIT_ASSERT(strcmp("Leaf", leaf->GetPath()) == 0);
+
+    root->GetChildren()->AddComponent(sub);
+    sub->GetChildren()->AddComponent(leaf);
+    CPPUNIT_ASSERT(strcmp("Root/Children/Sub", sub->GetPath()) == 0);
+    CPPUNIT_ASSERT(strcmp("Root/Children/Sub/Children/Leaf", leaf->GetPath()) == 0);
+
+    ::Smp::String8 cached = leaf->GetPath();
+    CPPUNIT_ASSERT_EQUAL(cached, leaf->GetPath());
+
+    // A path that was not invalidated is returned without walking up the
+    // ancestors.
+    CountingComponent* counting = new CountingComponent("Counting", "Counting", NULL);
+    sub->GetChildren()->AddComponent(counting);
+    CPPUNIT_ASSERT(strcmp("Root/Children/Sub/Children/Counting", counting->GetPath()) == 0);
+    counting->m_lookups = 0;
+    counting->GetPath();
+    CPPUNIT_ASSERT_EQUAL(0, counting->m_lookups);
+
+    // Changes outside the subtree of a component leave its path, and the
+    // string returned for it, untouched.
+    PathComposite* other = new PathComposite("Other", "Other", NULL);
+    root->GetChildren()->AddComponent(other);
+    other->SetName("Another");
+    CPPUNIT_ASSERT_EQUAL(cached, leaf->GetPath());
+    ::Smp::Mdk::Component::InvalidatePaths();
+    CPPUNIT_ASSERT_EQUAL(cached, leaf->GetPath());
+
+    // Renamed children are indexed under their new name only.
+    CPPUNIT_ASSERT(root->GetChildren()->GetComponent("Another") == other);
+    CPPUNIT_ASSERT(root->GetChildren()->GetComponent("Other") == NULL);
+    CPPUNIT_ASSERT(strcmp("Root/Children/Another", other->GetPath()) == 0);
+
+    bool exceptionCatched = false;
+    try {
+        other->SetName("Sub");
+    } catch (::Smp::InvalidObjectName& ex) {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+    CPPUNIT_ASSERT(strcmp("Another", other->GetName()) == 0);
+
+    ManagedComponent* twin = new ManagedComponent("Another", "Twin", NULL);
+    exceptionCatched = false;
+    try {
+        root->GetChildren()->AddComponent(twin);
+    } catch (::Smp::DuplicateName& ex) {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+    delete twin;
+
+    root->SetName("Renamed");
+    CPPUNIT_ASSERT(strcmp("Renamed/Children/Sub/Children/Leaf", leaf->GetPath()) == 0);
+
+    leaf->SetName("Moved");
+    leaf->SetParent(root);
+    CPPUNIT_ASSERT(strcmp("Renamed/Moved", leaf->GetPath()) == 0);
+
+    delete root;
+}
+
+void ManagedContainerTest::testAddComponents(void)
+{
+    ManagedContainer< ComponentStub>* cont1 =
+        new ManagedContainer< ComponentStub>(
+                "cont1", "ManagedContainer 1", NULL, 0, 4);
+    cont1->Reserve(4);
+
+    ::std::vector< ::Smp::IComponent*> batch1;
+    batch1.push_back(new ComponentStub("Comp1", "Comp 1", NULL));
+    batch1.push_back(new ComponentStub("Comp2", "Comp 2", NULL));
+    cont1->AddComponents(batch1.begin(), batch1.end());
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(2), cont1->Count());
+    CPPUNIT_ASSERT(cont1->GetComponent("Comp2") == batch1[1]);
+
+    // A duplicate name rejects the whole batch.
+    ::std::vector< ComponentStub*> batch2;
+    batch2.push_back(new ComponentStub("Comp3", "Comp 3", NULL));
+    batch2.push_back(new ComponentStub("Comp1", "Comp 1", NULL));
+    try {
+        cont1->AddComponents(batch2.begin(), batch2.end());
+        CPPUNIT_ASSERT(false);
+    } catch (::Smp::DuplicateName& ex) {
+    }
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(2), cont1->Count());
+    CPPUNIT_ASSERT(cont1->GetComponent("Comp3") == NULL);
+
+    // So does overflowing the container.
+    ::std::vector< ComponentStub*> batch3;
+    batch3.push_back(new ComponentStub("Comp4", "Comp 4", NULL));
+    batch3.push_back(new ComponentStub("Comp5", "Comp 5", NULL));
+    batch3.push_back(new ComponentStub("Comp6", "Comp 6", NULL));
+    try {
+        cont1->AddComponents(batch3.begin(), batch3.end());
+        CPPUNIT_ASSERT(false);
+    } catch (::Smp::Management::IManagedContainer::ContainerFull& ex) {
+    }
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(2), cont1->Count());
+
+    delete batch2.back();
+    batch2.pop_back();
+    cont1->AddComponents(batch2.begin(), batch2.end());
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(3), cont1->Count());
+    CPPUNIT_ASSERT(cont1->GetChild("Comp3") == batch2[0]);
+
+    // NULL entries are skipped, and do not count towards the upper bound.
+    delete batch3[1];
+    delete batch3[2];
+    batch3[1] = NULL;
+    batch3[2] = NULL;
+    cont1->AddComponents(batch3.begin(), batch3.end());
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(4), cont1->Count());
+    CPPUNIT_ASSERT(cont1->GetChild("Comp4") == batch3[0]);
+
+    delete cont1;
+}
+
+void ManagedContainerTest::testSnapshot(void)
+{
+    typedef ManagedContainer< ComponentStub> Cont;
+    Cont* cont1 = new Cont("cont1", "ManagedContainer 1", NULL);
+
+    Cont::Snapshot empty = cont1->GetSnapshot();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), empty->children.size());
+
+    ComponentStub* comp1 = new ComponentStub("Comp1", "Comp 1", NULL);
+    cont1->AddComponent(comp1);
+
+    Cont::Snapshot first = cont1->GetSnapshot();
+    CPPUNIT_ASSERT(first.GetVersion() > empty.GetVersion());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), empty->children.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), first->children.size());
+    CPPUNIT_ASSERT_EQUAL(comp1, first->children[0]);
+
+    ComponentStub* comp2 = new ComponentStub("Comp2", "Comp 2", NULL);
+    cont1->AddComponent(comp2);
+
+    // Older snapshots keep their contents.
+    Cont::Snapshot second = cont1->GetSnapshot();
+    CPPUNIT_ASSERT_EQUAL(size_t(1), first->children.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), second->components.size());
+
+    first = second;
+    CPPUNIT_ASSERT_EQUAL(second.GetVersion(), first.GetVersion());
+
+    // Snapshots taken across several chunks keep their own children.
+    char name[16];
+    Cont::Snapshot middle = second;
+
+    for (int i = 3; i <= 150; ++i) {
+        ::snprintf(name, sizeof(name), "Comp%d", i);
+        cont1->AddComponent(new ComponentStub(name, "Comp", NULL));
+
+        if (i == 70) {
+            middle = cont1->GetSnapshot();
+        }
+    }
+
+    Cont::Snapshot last = cont1->GetSnapshot();
+    CPPUNIT_ASSERT_EQUAL(size_t(2), second->children.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(70), middle->children.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(150), last->children.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(150), last->components.size());
+
+    for (size_t i = 0; i < last->children.size(); ++i) {
+        CPPUNIT_ASSERT(last->children[i] == cont1->At(i));
+        CPPUNIT_ASSERT(last->components[i] == cont1->At(i));
+
+        if (i < middle->children.size()) {
+            CPPUNIT_ASSERT(middle->children[i] == cont1->At(i));
+        }
+    }
+
+    cont1->Clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(150), last->children.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), cont1->GetSnapshot()->children.size());
+
+    delete cont1;
+}
@@ -11,6 +11,9 @@ class ManagedContainerTest :
             CPPUNIT_TEST(ManagedContainerTest, testInstantiation)
             CPPUNIT_TEST(ManagedContainerTest, testPublicInterface)
             CPPUNIT_TEST(ManagedContainerTest, testExceptions)
+            CPPUNIT_TEST(ManagedContainerTest, testComponentPath)
+            CPPUNIT_TEST(ManagedContainerTest, testAddComponents)
+            CPPUNIT_TEST(ManagedContainerTest, testSnapshot)
         CPPUNIT_SUITE_END()
 
         void setUp(void);
@@ -19,6 +22,9 @@ class ManagedContainerTest :
         void testInstantiation(void);
         void testPublicInterface(void);
         void testExceptions(void);
+        void testComponentPath(void);
+        void testAddComponents(void);
+        void testSnapshot(void);
 };
 
 #endif // MANAGEDCONTAINERTEST_H_
@@ -1,6 +1,9 @@
 #include "ManagedReferenceTest.h"
 
 #include "Mdk/Management/ManagedReference.h"
+#include "Mdk/Management/ManagedComponent.h"
+
+#include <cstdio>
 
 using namespace ::Smp::Mdk::Management;
 
@@ -41,6 +44,17 @@ class ComponentStub :
         ::std::string _desc;
 };
 
+class Provider :
+    public ::Smp::Mdk::Management::ManagedComponent
+{
+    public:
+        Provider(
+                ::Smp::String8 name) :
+            ManagedComponent(name, "Provider", NULL)
+        {
+        }
+};
+
 void ManagedReferenceTest::setUp(void)
 {
 }
@@ -135,3 +149,51 @@ void ManagedReferenceTest::testExceptions(void)
         delete ref1;
     }
 }
+
+void ManagedReferenceTest::testRename(void)
+{
+    // Both with a few providers, and with enough to hash the index.
+    const size_t counts[2] = { 3, 40 };
+
+    for (size_t c = 0; c < 2; ++c)
+    {
+        ManagedReference< Provider> ref1("Ref1", "ManagedReference 1", NULL);
+        ::std::vector< Provider*> providers;
+        char name[32];
+
+        for (size_t i = 0; i < counts[c]; ++i)
+        {
+            ::snprintf(name, sizeof(name), "Provider%u", static_cast< unsigned int>(i));
+            providers.push_back(new Provider(name));
+            ref1.AddComponent(providers[i]);
+        }
+
+        // Renamed providers are found under their new name only.
+        Provider* renamed = providers[1];
+        renamed->SetName("Renamed");
+        CPPUNIT_ASSERT(ref1.GetComponent("Renamed") == renamed);
+        CPPUNIT_ASSERT(ref1.GetComponent("Provider1") == NULL);
+        CPPUNIT_ASSERT(ref1.GetComponent("Provider0") == providers[0]);
+
+        // A provider renamed to the name of another one is shadowed, and
+        // the other becomes visible again once renamed away.
+        Provider* other = providers[2];
+        other->SetName("Renamed");
+        CPPUNIT_ASSERT(ref1.GetComponent("Renamed") == renamed);
+        renamed->SetName("Again");
+        CPPUNIT_ASSERT(ref1.GetComponent("Renamed") == other);
+        CPPUNIT_ASSERT(ref1.GetComponent("Again") == renamed);
+
+        // Providers renamed without a lookup can still be removed.
+        providers[0]->SetName("Removed");
+        ref1.RemoveComponent(providers[0]);
+        CPPUNIT_ASSERT_EQUAL(::Smp::Int64(counts[c] - 1), ref1.Count());
+        CPPUNIT_ASSERT(ref1.GetComponent("Removed") == NULL);
+        CPPUNIT_ASSERT(ref1.GetComponent("Again") == renamed);
+
+        for (size_t i = 0; i < providers.size(); ++i)
+        {
+            delete providers[i];
+        }
+    }
+}
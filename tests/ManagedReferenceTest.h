@@ -11,6 +11,7 @@ class ManagedReferenceTest :
             CPPUNIT_TEST(ManagedReferenceTest, testInstantiation)
             CPPUNIT_TEST(ManagedReferenceTest, testPublicInterface)
             CPPUNIT_TEST(ManagedReferenceTest, testExceptions)
+            CPPUNIT_TEST(ManagedReferenceTest, testRename)
         CPPUNIT_SUITE_END()
 
         void setUp(void);
@@ -19,6 +20,7 @@ class ManagedReferenceTest :
         void testInstantiation(void);
         void testPublicInterface(void);
         void testExceptions(void);
+        void testRename(void);
 };
 
 #endif // MANAGEDREFERENCETEST_H_
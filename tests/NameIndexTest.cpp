@@ -0,0 +1,197 @@
+#include "NameIndexTest.h"
+
+#include "Mdk/NameIndex.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace ::Smp::Mdk;
+
+class NamedItem
+{
+    public:
+        NamedItem(
+                ::Smp::String8 name) :
+            _name(name)
+        {
+        }
+
+        ::Smp::String8 GetName(void) const
+        {
+            return this->_name.c_str();
+        }
+
+        void SetName(
+                ::Smp::String8 name)
+        {
+            this->_name = name;
+        }
+
+    private:
+        ::std::string _name;
+};
+
+static void CreateItems(
+        ::std::vector< NamedItem*>& items,
+        size_t count)
+{
+    char name[32];
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ::snprintf(name, sizeof(name), "Item%lu", static_cast< unsigned long>(i));
+        items.push_back(new NamedItem(name));
+    }
+}
+
+static void DeleteItems(
+        ::std::vector< NamedItem*>& items)
+{
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        delete items[i];
+    }
+    items.clear();
+}
+
+void NameIndexTest::setUp(void)
+{
+}
+
+void NameIndexTest::tearDown(void)
+{
+}
+
+void NameIndexTest::testInsertFind(void)
+{
+    NameIndex< NamedItem> index;
+    ::std::vector< NamedItem*> items;
+    CreateItems(items, 1000);
+
+    CPPUNIT_ASSERT(index.Find("Item0") == NULL);
+    CPPUNIT_ASSERT(index.Find(NULL) == NULL);
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(true, index.Insert(items[i]));
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(1000), index.Count());
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(items[i], index.Find(items[i]->GetName()));
+    }
+
+    CPPUNIT_ASSERT(index.Find("Item1000") == NULL);
+    CPPUNIT_ASSERT(index.Find("") == NULL);
+
+    {
+        NamedItem dup("Item42");
+        CPPUNIT_ASSERT_EQUAL(false, index.Insert(&dup));
+        CPPUNIT_ASSERT_EQUAL(size_t(1000), index.Count());
+        CPPUNIT_ASSERT_EQUAL(items[42], index.Find("Item42"));
+    }
+
+    index.Clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), index.Count());
+    CPPUNIT_ASSERT(index.Find("Item0") == NULL);
+
+    DeleteItems(items);
+}
+
+void NameIndexTest::testRemove(void)
+{
+    NameIndex< NamedItem> index;
+    ::std::vector< NamedItem*> items;
+    CreateItems(items, 500);
+
+    index.Reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        index.Insert(items[i]);
+    }
+
+    for (size_t i = 0; i < items.size(); i += 2)
+    {
+        CPPUNIT_ASSERT_EQUAL(true, index.Remove(items[i]));
+    }
+    CPPUNIT_ASSERT_EQUAL(false, index.Remove(items[0]));
+    CPPUNIT_ASSERT_EQUAL(size_t(250), index.Count());
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        NamedItem* expected = ((i % 2) == 0) ? NULL : items[i];
+        CPPUNIT_ASSERT_EQUAL(expected, index.Find(items[i]->GetName()));
+    }
+
+    DeleteItems(items);
+}
+
+void NameIndexTest::testSmallIndex(void)
+{
+    NameIndex< NamedItem> index;
+    ::std::vector< NamedItem*> items;
+    const size_t limit = NameIndex< NamedItem>::SMALL_LIMIT;
+    CreateItems(items, limit + 1);
+
+    for (size_t i = 0; i < limit; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(true, index.Insert(items[i]));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(true, index.Remove(items[0]));
+    CPPUNIT_ASSERT(index.Find("Item0") == NULL);
+    CPPUNIT_ASSERT_EQUAL(items[1], index.Find("Item1"));
+    CPPUNIT_ASSERT_EQUAL(true, index.Insert(items[0]));
+
+    // Crossing the limit switches the index to a hash table.
+    CPPUNIT_ASSERT_EQUAL(true, index.Insert(items[limit]));
+    CPPUNIT_ASSERT_EQUAL(limit + 1, index.Count());
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(items[i], index.Find(items[i]->GetName()));
+        CPPUNIT_ASSERT_EQUAL(false, index.Insert(items[i]));
+    }
+
+    DeleteItems(items);
+}
+
+void NameIndexTest::testRekey(void)
+{
+    ::std::vector< NamedItem*> items;
+    CreateItems(items, 100);
+
+    // Both the small and the hashed index.
+    for (size_t count = 4; count <= items.size(); count += 96)
+    {
+        NameIndex< NamedItem> index;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            index.Insert(items[i]);
+        }
+
+        const ::std::string oldName(items[1]->GetName());
+        items[1]->SetName("Renamed");
+        CPPUNIT_ASSERT(index.Find("Renamed") == NULL);
+        CPPUNIT_ASSERT_EQUAL(true, index.Rekey(items[1], oldName.c_str()));
+        CPPUNIT_ASSERT_EQUAL(items[1], index.Find("Renamed"));
+        CPPUNIT_ASSERT(index.Find(oldName.c_str()) == NULL);
+        CPPUNIT_ASSERT_EQUAL(count, index.Count());
+
+        // The new name of an item must not be taken by another one.
+        items[2]->SetName("Renamed");
+        CPPUNIT_ASSERT_EQUAL(false, index.Rekey(items[2], "Item2"));
+        CPPUNIT_ASSERT_EQUAL(items[1], index.Find("Renamed"));
+        items[2]->SetName("Item2");
+        CPPUNIT_ASSERT_EQUAL(items[2], index.Find("Item2"));
+
+        CPPUNIT_ASSERT_EQUAL(true, index.Remove(items[1]));
+        CPPUNIT_ASSERT(index.Find("Renamed") == NULL);
+        items[1]->SetName(oldName.c_str());
+    }
+
+    DeleteItems(items);
+}
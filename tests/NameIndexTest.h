@@ -0,0 +1,26 @@
+#ifndef NAMEINDEXTEST_H_
+#define NAMEINDEXTEST_H_
+
+#include "BaseTest.h"
+
+class NameIndexTest :
+    public BaseTest
+{
+    public: 
+        CPPUNIT_SUITE_BEGIN(NameIndexTest)
+            CPPUNIT_TEST(NameIndexTest, testInsertFind)
+            CPPUNIT_TEST(NameIndexTest, testRemove)
+            CPPUNIT_TEST(NameIndexTest, testSmallIndex)
+            CPPUNIT_TEST(NameIndexTest, testRekey)
+        CPPUNIT_SUITE_END()
+
+        void setUp(void);
+        void tearDown(void);
+
+        void testInsertFind(void);
+        void testRemove(void);
+        void testSmallIndex(void);
+        void testRekey(void);
+};
+
+#endif // NAMEINDEXTEST_H_
@@ -72,3 +72,39 @@ void ObjectTest::testExceptions(void)
 
     CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
 }
+
+void ObjectTest::testValidateName(void)
+{
+    CPPUNIT_ASSERT_EQUAL(true, Object::ValidateName("a"));
+    CPPUNIT_ASSERT_EQUAL(true, Object::ValidateName("Name_1[2]"));
+    CPPUNIT_ASSERT_EQUAL(true, Object::ValidateName("abcdefghijklmnopqrstuvwxyzABCDEF"));
+    CPPUNIT_ASSERT_EQUAL(true, Object::ValidateName("Z0123456789_[]az"));
+
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName(NULL));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName(""));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("abcdefghijklmnopqrstuvwxyzABCDEFG"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("1abc"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("_abc"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("abc def"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("abcdefghijklmnop@"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("abc\\def"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("abc{"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("abc`"));
+    CPPUNIT_ASSERT_EQUAL(false, Object::ValidateName("abc\xe9"));
+
+    {
+        ::Smp::String8 names[] = { "Comp1", "Comp2", "Comp3" };
+        ::Smp::UInt32 firstInvalid = 0;
+
+        CPPUNIT_ASSERT_EQUAL(true, Object::ValidateNames(names, 3, &firstInvalid));
+        CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(3), firstInvalid);
+    }
+
+    {
+        ::Smp::String8 names[] = { "Comp1", "2Comp", "Comp3" };
+        ::Smp::UInt32 firstInvalid = 0;
+
+        CPPUNIT_ASSERT_EQUAL(false, Object::ValidateNames(names, 3, &firstInvalid));
+        CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), firstInvalid);
+    }
+}
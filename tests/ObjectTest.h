@@ -11,6 +11,7 @@ class ObjectTest :
             CPPUNIT_TEST(ObjectTest, testInstantiation)
             CPPUNIT_TEST(ObjectTest, testInterface)
             CPPUNIT_TEST(ObjectTest, testExceptions)
+            CPPUNIT_TEST(ObjectTest, testValidateName)
         CPPUNIT_SUITE_END()
 
         void setUp(void);
@@ -19,6 +20,7 @@ class ObjectTest :
         void testInstantiation(void);
         void testInterface(void);
         void testExceptions(void);
+        void testValidateName(void);
 };
 
 #endif // OBJECTTEST_H_
@@ -0,0 +1,643 @@
+#include "PublicationTest.h"
+
+#include "Mdk/Publication/Publication.h"
+#include "Mdk/Publication/Sampler.h"
+#include "Mdk/Publication/TypeRegistry.h"
+#include "Mdk/Uuid.h"
+#include "Mdk/Storage/MemoryStorageWriter.h"
+#include "Mdk/Storage/MemoryStorageReader.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace ::Smp::Mdk::Publication;
+
+struct Vector3
+{
+    ::Smp::Float64 x;
+    ::Smp::Float64 y;
+    ::Smp::Float64 z;
+};
+
+struct ModelState
+{
+    ::Smp::Int32 mode;
+    ::Smp::Int32 counter;
+    ::Smp::Float64 time;
+    Vector3 position;
+    Vector3 velocity;
+    ::Smp::Float64 scratch;
+    ::Smp::Float64 samples[16];
+    ::Smp::Bool enabled;
+};
+
+static void PublishState(
+        ::Smp::IPublication* receiver,
+        ModelState& state)
+{
+    receiver->PublishField("mode", "Mode", &state.mode);
+    receiver->PublishField("counter", "Counter", &state.counter);
+    receiver->PublishField("time", "Time", &state.time);
+
+    ::Smp::IPublication* position = receiver->PublishStructure("position", "Position");
+    position->PublishField("x", "X", &state.position.x);
+    position->PublishField("y", "Y", &state.position.y);
+    position->PublishField("z", "Z", &state.position.z);
+
+    ::Smp::IPublication* velocity = receiver->PublishArray("velocity", "Velocity");
+    velocity->PublishField("0", "X", &state.velocity.x);
+    velocity->PublishField("1", "Y", &state.velocity.y);
+    velocity->PublishField("2", "Z", &state.velocity.z);
+
+    receiver->PublishField("scratch", "Scratch", &state.scratch, true, false);
+    receiver->PublishArray("samples", "Samples", 16, state.samples, ::Smp::ST_Float64);
+    receiver->PublishField("enabled", "Enabled", &state.enabled);
+}
+
+void PublicationTest::setUp(void)
+{
+}
+
+void PublicationTest::tearDown(void)
+{
+}
+
+void PublicationTest::testPublishFields(void)
+{
+    ModelState state;
+    Publication publication;
+    PublishState(&publication, state);
+
+    const Publication::FieldCollection& fields = publication.GetFields();
+    CPPUNIT_ASSERT_EQUAL(size_t(12), fields.size());
+    CPPUNIT_ASSERT_EQUAL(::std::string("mode"), ::std::string(publication.GetFieldName(0)));
+    CPPUNIT_ASSERT_EQUAL(::std::string("position.y"), ::std::string(publication.GetFieldName(4)));
+    CPPUNIT_ASSERT_EQUAL(::std::string("velocity[2]"), ::std::string(publication.GetFieldName(8)));
+    CPPUNIT_ASSERT_EQUAL(::std::string("samples"), ::std::string(publication.GetFieldName(10)));
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(16), fields[10].count);
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_Float64, fields[10].type);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt8(Publication::FIELD_VIEW | Publication::FIELD_STATE |
+                Publication::FIELD_ARRAY), fields[10].flags);
+    CPPUNIT_ASSERT(fields[9].address == &state.scratch);
+    CPPUNIT_ASSERT_EQUAL(Publication::FIELD_VIEW, fields[9].flags);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt8(Publication::FIELD_VIEW | Publication::FIELD_STATE),
+            fields[0].flags);
+
+    // Nested publications add to the fields of the one they come from.
+    ::Smp::IPublication* outer = publication.PublishStructure("outer", "Outer");
+    ::Smp::IPublication* inner = outer->PublishArray("inner", "Inner");
+    inner->PublishField("3", "Item", &state.counter);
+    CPPUNIT_ASSERT_EQUAL(::std::string("outer.inner[3]"),
+            ::std::string(publication.GetFieldName(fields.size() - 1)));
+
+    bool exceptionCatched = false;
+    try
+    {
+        publication.PublishArray("strings", "Strings", 4, state.samples, ::Smp::ST_String8);
+    }
+    catch (::Smp::Publication::InvalidFieldType& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // Fields of a registered type need a type registry.
+    exceptionCatched = false;
+    try
+    {
+        publication.PublishField("typed", "Typed", &state.position,
+                ::Smp::Publication::Uuid_Float64);
+    }
+    catch (::Smp::Publication::NotRegistered& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+}
+
+void PublicationTest::testStatePlan(void)
+{
+    ModelState state;
+    Publication publication;
+    PublishState(&publication, state);
+
+    // mode to velocity, and samples to enabled, are contiguous runs;
+    // scratch is not state and splits them.
+    StatePlan& plan = publication.GetStatePlan();
+    plan.Compile();
+    CPPUNIT_ASSERT_EQUAL(size_t(2), plan.GetRunCount());
+    CPPUNIT_ASSERT_EQUAL(sizeof(ModelState) - sizeof(::Smp::Float64) -
+            (sizeof(ModelState) - offsetof(ModelState, enabled) - sizeof(::Smp::Bool)),
+            plan.GetSize());
+
+    state.mode = 3;
+    state.counter = 42;
+    state.time = 1.5;
+    state.position.y = 2.0;
+    state.velocity.z = -1.0;
+    state.scratch = 7.0;
+    state.samples[15] = 8.0;
+    state.enabled = true;
+
+    ::Smp::Mdk::Storage::MemoryStorageWriter writer;
+    publication.StoreState(&writer);
+    CPPUNIT_ASSERT_EQUAL(plan.GetSize(), writer.GetSize());
+
+    ModelState saved = state;
+    state.mode = 0;
+    state.counter = 0;
+    state.position.y = 0.0;
+    state.velocity.z = 0.0;
+    state.scratch = 0.0;
+    state.samples[15] = 0.0;
+    state.enabled = false;
+
+    ::Smp::Mdk::Storage::MemoryStorageReader reader(writer.GetData(), writer.GetSize());
+    publication.RestoreState(&reader);
+    CPPUNIT_ASSERT_EQUAL(saved.mode, state.mode);
+    CPPUNIT_ASSERT_EQUAL(saved.counter, state.counter);
+    CPPUNIT_ASSERT_EQUAL(saved.position.y, state.position.y);
+    CPPUNIT_ASSERT_EQUAL(saved.velocity.z, state.velocity.z);
+    CPPUNIT_ASSERT_EQUAL(saved.samples[15], state.samples[15]);
+    CPPUNIT_ASSERT_EQUAL(saved.enabled, state.enabled);
+    CPPUNIT_ASSERT_EQUAL(0.0, state.scratch);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reader.GetRemaining());
+
+    // Overlapping runs are stored once, and runs are only merged with the
+    // one added before them.
+    StatePlan overlapping;
+    overlapping.Add(&state.time, sizeof(state.time));
+    overlapping.Add(&state.position, sizeof(state.position));
+    overlapping.Add(&state.position.y, sizeof(state.position.y));
+    overlapping.Compile();
+    CPPUNIT_ASSERT_EQUAL(size_t(1), overlapping.GetRunCount());
+    CPPUNIT_ASSERT_EQUAL(sizeof(state.time) + sizeof(state.position), overlapping.GetSize());
+
+    StatePlan reversed;
+    reversed.Add(&state.position, sizeof(state.position));
+    reversed.Add(&state.time, sizeof(state.time));
+    reversed.Compile();
+    CPPUNIT_ASSERT_EQUAL(size_t(2), reversed.GetRunCount());
+
+    // The stream follows the order of publication, so it can be restored
+    // where the fields are allocated in another order.
+    ::Smp::Float64 stored[2] = { 1.0, 2.0 };
+    ::Smp::Int32 storedCount = 3;
+    Publication storing;
+    storing.PublishField("first", "First", &stored[0]);
+    storing.PublishField("count", "Count", &storedCount);
+    storing.PublishField("second", "Second", &stored[1]);
+
+    ::Smp::Mdk::Storage::MemoryStorageWriter ordered;
+    storing.StoreState(&ordered);
+
+    ::Smp::Float64 restored[2] = { 0.0, 0.0 };
+    ::Smp::Int32 restoredCount = 0;
+    Publication restoring;
+    restoring.PublishField("first", "First", &restored[1]);
+    restoring.PublishField("count", "Count", &restoredCount);
+    restoring.PublishField("second", "Second", &restored[0]);
+
+    ::Smp::Mdk::Storage::MemoryStorageReader orderedReader(ordered.GetData(), ordered.GetSize());
+    restoring.RestoreState(&orderedReader);
+    CPPUNIT_ASSERT_EQUAL(1.0, restored[1]);
+    CPPUNIT_ASSERT_EQUAL(3, restoredCount);
+    CPPUNIT_ASSERT_EQUAL(2.0, restored[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), orderedReader.GetRemaining());
+}
+
+void PublicationTest::testFieldAccess(void)
+{
+    ModelState state;
+    Publication publication;
+    PublishState(&publication, state);
+
+    state.position.y = 2.5;
+    state.samples[3] = 4.0;
+
+    CPPUNIT_ASSERT_EQUAL(size_t(4), publication.FindField("position.y"));
+    CPPUNIT_ASSERT_EQUAL(Publication::NPOS, publication.FindField("position"));
+    CPPUNIT_ASSERT_EQUAL(Publication::NPOS, publication.FindField("position.w"));
+
+    ::Smp::AnySimple value = publication.GetFieldValue("position.y");
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_Float64, value.type);
+    CPPUNIT_ASSERT_EQUAL(2.5, value.value.float64Value);
+
+    value.value.float64Value = -3.0;
+    publication.SetFieldValue("velocity[1]", value);
+    CPPUNIT_ASSERT_EQUAL(-3.0, state.velocity.y);
+
+    // Items of arrays of simple type are accessed by index.
+    value = publication.GetFieldValue("samples[3]");
+    CPPUNIT_ASSERT_EQUAL(4.0, value.value.float64Value);
+    value.value.float64Value = 5.0;
+    publication.SetFieldValue("samples[15]", value);
+    CPPUNIT_ASSERT_EQUAL(5.0, state.samples[15]);
+
+    ::Smp::String8 invalidNames[] = {
+        "position", "samples", "samples[16]", "samples[-1]", "samples[x]",
+        "mode[0]", "unknown" };
+    for (size_t i = 0; i < sizeof(invalidNames) / sizeof(invalidNames[0]); ++i)
+    {
+        bool exceptionCatched = false;
+        try
+        {
+            publication.GetFieldValue(invalidNames[i]);
+        }
+        catch (::Smp::Management::IManagedModel::InvalidFieldName& ex)
+        {
+            exceptionCatched = true;
+        }
+        CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+    }
+
+    bool exceptionCatched = false;
+    try
+    {
+        ::Smp::AnySimple wrongType;
+        wrongType.type = ::Smp::ST_Int32;
+        wrongType.value.int32Value = 1;
+        publication.SetFieldValue("time", wrongType);
+    }
+    catch (::Smp::Management::IManagedModel::InvalidFieldValue& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    ::Smp::AnySimple values[16];
+    publication.GetArrayValue("samples", values, 16);
+    CPPUNIT_ASSERT_EQUAL(4.0, values[3].value.float64Value);
+    values[0].value.float64Value = 9.0;
+    publication.SetArrayValue("samples", values, 16);
+    CPPUNIT_ASSERT_EQUAL(9.0, state.samples[0]);
+
+    exceptionCatched = false;
+    try
+    {
+        publication.GetArrayValue("samples", values, 8);
+    }
+    catch (::Smp::Management::IManagedModel::InvalidArraySize& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    exceptionCatched = false;
+    values[5].type = ::Smp::ST_Int64;
+    try
+    {
+        publication.SetArrayValue("samples", values, 16);
+    }
+    catch (::Smp::Management::IManagedModel::InvalidArrayValue& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+    CPPUNIT_ASSERT_EQUAL(9.0, state.samples[0]);
+
+    // Lookups stay direct with many fields.
+    const size_t count = 100000;
+    ::std::vector< ::Smp::Int32> many(count);
+    ::Smp::IPublication* table = publication.PublishStructure("table", "Table");
+    char name[32];
+    for (size_t i = 0; i < count; ++i)
+    {
+        ::sprintf(name, "f%u", static_cast< unsigned int>(i));
+        table->PublishField(name, "Field", &many[i]);
+        many[i] = static_cast< ::Smp::Int32>(i);
+    }
+    for (size_t i = 0; i < count; i += 997)
+    {
+        ::sprintf(name, "table.f%u", static_cast< unsigned int>(i));
+        CPPUNIT_ASSERT_EQUAL(::Smp::Int32(i), publication.GetFieldValue(name).value.int32Value);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(4), publication.FindField("position.y"));
+}
+
+void PublicationTest::testFieldHandles(void)
+{
+    ModelState state;
+    Publication publication;
+    PublishState(&publication, state);
+
+    FieldHandle counter = publication.Resolve("counter");
+    CPPUNIT_ASSERT_EQUAL(true, counter.IsValid());
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_Int32, counter.GetType());
+    CPPUNIT_ASSERT(counter.GetAddress< ::Smp::Int32>() == &state.counter);
+    CPPUNIT_ASSERT(counter.GetAddress< ::Smp::Float64>() == NULL);
+
+    counter.Set< ::Smp::Int32>(7);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int32(7), state.counter);
+    state.counter = 8;
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int32(8), counter.Get< ::Smp::Int32>());
+
+    // Items of arrays of simple type resolve to the item.
+    FieldHandle sample = publication.Resolve("samples[5]");
+    CPPUNIT_ASSERT(sample.GetAddress< ::Smp::Float64>() == &state.samples[5]);
+
+    ::Smp::AnySimple value = sample.GetValue();
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_Float64, value.type);
+    value.value.float64Value = 1.25;
+    CPPUNIT_ASSERT_EQUAL(true, sample.SetValue(value));
+    CPPUNIT_ASSERT_EQUAL(1.25, state.samples[5]);
+    CPPUNIT_ASSERT_EQUAL(false, counter.SetValue(value));
+
+    FieldHandle invalid = publication.Resolve("samples");
+    CPPUNIT_ASSERT_EQUAL(false, invalid.IsValid());
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_None, invalid.GetType());
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_None, invalid.GetValue().type);
+    CPPUNIT_ASSERT_EQUAL(false, publication.Resolve("unknown").IsValid());
+    CPPUNIT_ASSERT_EQUAL(false, FieldHandle().IsValid());
+}
+
+struct Body
+{
+    ::Smp::Int32 id;
+    Vector3 position;
+    ::Smp::Char8 label[9];
+};
+
+struct Vehicle
+{
+    Body body;
+    ::Smp::Float64 mass;
+    Vector3 wheels[2];
+};
+
+static const ::Smp::Mdk::Uuid VECTOR3_UUID("11111111-0000-0000-0000-000000000001");
+static const ::Smp::Mdk::Uuid LABEL_UUID("11111111-0000-0000-0000-000000000002");
+static const ::Smp::Mdk::Uuid BODY_UUID("11111111-0000-0000-0000-000000000003");
+static const ::Smp::Mdk::Uuid WHEELS_UUID("11111111-0000-0000-0000-000000000004");
+static const ::Smp::Mdk::Uuid VEHICLE_UUID("11111111-0000-0000-0000-000000000005");
+
+static void RegisterVehicle(
+        TypeRegistry& registry)
+{
+    ::Smp::Publication::IStructureType* vector3 =
+        registry.AddStructureType("Vector3", "Vector", VECTOR3_UUID);
+    vector3->AddField("x", "X", ::Smp::Publication::Uuid_Float64, offsetof(Vector3, x));
+    vector3->AddField("y", "Y", ::Smp::Publication::Uuid_Float64, offsetof(Vector3, y));
+    vector3->AddField("z", "Z", ::Smp::Publication::Uuid_Float64, offsetof(Vector3, z));
+    registry.AddStringType("Label", "Label", LABEL_UUID, 8);
+
+    ::Smp::Publication::IStructureType* body = registry.AddClassType("Body", "Body", BODY_UUID,
+            ::Smp::Mdk::NullUuid);
+    body->AddField("id", "Id", ::Smp::Publication::Uuid_Int32, offsetof(Body, id));
+    body->AddField("position", "Position", VECTOR3_UUID, offsetof(Body, position));
+    body->AddField("label", "Label", LABEL_UUID, offsetof(Body, label), true, false);
+
+    registry.AddArrayType("Wheels", "Wheels", WHEELS_UUID, VECTOR3_UUID, sizeof(Vector3), 2);
+    ::Smp::Publication::IStructureType* vehicle = registry.AddClassType("Vehicle", "Vehicle",
+            VEHICLE_UUID, BODY_UUID);
+    vehicle->AddField("mass", "Mass", ::Smp::Publication::Uuid_Float64,
+            offsetof(Vehicle, mass) - offsetof(Vehicle, body));
+    vehicle->AddField("wheels", "Wheels", WHEELS_UUID,
+            offsetof(Vehicle, wheels) - offsetof(Vehicle, body));
+}
+
+void PublicationTest::testTypeRegistry(void)
+{
+    TypeRegistry registry;
+    CPPUNIT_ASSERT_EQUAL(size_t(16), registry.GetTypeCount());
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_Float64, registry.GetType(::Smp::ST_Float64)->GetSimpleType());
+    CPPUNIT_ASSERT(registry.GetType(::Smp::Publication::Uuid_Float64) ==
+            registry.GetType(::Smp::ST_Float64));
+
+    RegisterVehicle(registry);
+    const ::Smp::Mdk::Uuid vector3Uuid(VECTOR3_UUID);
+    const ::Smp::Mdk::Uuid vehicleUuid(VEHICLE_UUID);
+    ::Smp::Publication::IType* vector3 = registry.GetType(vector3Uuid);
+    CPPUNIT_ASSERT(vector3 != NULL);
+
+    bool exceptionCatched = false;
+    try
+    {
+        registry.AddIntegerType("Other", "Other", vector3Uuid, 0, 10);
+    }
+    catch (::Smp::Publication::AlreadyRegistered& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // Types publish their fields through the publication.
+    Vehicle car;
+    Publication publication(&registry);
+    publication.PublishField("car", "Car", &car, vehicleUuid);
+
+    CPPUNIT_ASSERT(publication.Resolve("car.id").GetAddress< ::Smp::Int32>() == &car.body.id);
+    CPPUNIT_ASSERT(publication.Resolve("car.position.z").GetAddress< ::Smp::Float64>() ==
+            &car.body.position.z);
+    CPPUNIT_ASSERT(publication.Resolve("car.label[3]").GetAddress< ::Smp::Char8>() ==
+            &car.body.label[3]);
+    CPPUNIT_ASSERT(publication.Resolve("car.mass").GetAddress< ::Smp::Float64>() == &car.mass);
+    CPPUNIT_ASSERT(publication.Resolve("car.wheels[1].y").GetAddress< ::Smp::Float64>() ==
+            &car.wheels[1].y);
+
+    const size_t label = publication.FindField("car.label");
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(9), publication.GetFields()[label].count);
+    CPPUNIT_ASSERT_EQUAL(0, publication.GetFields()[label].flags & Publication::FIELD_STATE);
+
+    // Registration stays linear with many generated types.
+    const size_t count = 20000;
+    registry.Reserve(registry.GetTypeCount() + count);
+    ::Smp::Mdk::Uuid uuid("22222222-0000-0000-0000-000000000000");
+    char name[32];
+    for (size_t i = 0; i < count; ++i)
+    {
+        uuid.Data4[6] = static_cast< ::Smp::UInt8>(i >> 8);
+        uuid.Data4[7] = static_cast< ::Smp::UInt8>(i);
+        uuid.Data3 = static_cast< ::Smp::UInt16>(i >> 16);
+        ::sprintf(name, "Generated%u", static_cast< unsigned int>(i));
+        registry.AddIntegerType(name, "Generated", uuid, 0, 100, ::Smp::ST_Int16);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(16 + 5 + count), registry.GetTypeCount());
+    uuid.Data3 = 0;
+    uuid.Data4[6] = 0x12;
+    uuid.Data4[7] = 0x34;
+    CPPUNIT_ASSERT_EQUAL(::std::string("Generated4660"),
+            ::std::string(registry.GetType(uuid)->GetName()));
+    CPPUNIT_ASSERT(registry.GetType(vector3Uuid) == vector3);
+
+    exceptionCatched = false;
+    try
+    {
+        publication.PublishField("unknown", "Unknown", &car,
+                ::Smp::Mdk::Uuid("33333333-0000-0000-0000-000000000000"));
+    }
+    catch (::Smp::Publication::NotRegistered& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+}
+
+void PublicationTest::testLayout(void)
+{
+    TypeRegistry registry;
+    RegisterVehicle(registry);
+
+    const Type* type = dynamic_cast< const Type*>(registry.GetType(VEHICLE_UUID));
+    CPPUNIT_ASSERT(type != NULL);
+
+    // id, position.{x,y,z}, label, mass, wheels[0..1].{x,y,z}.
+    const Layout& layout = type->GetLayout();
+    CPPUNIT_ASSERT(&layout == &type->GetLayout());
+    CPPUNIT_ASSERT_EQUAL(size_t(12), layout.GetEntries().size());
+    CPPUNIT_ASSERT_EQUAL(::std::string(".id"), ::std::string(layout.GetEntryName(0)));
+    CPPUNIT_ASSERT_EQUAL(::std::string(".position.y"), ::std::string(layout.GetEntryName(2)));
+    CPPUNIT_ASSERT_EQUAL(::std::string(".wheels[1].z"), ::std::string(layout.GetEntryName(11)));
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(offsetof(Vehicle, wheels[1].z)),
+            layout.GetEntries()[11].offset);
+
+    // Padding after the id and the label, which is not state, split the
+    // state in three runs.
+    CPPUNIT_ASSERT_EQUAL(size_t(3), layout.GetStateRuns().size());
+    CPPUNIT_ASSERT_EQUAL(sizeof(::Smp::Int32) + (10 * sizeof(::Smp::Float64)),
+            layout.GetStateSize());
+
+    // All instances share the layout.
+    Vehicle car;
+    Vehicle truck;
+    memset(&car, 0, sizeof(car));
+    memset(&truck, 0, sizeof(truck));
+    Publication publication(&registry);
+    publication.PublishField("car", "Car", &car, VEHICLE_UUID);
+    publication.PublishField("truck", "Truck", &truck, VEHICLE_UUID, true, false);
+    CPPUNIT_ASSERT_EQUAL(size_t(24), publication.GetFields().size());
+    publication.GetStatePlan().Compile();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), publication.GetStatePlan().GetRunCount());
+    CPPUNIT_ASSERT(publication.Resolve("truck.wheels[0].x").GetAddress< ::Smp::Float64>() ==
+            &truck.wheels[0].x);
+
+    // Compare, store and restore instances through the layout.
+    CPPUNIT_ASSERT_EQUAL(Layout::NPOS, layout.Compare(&car, &truck));
+    truck.mass = 1200.0;
+    CPPUNIT_ASSERT_EQUAL(size_t(5), layout.Compare(&car, &truck));
+
+    ::Smp::Mdk::Storage::MemoryStorageWriter writer;
+    layout.Store(&writer, &truck);
+    CPPUNIT_ASSERT_EQUAL(layout.GetStateSize(), static_cast< size_t>(writer.GetSize()));
+
+    ::strcpy(car.body.label, "car");
+    ::Smp::Mdk::Storage::MemoryStorageReader reader(writer.GetData(), writer.GetSize());
+    layout.Restore(&reader, &car);
+    CPPUNIT_ASSERT_EQUAL(1200.0, car.mass);
+    CPPUNIT_ASSERT_EQUAL(::std::string("car"), ::std::string(car.body.label));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), layout.Compare(&car, &truck));
+
+    // Changing a type rebuilds the layouts of the types made of it.
+    ::Smp::Publication::IStructureType* vector3 = dynamic_cast< ::Smp::Publication::IStructureType*>(
+            registry.GetType(VECTOR3_UUID));
+    CPPUNIT_ASSERT(vector3 != NULL);
+    vector3->AddField("norm", "Norm", ::Smp::Publication::Uuid_Float64, offsetof(Vector3, x),
+            true, false);
+
+    const Layout& changed = type->GetLayout();
+    CPPUNIT_ASSERT_EQUAL(size_t(15), changed.GetEntries().size());
+    CPPUNIT_ASSERT_EQUAL(::std::string(".position.norm"), ::std::string(changed.GetEntryName(4)));
+    CPPUNIT_ASSERT_EQUAL(sizeof(::Smp::Int32) + (10 * sizeof(::Smp::Float64)),
+            changed.GetStateSize());
+}
+
+void PublicationTest::testSampler(void)
+{
+    ModelState state;
+    Publication publication;
+    PublishState(&publication, state);
+
+    Sampler sampler("Sampler", 4, 1000000);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), sampler.Add(publication, "counter"));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), sampler.Add(publication, "position.y"));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), sampler.Add(publication, "enabled"));
+    CPPUNIT_ASSERT_EQUAL(Sampler::NPOS, sampler.Add(publication, "unknown"));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), sampler.GetColumnCount());
+    CPPUNIT_ASSERT_EQUAL(::Smp::ST_Float64, sampler.GetColumnType(1));
+
+    Sampler::Consumer display(sampler);
+    Sampler::Block block;
+    CPPUNIT_ASSERT_EQUAL(false, display.Next(block));
+
+    for (::Smp::Int32 i = 0; i < 3; ++i) {
+        state.counter = i;
+        state.position.y = 0.5 * i;
+        state.enabled = ((i % 2) == 0);
+        sampler.Sample(1000000 * i);
+    }
+
+    // Consumers read the rows in place.
+    CPPUNIT_ASSERT_EQUAL(true, display.Next(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(0), block.first);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), block.count);
+    CPPUNIT_ASSERT(sampler.GetColumn< ::Smp::Float64>(0, block) == NULL);
+    const ::Smp::Int32* counters = sampler.GetColumn< ::Smp::Int32>(0, block);
+    const ::Smp::Float64* ys = sampler.GetColumn< ::Smp::Float64>(1, block);
+    const ::Smp::Bool* enabled = sampler.GetColumn< ::Smp::Bool>(2, block);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Duration(2000000), sampler.GetTimes(block)[2]);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int32(2), counters[2]);
+    CPPUNIT_ASSERT_EQUAL(0.5, ys[1]);
+    CPPUNIT_ASSERT_EQUAL(false, enabled[1]);
+    CPPUNIT_ASSERT_EQUAL(true, display.IsValid(block));
+    CPPUNIT_ASSERT_EQUAL(false, display.Next(block));
+
+    // Once the ring is full, the oldest rows are overwritten.
+    Sampler::Consumer recorder(sampler);
+    for (::Smp::Int32 i = 3; i < 7; ++i) {
+        state.counter = i;
+        sampler.Sample(1000000 * i);
+    }
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(3), sampler.GetFirst());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(7), sampler.GetEnd());
+
+    // Rows 3 to 6 wrap around the end of the columns.
+    CPPUNIT_ASSERT_EQUAL(true, display.Next(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(3), block.first);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), block.count);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int32(3), sampler.GetColumn< ::Smp::Int32>(0, block)[0]);
+    CPPUNIT_ASSERT_EQUAL(true, display.Next(block));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), block.count);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int32(6), sampler.GetColumn< ::Smp::Int32>(0, block)[2]);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(0), display.GetLost());
+
+    // The recorder started at row 0, of which 0 to 2 were lost.
+    CPPUNIT_ASSERT_EQUAL(true, recorder.Next(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(3), recorder.GetLost());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(3), block.first);
+    sampler.Sample(7000000);
+    CPPUNIT_ASSERT_EQUAL(false, recorder.IsValid(block));
+
+    // Clearing keeps numbering rows on, so that a block read before the
+    // clear is no longer valid and the cleared rows count as lost.
+    CPPUNIT_ASSERT_EQUAL(true, display.Next(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(7), block.first);
+    sampler.Clear();
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(8), sampler.GetFirst());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(8), sampler.GetEnd());
+    CPPUNIT_ASSERT_EQUAL(false, display.IsValid(block));
+    CPPUNIT_ASSERT_EQUAL(false, display.Next(block));
+
+    state.counter = 8;
+    sampler.Sample(0);
+    CPPUNIT_ASSERT_EQUAL(true, display.Next(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(8), block.first);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), block.count);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int32(8), sampler.GetColumn< ::Smp::Int32>(0, block)[0]);
+    CPPUNIT_ASSERT_EQUAL(true, display.IsValid(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(0), display.GetLost());
+
+    // The recorder still had rows 4 to 7 to read.
+    CPPUNIT_ASSERT_EQUAL(true, recorder.Next(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(8), block.first);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(7), recorder.GetLost());
+
+    // A full ring after a clear overwrites its own rows only.
+    for (::Smp::Int32 i = 9; i < 14; ++i) {
+        state.counter = i;
+        sampler.Sample(1000000 * i);
+    }
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(10), sampler.GetFirst());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt64(14), sampler.GetEnd());
+}
@@ -0,0 +1,32 @@
+#ifndef PUBLICATIONTEST_H_
+#define PUBLICATIONTEST_H_
+
+#include "BaseTest.h"
+
+class PublicationTest :
+    public BaseTest
+{
+    public: 
+        CPPUNIT_SUITE_BEGIN(PublicationTest)
+            CPPUNIT_TEST(PublicationTest, testPublishFields)
+            CPPUNIT_TEST(PublicationTest, testStatePlan)
+            CPPUNIT_TEST(PublicationTest, testFieldAccess)
+            CPPUNIT_TEST(PublicationTest, testFieldHandles)
+            CPPUNIT_TEST(PublicationTest, testTypeRegistry)
+            CPPUNIT_TEST(PublicationTest, testLayout)
+            CPPUNIT_TEST(PublicationTest, testSampler)
+        CPPUNIT_SUITE_END()
+
+        void setUp(void);
+        void tearDown(void);
+
+        void testPublishFields(void);
+        void testStatePlan(void);
+        void testFieldAccess(void);
+        void testFieldHandles(void);
+        void testTypeRegistry(void);
+        void testLayout(void);
+        void testSampler(void);
+};
+
+#endif // PUBLICATIONTEST_H_
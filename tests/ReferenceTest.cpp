@@ -49,8 +49,9 @@ class ReferenceSubclass :
         ReferenceSubclass(
                 ::Smp::String8 name,
                 ::Smp::String8 desc,
-                ::Smp::IComponent* parent) :
-            Reference< T>(name, desc, parent)
+                ::Smp::IComponent* parent,
+                ::Smp::Bool preserveOrder = false) :
+            Reference< T>(name, desc, parent, preserveOrder)
         {
         }
 
@@ -151,3 +152,60 @@ void ReferenceTest::testExceptions(void)
 //    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
 }
 
+
+void ReferenceTest::testRemoval(void)
+{
+    ComponentStub* comps[4] = {
+        new ComponentStub("Comp0", "Comp 0", NULL),
+        new ComponentStub("Comp1", "Comp 1", NULL),
+        new ComponentStub("Comp2", "Comp 2", NULL),
+        new ComponentStub("Comp1", "Other Comp 1", NULL) };
+
+    {
+        ReferenceSubclass< ComponentStub> ref1("Ref1", "Ref 1", NULL);
+
+        for (int i = 0; i < 4; ++i) {
+            ref1.AddPublic(comps[i]);
+        }
+        ref1.AddPublic(comps[0]);
+        CPPUNIT_ASSERT_EQUAL(::Smp::Int64(4), ref1.Count());
+
+        CPPUNIT_ASSERT(ref1.GetComponent("Comp1") == comps[1]);
+        CPPUNIT_ASSERT(ref1.GetComponent("Comp3") == NULL);
+
+        // The last provider takes the place of the removed one.
+        CPPUNIT_ASSERT_EQUAL(true, ref1.RemovePublic(comps[1]));
+        CPPUNIT_ASSERT_EQUAL(false, ref1.RemovePublic(comps[1]));
+        CPPUNIT_ASSERT_EQUAL(::Smp::Int64(3), ref1.Count());
+        CPPUNIT_ASSERT_EQUAL(comps[3], ref1.At(1));
+        CPPUNIT_ASSERT(ref1.GetComponent("Comp1") == comps[3]);
+
+        CPPUNIT_ASSERT_EQUAL(true, ref1.RemovePublic(comps[0]));
+        CPPUNIT_ASSERT_EQUAL(comps[2], ref1.At(0));
+        CPPUNIT_ASSERT(ref1.GetComponent("Comp0") == NULL);
+        CPPUNIT_ASSERT(ref1.GetComponent("Comp2") == comps[2]);
+    }
+
+    {
+        ReferenceSubclass< ComponentStub> ref2("Ref2", "Ref 2", NULL, true);
+
+        for (int i = 0; i < 4; ++i) {
+            ref2.AddPublic(comps[i]);
+        }
+
+        CPPUNIT_ASSERT_EQUAL(true, ref2.RemovePublic(comps[0]));
+        CPPUNIT_ASSERT_EQUAL(comps[1], ref2.At(0));
+        CPPUNIT_ASSERT_EQUAL(comps[2], ref2.At(1));
+        CPPUNIT_ASSERT_EQUAL(comps[3], ref2.At(2));
+
+        CPPUNIT_ASSERT_EQUAL(true, ref2.RemovePublic(comps[2]));
+        CPPUNIT_ASSERT_EQUAL(comps[3], ref2.At(1));
+        CPPUNIT_ASSERT_EQUAL(true, ref2.RemovePublic(comps[3]));
+        CPPUNIT_ASSERT_EQUAL(true, ref2.RemovePublic(comps[1]));
+        CPPUNIT_ASSERT_EQUAL(::Smp::Int64(0), ref2.Count());
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        delete comps[i];
+    }
+}
@@ -11,6 +11,7 @@ class ReferenceTest :
             CPPUNIT_TEST(ReferenceTest, testInstantiation)
             CPPUNIT_TEST(ReferenceTest, testPublicInterface)
             CPPUNIT_TEST(ReferenceTest, testExceptions)
+            CPPUNIT_TEST(ReferenceTest, testRemoval)
         CPPUNIT_SUITE_END()
 
         void setUp(void);
@@ -19,6 +20,7 @@ class ReferenceTest :
         void testInstantiation(void);
         void testPublicInterface(void);
         void testExceptions(void);
+        void testRemoval(void);
 };
 
 #endif // REFERENCETEST_H_
@@ -0,0 +1,306 @@
+#include "ResolverTest.h"
+
+#include "Mdk/Services/Resolver.h"
+#include "Mdk/Composite.h"
+#include "Mdk/Aggregate.h"
+#include "Mdk/Management/ManagedComponent.h"
+#include "Mdk/Management/ManagedContainer.h"
+#include "Mdk/Management/ManagedReference.h"
+
+using namespace ::Smp::Mdk::Services;
+using namespace ::Smp::Mdk::Management;
+
+class ResolverComposite :
+    public ::Smp::Mdk::Management::ManagedComponent,
+    public ::Smp::Mdk::Composite
+{
+    public:
+        ResolverComposite(
+                ::Smp::String8 name,
+                ::Smp::String8 desc,
+                ::Smp::IComposite* parent) :
+            ManagedComponent(name, desc, parent),
+            m_children("Children", "Children", this)
+        {
+            AddContainer(&this->m_children);
+        }
+
+        virtual ~ResolverComposite(void)
+        {
+        }
+
+        ManagedContainer< ManagedComponent>* GetChildren(void)
+        {
+            return &this->m_children;
+        }
+
+    private:
+        ManagedContainer< ManagedComponent> m_children;
+};
+
+class ResolverAggregate :
+    public ::Smp::Mdk::Management::ManagedComponent,
+    public ::Smp::Mdk::Aggregate
+{
+    public:
+        ResolverAggregate(
+                ::Smp::String8 name,
+                ::Smp::String8 desc,
+                ::Smp::IComposite* parent) :
+            ManagedComponent(name, desc, parent),
+            m_links("Links", "Links", this)
+        {
+            AddReference(&this->m_links);
+        }
+
+        virtual ~ResolverAggregate(void)
+        {
+        }
+
+        ManagedReference< ManagedComponent>* GetLinks(void)
+        {
+            return &this->m_links;
+        }
+
+    private:
+        ManagedReference< ManagedComponent> m_links;
+};
+
+void ResolverTest::setUp(void)
+{
+}
+
+void ResolverTest::tearDown(void)
+{
+}
+
+void ResolverTest::testResolveAbsolute(void)
+{
+    ResolverComposite* root = new ResolverComposite("Root", "Root", NULL);
+    ResolverComposite* sub = new ResolverComposite("Sub", "Sub", NULL);
+    ManagedComponent* leaf = new ManagedComponent("Leaf", "Leaf", NULL);
+    root->GetChildren()->AddComponent(sub);
+    sub->GetChildren()->AddComponent(leaf);
+
+    Resolver resolver("Resolver", "Resolver", NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root") == NULL);
+
+    resolver.AddRoot(root);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root") == root);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("/Root") == root);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Sub") == sub);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute(leaf->GetPath()) == leaf);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("/Root/Children/Sub/Children/Leaf") == leaf);
+
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute(NULL) == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("") == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Roo") == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children") == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Child/Sub") == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Su") == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root//Children/Sub") == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Sub/Children/Leaf/Children/Leaf") == NULL);
+
+    ManagedComponent other("Root", "Other root", NULL);
+    bool exceptionCatched = false;
+    try
+    {
+        resolver.AddRoot(&other);
+    }
+    catch (::Smp::DuplicateName& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // Renamed components are found under their new name only.
+    sub->SetName("Renamed");
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Renamed") == sub);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Renamed/Children/Leaf") == leaf);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Sub") == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute(leaf->GetPath()) == leaf);
+
+    delete root;
+}
+
+void ResolverTest::testResolveRelative(void)
+{
+    ResolverComposite* root = new ResolverComposite("Root", "Root", NULL);
+    ResolverComposite* sub1 = new ResolverComposite("Sub1", "Sub 1", NULL);
+    ResolverComposite* sub2 = new ResolverComposite("Sub2", "Sub 2", NULL);
+    ManagedComponent* leaf = new ManagedComponent("Leaf", "Leaf", NULL);
+    root->GetChildren()->AddComponent(sub1);
+    root->GetChildren()->AddComponent(sub2);
+    sub2->GetChildren()->AddComponent(leaf);
+
+    Resolver resolver("Resolver", "Resolver", NULL);
+
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Children/Sub1", root) == sub1);
+    CPPUNIT_ASSERT(resolver.ResolveRelative(".", sub1) == sub1);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("..", sub1) == root);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("../Children/Sub2/Children/Leaf", sub1) == leaf);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("./../../Children/Sub1", leaf) == sub1);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("../../..", leaf) == NULL);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Children/Sub1", NULL) == NULL);
+
+    // The same path is resolved differently from different senders.
+    CPPUNIT_ASSERT(resolver.ResolveRelative("..", leaf) == sub2);
+
+    delete root;
+}
+
+void ResolverTest::testCache(void)
+{
+    ResolverComposite* root = new ResolverComposite("Root", "Root", NULL);
+    ManagedComponent* leaf1 = new ManagedComponent("Leaf1", "Leaf 1", NULL);
+    ManagedComponent* leaf2 = new ManagedComponent("Leaf2", "Leaf 2", NULL);
+    ManagedComponent* leaf3 = new ManagedComponent("Leaf3", "Leaf 3", NULL);
+    root->GetChildren()->AddComponent(leaf1);
+    root->GetChildren()->AddComponent(leaf2);
+    root->GetChildren()->AddComponent(leaf3);
+
+    Resolver resolver("Resolver", "Resolver", NULL, 2);
+    resolver.AddRoot(root);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(2), resolver.GetCacheSize());
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), resolver.GetCachedCount());
+
+    // Failed resolutions are not cached.
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf4") == NULL);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), resolver.GetCachedCount());
+
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf1") == leaf1);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf2") == leaf2);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf1") == leaf1);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(2), resolver.GetCachedCount());
+
+    // Leaf2 is the least recently used, and gets evicted.
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf3") == leaf3);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(2), resolver.GetCachedCount());
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf1") == leaf1);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf2") == leaf2);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf3") == leaf3);
+
+    // Renaming only evicts the paths going through the component.
+    leaf1->SetName("Renamed");
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(2), resolver.GetCachedCount());
+    leaf2->SetName("Renamed2");
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), resolver.GetCachedCount());
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Leaf3") == leaf3);
+
+    resolver.ClearCache();
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), resolver.GetCachedCount());
+
+    // A resolver without cache still resolves.
+    Resolver uncached("Uncached", "Uncached", NULL, 0);
+    uncached.AddRoot(root);
+    CPPUNIT_ASSERT(uncached.ResolveAbsolute("Root/Children/Leaf3") == leaf3);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), uncached.GetCachedCount());
+
+    delete root;
+}
+
+void ResolverTest::testInvalidation(void)
+{
+    ResolverComposite* root = new ResolverComposite("Root", "Root", NULL);
+    ResolverComposite* sub1 = new ResolverComposite("Sub1", "Sub 1", NULL);
+    ResolverComposite* sub2 = new ResolverComposite("Sub2", "Sub 2", NULL);
+    ManagedComponent* leaf = new ManagedComponent("Leaf", "Leaf", NULL);
+    root->GetChildren()->AddComponent(sub1);
+    root->GetChildren()->AddComponent(sub2);
+    sub1->GetChildren()->AddComponent(leaf);
+
+    Resolver resolver("Resolver", "Resolver", NULL);
+    resolver.AddRoot(root);
+
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Sub1/Children/Leaf") == leaf);
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Sub2") == sub2);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("..", leaf) == sub1);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(3), resolver.GetCachedCount());
+
+    // Moving the leaf evicts the paths to and from it, not its siblings.
+    leaf->SetParent(sub2);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), resolver.GetCachedCount());
+    CPPUNIT_ASSERT(resolver.ResolveRelative("..", leaf) == sub2);
+
+    // Renaming a component evicts everything below it.
+    CPPUNIT_ASSERT(resolver.ResolveAbsolute("Root/Children/Sub1/Children/Leaf") == leaf);
+    root->SetName("Renamed");
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), resolver.GetCachedCount());
+    CPPUNIT_ASSERT(resolver.ResolveRelative("..", leaf) == sub2);
+
+    // Clearing a container evicts the paths to its children before they
+    // are deleted.
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Children/Leaf", sub1) == leaf);
+    sub1->GetChildren()->Clear();
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), resolver.GetCachedCount());
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Children/Leaf", sub1) == NULL);
+
+    // Paths may go through references, and follow their changes.
+    ResolverAggregate owner("Owner", "Owner", NULL);
+    ManagedComponent* target = new ManagedComponent("Target", "Target", NULL);
+    sub2->GetChildren()->AddComponent(target);
+
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Links/Target", &owner) == NULL);
+    owner.GetLinks()->AddComponent(target);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Links/Target", &owner) == target);
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Children/Sub2", root) == sub2);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(2), resolver.GetCachedCount());
+
+    owner.GetLinks()->RemoveComponent(target);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), resolver.GetCachedCount());
+    CPPUNIT_ASSERT(resolver.ResolveRelative("Links/Target", &owner) == NULL);
+
+    delete root;
+}
+
+void ResolverTest::testResolveAll(void)
+{
+    ResolverComposite* root = new ResolverComposite("Root", "Root", NULL);
+    ResolverComposite* sub = new ResolverComposite("Sub", "Sub", NULL);
+    ManagedComponent* leaf = new ManagedComponent("Leaf", "Leaf", NULL);
+    ManagedComponent* leaf2 = new ManagedComponent("Leaf2", "Leaf 2", NULL);
+    root->GetChildren()->AddComponent(sub);
+    sub->GetChildren()->AddComponent(leaf);
+    sub->GetChildren()->AddComponent(leaf2);
+
+    Resolver resolver("Resolver", "Resolver", NULL);
+    resolver.AddRoot(root);
+
+    Resolver::PathCollection paths;
+    paths.push_back("Root/Children/Sub/Children/Leaf2");
+    paths.push_back("Root/Children/Sub/Children/Leaf");
+    paths.push_back(NULL);
+    paths.push_back("/Root/Children/Sub");
+    paths.push_back("Root/Children/Sub/Children/Leaf3");
+    paths.push_back("Root/Children/Sub/Children/Leaf/..");
+    paths.push_back("Root");
+    paths.push_back("Root/Children/Sub/Children/Leaf");
+    paths.push_back("Other/Children/Sub");
+    paths.push_back("Root/Children/Su");
+
+    ::Smp::ComponentCollection components;
+    resolver.ResolveAll(paths, components);
+
+    CPPUNIT_ASSERT_EQUAL(paths.size(), components.size());
+    CPPUNIT_ASSERT(components[0] == leaf2);
+    CPPUNIT_ASSERT(components[1] == leaf);
+    CPPUNIT_ASSERT(components[2] == NULL);
+    CPPUNIT_ASSERT(components[3] == sub);
+    CPPUNIT_ASSERT(components[4] == NULL);
+    CPPUNIT_ASSERT(components[5] == sub);
+    CPPUNIT_ASSERT(components[6] == root);
+    CPPUNIT_ASSERT(components[7] == leaf);
+    CPPUNIT_ASSERT(components[8] == NULL);
+    CPPUNIT_ASSERT(components[9] == NULL);
+
+    // Batch resolution agrees with resolving the paths one by one.
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        if (paths[i] != NULL)
+        {
+            CPPUNIT_ASSERT(resolver.ResolveAbsolute(paths[i]) == components[i]);
+        }
+    }
+
+    delete root;
+}
@@ -0,0 +1,28 @@
+#ifndef RESOLVERTEST_H_
+#define RESOLVERTEST_H_
+
+#include "BaseTest.h"
+
+class ResolverTest :
+    public BaseTest
+{
+    public: 
+        CPPUNIT_SUITE_BEGIN(ResolverTest)
+            CPPUNIT_TEST(ResolverTest, testResolveAbsolute)
+            CPPUNIT_TEST(ResolverTest, testResolveRelative)
+            CPPUNIT_TEST(ResolverTest, testCache)
+            CPPUNIT_TEST(ResolverTest, testInvalidation)
+            CPPUNIT_TEST(ResolverTest, testResolveAll)
+        CPPUNIT_SUITE_END()
+
+        void setUp(void);
+        void tearDown(void);
+
+        void testResolveAbsolute(void);
+        void testResolveRelative(void);
+        void testCache(void);
+        void testInvalidation(void);
+        void testResolveAll(void);
+};
+
+#endif // RESOLVERTEST_H_
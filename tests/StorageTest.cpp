@@ -0,0 +1,1042 @@
+#include "StorageTest.h"
+
+#include "Mdk/Storage/MemoryStorageWriter.h"
+#include "Mdk/Storage/MemoryStorageReader.h"
+#include "Mdk/Storage/FileStorageWriter.h"
+#include "Mdk/Storage/FileStorageReader.h"
+#include "Mdk/Storage/Checkpointer.h"
+#include "Mdk/Storage/AsyncStorer.h"
+#include "Mdk/Storage/LzCodec.h"
+#include "Mdk/Storage/CompressedStorageWriter.h"
+#include "Mdk/Storage/CompressedStorageReader.h"
+#include "Mdk/Storage/SegmentedStorer.h"
+#include "Mdk/Storage/CheckpointRing.h"
+#include "Mdk/Component.h"
+#include "Mdk/Management/ManagedComponent.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace ::Smp::Mdk::Storage;
+
+static const char* STORAGE_TEST_FILE = "StorageTest.dat";
+
+class PersistentModel :
+    public ::Smp::Mdk::Management::ManagedComponent,
+    public virtual ::Smp::IPersist
+{
+    public:
+        PersistentModel(
+                ::Smp::String8 name,
+                size_t stateSize) :
+            ManagedComponent(name, "Persistent model", NULL),
+            m_state(stateSize, 0.0)
+        {
+        }
+
+        virtual void Restore(
+                ::Smp::IStorageReader* reader)
+            throw (::Smp::IPersist::CannotRestore)
+        {
+            reader->Restore(&this->m_state[0],
+                    static_cast< ::Smp::Int32>(this->m_state.size() * sizeof(::Smp::Float64)));
+        }
+
+        virtual void Store(
+                ::Smp::IStorageWriter* writer)
+            throw (::Smp::IPersist::CannotStore)
+        {
+            writer->Store(&this->m_state[0],
+                    static_cast< ::Smp::Int32>(this->m_state.size() * sizeof(::Smp::Float64)));
+        }
+
+        ::std::vector< ::Smp::Float64> m_state;
+};
+
+/// Model whose store can be made to fail.
+class FailingModel :
+    public PersistentModel
+{
+    public:
+        FailingModel(
+                ::Smp::String8 name,
+                size_t stateSize) :
+            PersistentModel(name, stateSize),
+            m_fail(false)
+        {
+        }
+
+        virtual void Store(
+                ::Smp::IStorageWriter* writer)
+            throw (::Smp::IPersist::CannotStore)
+        {
+            if (this->m_fail)
+            {
+                throw ::Smp::IPersist::CannotStore("store failed");
+            }
+
+            PersistentModel::Store(writer);
+        }
+
+        bool m_fail;
+};
+
+/// Writer that fails once a number of bytes has been stored.
+class FailingWriter :
+    public virtual ::Smp::IStorageWriter
+{
+    public:
+        explicit FailingWriter(
+                size_t budget) :
+            m_budget(budget)
+        {
+        }
+
+        virtual void Store(
+                void* address,
+                ::Smp::Int32 size)
+        {
+            if (static_cast< size_t>(size) > this->m_budget)
+            {
+                throw ::Smp::IPersist::CannotStore("storage full");
+            }
+
+            this->m_budget -= size;
+        }
+
+    private:
+        size_t m_budget;
+};
+
+class EventRecorder :
+    public ::Smp::Mdk::Component,
+    public virtual ::Smp::Services::IEventManager
+{
+    public:
+        EventRecorder(void) :
+            Component("EventRecorder", "Event recorder", NULL)
+        {
+        }
+
+        virtual ::Smp::Services::EventId GetEventId(
+                ::Smp::String8 eventName)
+        {
+            return -1;
+        }
+
+        virtual void Subscribe(
+                const ::Smp::Services::EventId event,
+                const ::Smp::IEntryPoint* entryPoint)
+            throw (::Smp::Services::InvalidEventId,
+                    ::Smp::Services::IEventManager::AlreadySubscribed)
+        {
+        }
+
+        virtual void Unsubscribe(
+                const ::Smp::Services::EventId event,
+                const ::Smp::IEntryPoint* entryPoint)
+            throw (::Smp::Services::InvalidEventId,
+                    ::Smp::Services::IEventManager::NotSubscribed)
+        {
+        }
+
+        virtual void Emit(
+                const ::Smp::Services::EventId event)
+            throw (::Smp::Services::InvalidEventId)
+        {
+            this->m_events.push_back(event);
+        }
+
+        ::std::vector< ::Smp::Services::EventId> m_events;
+};
+
+class StepReplayer :
+    public CheckpointRing::Replayer
+{
+    public:
+        StepReplayer(
+                PersistentModel* model) :
+            m_model(model),
+            m_from(-1),
+            m_to(-1)
+        {
+        }
+
+        /// The model state is its time in seconds.
+        virtual void Replay(
+                ::Smp::Duration from,
+                ::Smp::Duration to)
+        {
+            this->m_from = from;
+            this->m_to = to;
+            this->m_model->m_state[0] = static_cast< ::Smp::Float64>(to / 1000000000);
+        }
+
+        PersistentModel* m_model;
+        ::Smp::Duration m_from;
+        ::Smp::Duration m_to;
+};
+
+/// Scheduler of a single simulation time event, run by hand.
+class ManualScheduler :
+    public ::Smp::Mdk::Component,
+    public virtual ::Smp::Services::IScheduler,
+    public virtual ::Smp::Services::ITimeKeeper
+{
+    public:
+        ManualScheduler(void) :
+            Component("ManualScheduler", "Manual scheduler", NULL),
+            m_entryPoint(NULL),
+            m_time(0)
+        {
+        }
+
+        /// Advance the simulation time and execute the scheduled entry
+        /// point.
+        void Run(
+                ::Smp::Duration time)
+        {
+            this->m_time = time;
+            this->m_entryPoint->Execute();
+        }
+
+        virtual void AddImmediateEvent(
+                const ::Smp::IEntryPoint* entryPoint)
+        {
+        }
+
+        virtual ::Smp::Services::EventId AddSimulationTimeEvent(
+                const ::Smp::IEntryPoint* entryPoint,
+                const ::Smp::Duration simulationTime,
+                const ::Smp::Duration cycleTime,
+                const ::Smp::Int64 count)
+        {
+            this->m_entryPoint = entryPoint;
+            return 1;
+        }
+
+        virtual ::Smp::Services::EventId AddMissionTimeEvent(
+                const ::Smp::IEntryPoint* entryPoint,
+                const ::Smp::Duration missionTime,
+                const ::Smp::Duration cycleTime,
+                const ::Smp::Int64 count)
+        {
+            return -1;
+        }
+
+        virtual ::Smp::Services::EventId AddEpochTimeEvent(
+                const ::Smp::IEntryPoint* entryPoint,
+                const ::Smp::DateTime epochTime,
+                const ::Smp::Duration cycleTime,
+                const ::Smp::Int64 count)
+        {
+            return -1;
+        }
+
+        virtual ::Smp::Services::EventId AddZuluTimeEvent(
+                const ::Smp::IEntryPoint* entryPoint,
+                const ::Smp::DateTime zuluTime,
+                const ::Smp::Duration cycleTime,
+                const ::Smp::Int64 count)
+        {
+            return -1;
+        }
+
+        virtual void SetEventSimulationTime(
+                const ::Smp::Services::EventId event,
+                const ::Smp::Duration simulationTime)
+            throw (::Smp::Services::InvalidEventId)
+        {
+        }
+
+        virtual void SetEventMissionTime(
+                const ::Smp::Services::EventId event,
+                const ::Smp::Duration missionTime)
+            throw (::Smp::Services::InvalidEventId)
+        {
+        }
+
+        virtual void SetEventEpochTime(
+                const ::Smp::Services::EventId event,
+                const ::Smp::DateTime epochTime)
+            throw (::Smp::Services::InvalidEventId)
+        {
+        }
+
+        virtual void SetEventZuluTime(
+                const ::Smp::Services::EventId event,
+                const ::Smp::DateTime zuluTime)
+            throw (::Smp::Services::InvalidEventId)
+        {
+        }
+
+        virtual void SetEventCycleTime(
+                const ::Smp::Services::EventId event,
+                const ::Smp::Duration cycleTime)
+            throw (::Smp::Services::InvalidEventId)
+        {
+        }
+
+        virtual void SetEventCount(
+                const ::Smp::Services::EventId event,
+                const ::Smp::Int64 count)
+            throw (::Smp::Services::InvalidEventId)
+        {
+        }
+
+        virtual void RemoveEvent(
+                const ::Smp::Services::EventId event)
+            throw (::Smp::Services::InvalidEventId)
+        {
+        }
+
+        virtual ::Smp::Duration GetSimulationTime(void)
+        {
+            return this->m_time;
+        }
+
+        virtual ::Smp::DateTime GetEpochTime(void)
+        {
+            return this->m_time;
+        }
+
+        virtual ::Smp::Duration GetMissionTime(void)
+        {
+            return this->m_time;
+        }
+
+        virtual ::Smp::DateTime GetZuluTime(void)
+        {
+            return this->m_time;
+        }
+
+        virtual void SetEpochTime(
+                const ::Smp::DateTime epochTime)
+        {
+        }
+
+        virtual void SetMissionStart(
+                const ::Smp::DateTime missionStart)
+        {
+        }
+
+        virtual void SetMissionTime(
+                const ::Smp::Duration missionTime)
+        {
+        }
+
+    private:
+        const ::Smp::IEntryPoint* m_entryPoint;
+        ::Smp::Duration m_time;
+};
+
+static const char* STORAGE_TEST_FILE2 = "StorageTest2.dat";
+
+void StorageTest::setUp(void)
+{
+}
+
+void StorageTest::tearDown(void)
+{
+    ::remove(STORAGE_TEST_FILE);
+    ::remove(STORAGE_TEST_FILE2);
+}
+
+void StorageTest::testMemoryStorage(void)
+{
+    MemoryStorageWriter writer(8);
+
+    for (::Smp::Int32 i = 0; i < 1000; ++i)
+    {
+        ::Smp::Float64 value = i * 0.5;
+        writer.Store(&i, sizeof(i));
+        writer.Store(&value, sizeof(value));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1000 * 12), writer.GetSize());
+    CPPUNIT_ASSERT(writer.GetCapacity() >= writer.GetSize());
+
+    MemoryStorageReader reader(writer.GetData(), writer.GetSize());
+
+    for (::Smp::Int32 i = 0; i < 1000; ++i)
+    {
+        ::Smp::Int32 index = -1;
+        ::Smp::Float64 value = -1.0;
+        reader.Restore(&index, sizeof(index));
+        reader.Restore(&value, sizeof(value));
+        CPPUNIT_ASSERT_EQUAL(i, index);
+        CPPUNIT_ASSERT_EQUAL(i * 0.5, value);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reader.GetRemaining());
+
+    bool exceptionCatched = false;
+    ::Smp::Int32 extra = 0;
+    try
+    {
+        reader.Restore(&extra, sizeof(extra));
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    reader.Rewind();
+    reader.Restore(&extra, sizeof(extra));
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int32(0), extra);
+
+    writer.Clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), writer.GetSize());
+}
+
+void StorageTest::testFileStorage(void)
+{
+    char block[100];
+    for (size_t i = 0; i < sizeof(block); ++i)
+    {
+        block[i] = static_cast< char>(i);
+    }
+
+    // A small buffer, so that both flushing and blocks larger than the
+    // buffer are exercised.
+    FileStorageWriter* writer = new FileStorageWriter(STORAGE_TEST_FILE, 16);
+
+    for (::Smp::Int32 i = 0; i < 100; ++i)
+    {
+        writer->Store(&i, sizeof(i));
+    }
+    writer->Store(block, sizeof(block));
+    CPPUNIT_ASSERT_EQUAL(::Smp::Int64(500), writer->GetSize());
+
+    writer->Sync();
+    writer->Close();
+    delete writer;
+
+    FileStorageReader reader(STORAGE_TEST_FILE);
+    CPPUNIT_ASSERT_EQUAL(size_t(500), reader.GetSize());
+
+    for (::Smp::Int32 i = 0; i < 100; ++i)
+    {
+        ::Smp::Int32 value = -1;
+        reader.Restore(&value, sizeof(value));
+        CPPUNIT_ASSERT_EQUAL(i, value);
+    }
+
+    char restored[100];
+    reader.Restore(restored, sizeof(restored));
+    CPPUNIT_ASSERT(::memcmp(block, restored, sizeof(block)) == 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reader.GetRemaining());
+
+    bool exceptionCatched = false;
+    try
+    {
+        FileStorageReader missing("StorageTest.missing");
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+}
+
+void StorageTest::testCheckpoints(void)
+{
+    // 10000 values of 8 bytes, in 20 blocks of 4096 bytes.
+    PersistentModel model("Model", 10000);
+    PersistentModel other("Other", 10);
+
+    Checkpointer checkpointer;
+    checkpointer.Add(&model);
+    checkpointer.Add(&other);
+
+    MemoryStorageWriter full;
+    MemoryStorageWriter delta1;
+    MemoryStorageWriter delta2;
+
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(20), checkpointer.Checkpoint(&full));
+    CPPUNIT_ASSERT_EQUAL(size_t(10010 * 8), checkpointer.GetImageSize());
+
+    model.m_state[5000] = 1.0;
+    other.m_state[0] = 2.0;
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(2), checkpointer.Checkpoint(&delta1));
+    CPPUNIT_ASSERT(delta1.GetSize() < (full.GetSize() / 5));
+
+    model.m_state[5001] = 3.0;
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), checkpointer.Checkpoint(&delta2));
+
+    // Nothing changed.
+    MemoryStorageWriter empty;
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(0), checkpointer.Checkpoint(&empty));
+
+    // A checkpoint that fails to be written is not taken as the base of
+    // the next one.
+    model.m_state[9000] = 5.0;
+    bool exceptionCatched = false;
+    try
+    {
+        FailingWriter failing(64);
+        checkpointer.Checkpoint(&failing);
+    }
+    catch (::Smp::IPersist::CannotStore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    MemoryStorageWriter retry;
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(20), checkpointer.Checkpoint(&retry));
+    model.m_state[9000] = 0.0;
+
+    // Restore the chain into fresh models.
+    PersistentModel restoredModel("Model", 10000);
+    PersistentModel restoredOther("Other", 10);
+    Checkpointer restorer;
+    restorer.Add(&restoredModel);
+    restorer.Add(&restoredOther);
+
+    exceptionCatched = false;
+    try
+    {
+        MemoryStorageReader reader(delta1.GetData(), delta1.GetSize());
+        restorer.Apply(&reader);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    MemoryStorageReader fullReader(full.GetData(), full.GetSize());
+    MemoryStorageReader delta1Reader(delta1.GetData(), delta1.GetSize());
+    MemoryStorageReader delta2Reader(delta2.GetData(), delta2.GetSize());
+    restorer.Apply(&fullReader);
+    restorer.Apply(&delta1Reader);
+    restorer.Apply(&delta2Reader);
+    restorer.Restore();
+
+    CPPUNIT_ASSERT(restoredModel.m_state == model.m_state);
+    CPPUNIT_ASSERT(restoredOther.m_state == other.m_state);
+
+    // Further deltas are relative to the restored state.
+    restoredModel.m_state[0] = 4.0;
+    MemoryStorageWriter delta3;
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(1), restorer.Checkpoint(&delta3));
+
+    // A truncated full checkpoint leaves no image to restore, nor to apply
+    // deltas to.
+    exceptionCatched = false;
+    try
+    {
+        MemoryStorageReader reader(full.GetData(), full.GetSize() / 2);
+        restorer.Apply(&reader);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    exceptionCatched = false;
+    try
+    {
+        restorer.Restore();
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    exceptionCatched = false;
+    try
+    {
+        MemoryStorageReader reader(delta1.GetData(), delta1.GetSize());
+        restorer.Apply(&reader);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // The next checkpoint taken is full.
+    MemoryStorageWriter rebased;
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(20), restorer.Checkpoint(&rebased));
+}
+
+void StorageTest::testAsyncStore(void)
+{
+    PersistentModel model("Model", 100000);
+    for (size_t i = 0; i < model.m_state.size(); ++i)
+    {
+        model.m_state[i] = static_cast< ::Smp::Float64>(i);
+    }
+    const ::std::vector< ::Smp::Float64> stored(model.m_state);
+
+    EventRecorder events;
+    AsyncStorer storer(&events);
+    storer.Add(&model);
+
+    storer.Begin(STORAGE_TEST_FILE);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), events.m_events.size());
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_EnterStoringId, events.m_events[0]);
+
+    // The state was captured, so it can change while being written.
+    model.m_state[0] = -1.0;
+
+    // A second store completes the first one before entering.
+    storer.Begin(STORAGE_TEST_FILE2);
+    storer.Wait();
+    CPPUNIT_ASSERT_EQUAL(false, storer.IsPending());
+    CPPUNIT_ASSERT_EQUAL(true, storer.Poll());
+
+    CPPUNIT_ASSERT_EQUAL(size_t(4), events.m_events.size());
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_LeaveStoringId, events.m_events[1]);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_EnterStoringId, events.m_events[2]);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_LeaveStoringId, events.m_events[3]);
+
+    PersistentModel restored("Model", 100000);
+    FileStorageReader reader(STORAGE_TEST_FILE);
+    restored.Restore(&reader);
+    CPPUNIT_ASSERT(restored.m_state == stored);
+
+    FileStorageReader reader2(STORAGE_TEST_FILE2);
+    restored.Restore(&reader2);
+    CPPUNIT_ASSERT(restored.m_state == model.m_state);
+
+    // Failures to write are reported when the store completes.
+    bool exceptionCatched = false;
+    try
+    {
+        storer.Begin("StorageTestMissingDirectory/StorageTest.dat");
+        storer.Wait();
+    }
+    catch (::Smp::IPersist::CannotStore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+    CPPUNIT_ASSERT_EQUAL(false, storer.IsPending());
+
+    // Failed stores leave too.
+    CPPUNIT_ASSERT_EQUAL(size_t(6), events.m_events.size());
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_EnterStoringId, events.m_events[4]);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_LeaveStoringId, events.m_events[5]);
+
+    // A store begun after a failed one reports the failure, without
+    // entering, and can then be begun again.
+    exceptionCatched = false;
+    storer.Begin("StorageTestMissingDirectory/StorageTest.dat");
+    try
+    {
+        storer.Begin(STORAGE_TEST_FILE2);
+    }
+    catch (::Smp::IPersist::CannotStore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+    CPPUNIT_ASSERT_EQUAL(false, storer.IsPending());
+    CPPUNIT_ASSERT_EQUAL(size_t(8), events.m_events.size());
+
+    storer.Begin(STORAGE_TEST_FILE2);
+    storer.Wait();
+    CPPUNIT_ASSERT_EQUAL(size_t(10), events.m_events.size());
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_EnterStoringId, events.m_events[8]);
+    CPPUNIT_ASSERT_EQUAL(::Smp::Services::SMP_LeaveStoringId, events.m_events[9]);
+}
+
+void StorageTest::testAsyncStoreBackToBack(void)
+{
+    PersistentModel model("Model", 100000);
+    EventRecorder events;
+    AsyncStorer storer(&events);
+    storer.Add(&model);
+
+    // Stores are single-flight: each Begin() completes the pending store,
+    // which leaves before the next one enters, and each file holds the
+    // state captured by its own Begin().
+    const char* files[2] = { STORAGE_TEST_FILE, STORAGE_TEST_FILE2 };
+    for (size_t i = 0; i < 4; ++i)
+    {
+        model.m_state[0] = static_cast< ::Smp::Float64>(i);
+        storer.Begin(files[i % 2]);
+        CPPUNIT_ASSERT_EQUAL(true, storer.IsPending());
+        CPPUNIT_ASSERT_EQUAL(2 * i + 1, events.m_events.size());
+
+        if (i > 0)
+        {
+            PersistentModel previous("Model", 100000);
+            FileStorageReader reader(files[(i - 1) % 2]);
+            previous.Restore(&reader);
+            CPPUNIT_ASSERT_EQUAL(static_cast< ::Smp::Float64>(i - 1), previous.m_state[0]);
+        }
+    }
+
+    for (size_t i = 0; i < events.m_events.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL((i % 2 == 0) ?
+                ::Smp::Services::SMP_EnterStoringId : ::Smp::Services::SMP_LeaveStoringId,
+                events.m_events[i]);
+    }
+
+    // Polling until the pending store completes keeps the next Begin()
+    // from waiting: it only enters.
+    while (!storer.Poll())
+    {
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(8), events.m_events.size());
+    storer.Begin(STORAGE_TEST_FILE);
+    CPPUNIT_ASSERT_EQUAL(size_t(9), events.m_events.size());
+    storer.Wait();
+    CPPUNIT_ASSERT_EQUAL(size_t(10), events.m_events.size());
+}
+
+void StorageTest::testCompression(void)
+{
+    ::std::vector< char> zeros(100000, 0);
+    ::std::vector< char> text;
+    ::std::vector< char> noise(100000);
+    const char* phrase = "The quick brown fox jumps over the lazy dog. ";
+    while (text.size() < 100000)
+    {
+        text.insert(text.end(), phrase, phrase + ::strlen(phrase));
+    }
+    ::Smp::UInt32 seed = 12345;
+    for (size_t i = 0; i < noise.size(); ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        noise[i] = static_cast< char>(seed >> 24);
+    }
+
+    const ::std::vector< char>* inputs[] = { &zeros, &text, &noise };
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const ::std::vector< char>& input = *inputs[i];
+        ::std::vector< char> compressed(LzCodec::GetBound(input.size()));
+        const size_t size = LzCodec::Compress(&input[0], input.size(), &compressed[0]);
+        CPPUNIT_ASSERT(size > 0);
+        CPPUNIT_ASSERT(size <= compressed.size());
+
+        ::std::vector< char> output(input.size());
+        CPPUNIT_ASSERT_EQUAL(true, LzCodec::Decompress(&compressed[0], size,
+                    &output[0], output.size()));
+        CPPUNIT_ASSERT(output == input);
+
+        // Truncated input is detected rather than overrunning buffers.
+        CPPUNIT_ASSERT_EQUAL(false, LzCodec::Decompress(&compressed[0], size / 2,
+                    &output[0], output.size()));
+    }
+
+    ::std::vector< char> compressed(LzCodec::GetBound(zeros.size()));
+    CPPUNIT_ASSERT(LzCodec::Compress(&zeros[0], zeros.size(), &compressed[0]) < 1000);
+
+    // Streams are cut in blocks compressed on several threads.
+    PersistentModel model("Model", 50000);
+    model.m_state[10] = 1.0;
+    model.m_state[40000] = 2.0;
+
+    MemoryStorageWriter memory;
+    {
+        CompressedStorageWriter writer(&memory, 16384, 4);
+        model.Store(&writer);
+        writer.Flush();
+        CPPUNIT_ASSERT_EQUAL(::Smp::Int64(memory.GetSize()), writer.GetStoredSize());
+        CPPUNIT_ASSERT(writer.GetStoredSize() * 20 < writer.GetRawSize());
+    }
+
+    PersistentModel restored("Model", 50000);
+    MemoryStorageReader source(memory.GetData(), memory.GetSize());
+    CompressedStorageReader reader(&source);
+    restored.Restore(&reader);
+    CPPUNIT_ASSERT(restored.m_state == model.m_state);
+
+    // More threads than a batch may hold are clamped, so that the stream
+    // can still be read back.
+    MemoryStorageWriter clamped;
+    {
+        CompressedStorageWriter writer(&clamped, 64, 5000);
+        model.Store(&writer);
+        writer.Flush();
+    }
+
+    PersistentModel restoredClamped("Model", 50000);
+    MemoryStorageReader clampedSource(clamped.GetData(), clamped.GetSize());
+    CompressedStorageReader clampedReader(&clampedSource);
+    restoredClamped.Restore(&clampedReader);
+    CPPUNIT_ASSERT(restoredClamped.m_state == model.m_state);
+
+    // Corrupt data is reported on restore.
+    MemoryStorageWriter corrupt;
+    corrupt.Store(memory.GetData(), static_cast< ::Smp::Int32>(memory.GetSize()));
+    static_cast< char*>(corrupt.GetData())[sizeof(::Smp::UInt32) + 4] ^= 0x40;
+
+    bool exceptionCatched = false;
+    try
+    {
+        MemoryStorageReader corruptSource(corrupt.GetData(), corrupt.GetSize());
+        CompressedStorageReader corruptReader(&corruptSource);
+        restored.Restore(&corruptReader);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+}
+
+void StorageTest::testSegmentedStore(void)
+{
+    ::std::vector< PersistentModel*> models;
+    SegmentedStorer storer(4);
+    CPPUNIT_ASSERT_EQUAL(::Smp::UInt32(4), storer.GetThreadCount());
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        char name[16];
+        ::sprintf(name, "Model%u", static_cast< unsigned int>(i));
+        models.push_back(new PersistentModel(name, 1000 * (i + 1)));
+        for (size_t j = 0; j < models[i]->m_state.size(); ++j)
+        {
+            models[i]->m_state[j] = static_cast< ::Smp::Float64>(i * j);
+        }
+        storer.Add(models[i]);
+    }
+
+    storer.Store(STORAGE_TEST_FILE);
+
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        models[i]->m_state[1] = -1.0;
+    }
+
+    storer.Restore(STORAGE_TEST_FILE);
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(::Smp::Float64(i), models[i]->m_state[1]);
+        models[i]->m_state[1] = -1.0;
+    }
+
+    // Selected components only are restored.
+    SegmentedStorer::ComponentCollection selected;
+    selected.push_back(models[2]);
+    selected.push_back(models[5]);
+    storer.Restore(STORAGE_TEST_FILE, selected);
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        const ::Smp::Float64 expected = ((i == 2) || (i == 5)) ? i : -1.0;
+        CPPUNIT_ASSERT_EQUAL(expected, models[i]->m_state[1]);
+    }
+
+    // Components are matched to segments by name.
+    PersistentModel other("Other", 1000);
+    selected.push_back(&other);
+    bool exceptionCatched = false;
+    try
+    {
+        storer.Restore(STORAGE_TEST_FILE, selected);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // A segment shorter than the component state cannot be restored.
+    PersistentModel larger("Model0", 2000);
+    selected.clear();
+    selected.push_back(&larger);
+    exceptionCatched = false;
+    try
+    {
+        storer.Restore(STORAGE_TEST_FILE, selected);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // Nor can a segment longer than it.
+    PersistentModel smaller("Model0", 500);
+    selected.clear();
+    selected.push_back(&smaller);
+    exceptionCatched = false;
+    try
+    {
+        storer.Restore(STORAGE_TEST_FILE, selected);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // Components with the same segment name cannot be stored together.
+    SegmentedStorer duplicates(2);
+    PersistentModel twin("Model0", 10);
+    duplicates.Add(models[0]);
+    duplicates.Add(&twin);
+    exceptionCatched = false;
+    try
+    {
+        duplicates.Store(STORAGE_TEST_FILE2);
+    }
+    catch (::Smp::IPersist::CannotStore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    // Files that are not segmented state files are rejected.
+    {
+        FileStorageWriter writer(STORAGE_TEST_FILE2);
+        ::Smp::UInt32 junk[4] = { 1, 2, 3, 4 };
+        writer.Store(junk, sizeof(junk));
+    }
+    exceptionCatched = false;
+    try
+    {
+        storer.Restore(STORAGE_TEST_FILE2);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        delete models[i];
+    }
+}
+
+void StorageTest::testCheckpointRing(void)
+{
+    const ::Smp::Duration second = 1000000000;
+    PersistentModel model("Model", 1000);
+    CheckpointRing ring("Ring", 4, 10 * second);
+    ring.Add(&model);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), ring.GetCapacity());
+
+    // Run for 60 s, with a snapshot every 10 s.
+    for (::Smp::Duration time = 0; time <= 60 * second; time += second)
+    {
+        model.m_state[0] = static_cast< ::Smp::Float64>(time / second);
+        ring.Update(time);
+    }
+
+    // The ring keeps the last four snapshots only.
+    CPPUNIT_ASSERT_EQUAL(size_t(4), ring.GetCount());
+    CPPUNIT_ASSERT_EQUAL(30 * second, ring.GetTime(0));
+    CPPUNIT_ASSERT_EQUAL(60 * second, ring.GetTime(3));
+
+    // Rolling back restores the closest snapshot before the target, and
+    // replays up to it.
+    StepReplayer replayer(&model);
+    CPPUNIT_ASSERT_EQUAL(40 * second, ring.Rollback(45 * second, &replayer));
+    CPPUNIT_ASSERT_EQUAL(40 * second, replayer.m_from);
+    CPPUNIT_ASSERT_EQUAL(45 * second, replayer.m_to);
+    CPPUNIT_ASSERT_EQUAL(45.0, model.m_state[0]);
+
+    // Snapshots after the restored one are discarded.
+    CPPUNIT_ASSERT_EQUAL(size_t(2), ring.GetCount());
+    CPPUNIT_ASSERT_EQUAL(false, ring.Update(45 * second));
+    CPPUNIT_ASSERT_EQUAL(true, ring.Update(50 * second));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), ring.GetCount());
+
+    CPPUNIT_ASSERT_EQUAL(30 * second, ring.Rollback(30 * second));
+    CPPUNIT_ASSERT_EQUAL(30.0, model.m_state[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), ring.GetCount());
+
+    bool exceptionCatched = false;
+    try
+    {
+        ring.Rollback(20 * second);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+
+    ring.Clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), ring.GetCount());
+
+    // A snapshot that cannot be taken leaves the ring as it was, full or
+    // not, and does not discard the snapshots after its time.
+    FailingModel failing("Failing", 100);
+    CheckpointRing small("Small", 2, second);
+    small.Add(&failing);
+    failing.m_state[0] = 1.0;
+    small.Take(1 * second);
+    failing.m_state[0] = 2.0;
+    small.Take(2 * second);
+
+    failing.m_fail = true;
+    const ::Smp::Duration times[2] = { 3 * second, 1 * second };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        exceptionCatched = false;
+        try
+        {
+            small.Take(times[i]);
+        }
+        catch (::Smp::IPersist::CannotStore& ex)
+        {
+            exceptionCatched = true;
+        }
+        CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+        CPPUNIT_ASSERT_EQUAL(size_t(2), small.GetCount());
+        CPPUNIT_ASSERT_EQUAL(1 * second, small.GetTime(0));
+        CPPUNIT_ASSERT_EQUAL(2 * second, small.GetTime(1));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1 * second, small.Rollback(1 * second));
+    CPPUNIT_ASSERT_EQUAL(1.0, failing.m_state[0]);
+
+    failing.m_fail = false;
+    failing.m_state[0] = 3.0;
+    small.Take(3 * second);
+    failing.m_state[0] = 4.0;
+    small.Take(4 * second);
+    CPPUNIT_ASSERT_EQUAL(3 * second, small.GetTime(0));
+    CPPUNIT_ASSERT_EQUAL(3 * second, small.Rollback(3 * second));
+    CPPUNIT_ASSERT_EQUAL(3.0, failing.m_state[0]);
+
+    // A snapshot larger than the state of the components is not rolled
+    // back to, and the snapshots after it are kept.
+    failing.m_state[0] = 4.0;
+    small.Take(4 * second);
+    failing.m_state.resize(50);
+    exceptionCatched = false;
+    try
+    {
+        small.Rollback(3 * second);
+    }
+    catch (::Smp::IPersist::CannotRestore& ex)
+    {
+        exceptionCatched = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(true, exceptionCatched);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), small.GetCount());
+    failing.m_state.resize(100);
+
+    // Scheduled snapshots that fail are counted, not thrown through the
+    // scheduler.
+    ManualScheduler scheduler;
+    small.Schedule(&scheduler, &scheduler);
+    CPPUNIT_ASSERT(small.GetLastError() == NULL);
+
+    failing.m_fail = true;
+    scheduler.Run(5 * second);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), small.GetFailedCount());
+    CPPUNIT_ASSERT(small.GetLastError() != NULL);
+    CPPUNIT_ASSERT_EQUAL(4 * second, small.GetTime(1));
+
+    failing.m_fail = false;
+    scheduler.Run(6 * second);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), small.GetFailedCount());
+    CPPUNIT_ASSERT_EQUAL(6 * second, small.GetTime(1));
+}
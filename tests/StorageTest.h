@@ -0,0 +1,34 @@
+#ifndef STORAGETEST_H_
+#define STORAGETEST_H_
+
+#include "BaseTest.h"
+
+class StorageTest :
+    public BaseTest
+{
+    public: 
+        CPPUNIT_SUITE_BEGIN(StorageTest)
+            CPPUNIT_TEST(StorageTest, testMemoryStorage)
+            CPPUNIT_TEST(StorageTest, testFileStorage)
+            CPPUNIT_TEST(StorageTest, testCheckpoints)
+            CPPUNIT_TEST(StorageTest, testAsyncStore)
+            CPPUNIT_TEST(StorageTest, testAsyncStoreBackToBack)
+            CPPUNIT_TEST(StorageTest, testCompression)
+            CPPUNIT_TEST(StorageTest, testSegmentedStore)
+            CPPUNIT_TEST(StorageTest, testCheckpointRing)
+        CPPUNIT_SUITE_END()
+
+        void setUp(void);
+        void tearDown(void);
+
+        void testMemoryStorage(void);
+        void testFileStorage(void);
+        void testCheckpoints(void);
+        void testAsyncStore(void);
+        void testAsyncStoreBackToBack(void);
+        void testCompression(void);
+        void testSegmentedStore(void);
+        void testCheckpointRing(void);
+};
+
+#endif // STORAGETEST_H_
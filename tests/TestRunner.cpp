@@ -12,6 +12,12 @@
 #include "CompositeTest.h"
 #include "ManagedContainerTest.h"
 #include "ManagedReferenceTest.h"
+#include "NameIndexTest.h"
+#include "ArenaTest.h"
+#include "BatchContainerTest.h"
+#include "ResolverTest.h"
+#include "StorageTest.h"
+#include "PublicationTest.h"
 
 int main(int argc, char* argv[])
 {
@@ -29,6 +35,12 @@ int main(int argc, char* argv[])
     runner.addTest(CompositeTest::suite());
     runner.addTest(ManagedContainerTest::suite());
     runner.addTest(ManagedReferenceTest::suite());
+    runner.addTest(NameIndexTest::suite());
+    runner.addTest(ArenaTest::suite());
+    runner.addTest(BatchContainerTest::suite());
+    runner.addTest(ResolverTest::suite());
+    runner.addTest(StorageTest::suite());
+    runner.addTest(PublicationTest::suite());
     bool testResult = runner.run();
 
     return testResult ? 0 : 1;